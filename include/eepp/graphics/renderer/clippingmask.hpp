@@ -52,6 +52,13 @@ class EE_API ClippingMask {
 
 	void setPlanesClipped( const std::list<Rectf>& planesClipped );
 
+	/** @return True if the scissor clipping is enabled, rect is set to the current clipping area.
+	 */
+	bool getScissorClip( Rectf& rect ) const;
+
+	/** @return True if the plane clipping is enabled, rect is set to the current clipping area. */
+	bool getPlaneClip( Rectf& rect ) const;
+
   protected:
 	std::list<Rectf> mScissorsClipped;
 	std::list<Rectf> mPlanesClipped;
@@ -63,7 +63,8 @@ enum NodeFlags {
 
 	NODE_FLAG_LOADING = ( 1 << 27 ),
 	NODE_FLAG_CLOSING_CHILDREN = ( 1 << 28 ),
-	NODE_FLAG_FREE_USE = ( 1 << 29 )
+	NODE_FLAG_FREE_USE = ( 1 << 29 ),
+	NODE_FLAG_DRAW_BOUNDS_UPDATED = ( 1 << 30 )
 };
 
 class EE_API Node : public Transformable {
@@ -268,6 +269,10 @@ class EE_API Node : public Transformable {
 
 	void invalidateDraw();
 
+	/** Invalidates an area of the node ( in screen coordinates ), for changes that don't affect
+	 * the rest of it. Scenes that don't redraw damaged regions redraw the whole node. */
+	void invalidateDraw( const Rectf& area );
+
 	void setRotation( float angle );
 
 	void setRotation( const Float& angle, const OriginPoint& center );
@@ -378,6 +383,9 @@ class EE_API Node : public Transformable {
 
 	virtual void invalidate( Node* invalidator );
 
+	/** Invalidates only an area of the invalidator, by default the whole invalidator. */
+	virtual void invalidateArea( Node* invalidator, const Rectf& area );
+
 	Uint32 getChildCount() const;
 
 	Uint32 getChildOfTypeCount( const Uint32& type ) const;
@@ -429,6 +437,7 @@ class EE_API Node : public Transformable {
   protected:
 	typedef std::map<Uint32, std::map<Uint32, EventCallback>> EventsMap;
 	friend class EventDispatcher;
+	friend class SceneNode;
 
 	std::string mId;
 	String::HashType mIdHash;
@@ -449,6 +458,8 @@ class EE_API Node : public Transformable {
 
 	mutable Polygon2f mPoly;
 	mutable Rectf mWorldBounds;
+	/** Screen area where the node was drawn the last time, used to compute the damaged regions. */
+	Rectf mDrawBounds;
 	Vector2f mCenter;
 
 	EventsMap mEvents;
@@ -508,6 +519,13 @@ class EE_API Node : public Transformable {
 
 	virtual void drawChilds();
 
+	/** @return True if the children can be culled against the current clipping area, set in clip.
+	 */
+	bool getChildsDrawClip( Rectf& clip ) const;
+
+	/** @return True if the node and its children are drawn entirely outside of the clip area. */
+	bool isDrawCulled( const Rectf& clip );
+
 	virtual void onChildCountChange( Node* child, const bool& removed );
 
 	virtual void onAngleChange();
@@ -544,6 +562,12 @@ class EE_API Node : public Transformable {
 
 	Rectf getScreenBounds();
 
+	virtual void updateDrawBounds();
+
+	/** Updates the draw bounds before drawing the node, unless isDrawCulled already updated them
+	 * in this draw. */
+	void updateDrawBoundsForDraw();
+
 	void setInternalPosition( const Vector2f& Pos );
 
 	void setInternalWidth( const Float& width );
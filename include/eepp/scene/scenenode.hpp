@@ -83,6 +83,19 @@ class EE_API SceneNode : public Node {
 
 	bool usesInvalidation();
 
+	/** Enables the redraw of only the damaged regions of the scene.
+	 * Requires the frame buffer and the draw invalidation enabled. The frame buffer keeps the last
+	 * frame, and when the scene is invalidated only the area covered by the nodes that invalidated
+	 * it ( plus the area they covered the last time they were drawn ) is cleared and redrawn. */
+	void enableDrawDamageRegions();
+
+	void disableDrawDamageRegions();
+
+	bool usesDrawDamageRegions() const;
+
+	/** @return The area redrawn in the last frame, empty if the whole scene was redrawn. */
+	const Rectf& getDrawDamageRegion() const;
+
 	void setUseGlobalCursors( const bool& use );
 
 	const bool& getUseGlobalCursors();
@@ -91,6 +104,10 @@ class EE_API SceneNode : public Node {
 
 	virtual bool isDrawInvalidator() const;
 
+	virtual void invalidate( Node* invalidator );
+
+	virtual void invalidateArea( Node* invalidator, const Rectf& area );
+
 	ActionManager* getActionManager() const;
 
 	void subscribeScheduledUpdate( Node* node );
@@ -136,6 +153,16 @@ class EE_API SceneNode : public Node {
 	std::unordered_set<Node*> mScheduledUpdateRemove;
 	std::unordered_set<Node*> mMouseOverNodes;
 	Float mDPI;
+	bool mUseDrawDamageRegions{ false };
+	/** The next frame must be fully redrawn. */
+	bool mDrawDamageFull{ true };
+	/** Nodes that invalidated the scene since the last frame. */
+	std::unordered_set<Node*> mDamagedNodes;
+	/** Area of the nodes removed from the scene and the areas invalidated since the last frame. */
+	Rectf mDamagedArea;
+	/** Area being redrawn, empty if the whole scene is redrawn. */
+	Rectf mDrawDamageRegion;
+	bool mDrawDamagePartial{ false };
 
 	virtual void onSizeChange();
 
@@ -164,6 +191,21 @@ class EE_API SceneNode : public Node {
 	void drawFrameBuffer();
 
 	Sizei getFrameBufferSize();
+
+	/** Damages the area where the node ( and optionally its children ) was drawn the last time,
+	 * called when the node is removed from the scene or moved to another parent. */
+	void invalidateNodeArea( Node* node, bool recursive );
+
+	void updateDrawDamageRegion();
+
+	/** Adds the area the node and its children covered in the last frame and will cover in the
+	 * next one. @return False if the area can't be computed ( a node is rotated or scaled ). */
+	bool addDrawDamage( Node* node, Rectf& region );
+
+	/** Collects the nodes that are drawn without the clipping of its parents. */
+	void findUnclippedNodes( Node* node, std::vector<Node*>& nodes );
+
+	void clearDrawDamageRegion();
 };
 
 }} // namespace EE::Scene
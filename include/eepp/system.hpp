@@ -15,6 +15,7 @@
 #include <eepp/system/iostreamdeflate.hpp>
 #include <eepp/system/iostreamfile.hpp>
 #include <eepp/system/iostreaminflate.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
 #include <eepp/system/iostreampak.hpp>
 #include <eepp/system/iostreamstring.hpp>
 #include <eepp/system/iostreamzip.hpp>
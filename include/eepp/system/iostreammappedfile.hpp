@@ -0,0 +1,57 @@
+#ifndef EE_SYSTEMCIOSTREAMMAPPEDFILE_HPP
+#define EE_SYSTEMCIOSTREAMMAPPEDFILE_HPP
+
+#include <eepp/system/iostream.hpp>
+#include <eepp/system/scopedbuffer.hpp>
+#include <string>
+
+namespace EE { namespace System {
+
+/** @brief A read-only file stream backed by a memory mapping of the file.
+** The whole file content is accessible through getData() without copying it into memory. If the
+** platform does not support memory mapped files, the file is read into memory instead. */
+class EE_API IOStreamMappedFile : public IOStream {
+  public:
+	static IOStreamMappedFile* New( const std::string& path );
+
+	/** @brief Maps a file from the file system
+	**	@param path File to map from path
+	**/
+	IOStreamMappedFile( const std::string& path );
+
+	virtual ~IOStreamMappedFile();
+
+	ios_size read( char* data, ios_size size );
+
+	/** The stream is read-only, always returns 0. */
+	ios_size write( const char* data, ios_size size );
+
+	ios_size seek( ios_size position );
+
+	ios_size tell();
+
+	ios_size getSize();
+
+	bool isOpen();
+
+	void close();
+
+	/** @return The mapped file content, nullptr if the file is not open or is empty. */
+	const char* getData() const;
+
+  protected:
+	const char* mData;
+	ios_size mSize;
+	ios_size mPos;
+	bool mOpen;
+	bool mMapped;
+	ScopedBuffer mBuffer;
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	void* mFileHandle;
+	void* mMappingHandle;
+#endif
+};
+
+}} // namespace EE::System
+
+#endif
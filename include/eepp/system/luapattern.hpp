@@ -108,6 +108,17 @@ class EE_API LuaPattern {
 	bool matches( const char* stringSearch, int stringStartOffset, LuaPattern::Range* matchList,
 				  size_t stringLength ) const;
 
+	/** Same as matches but the matches count is returned instead of being stored in the pattern,
+	 * so the same pattern can be used from different threads at the same time.
+	 * @return The number of matches, 0 if the string does not match the pattern. */
+	size_t getMatches( const char* stringSearch, int stringStartOffset,
+					   LuaPattern::Range* matchList, size_t stringLength ) const;
+
+	/** Same as getMatches but every position is run through the matcher, without the first
+	 * characters prefilter. Used to verify the prefilter. */
+	size_t getMatchesUnfiltered( const char* stringSearch, int stringStartOffset,
+								 LuaPattern::Range* matchList, size_t stringLength ) const;
+
 	bool matches( const std::string& str, LuaPattern::Range* matchList = nullptr,
 				  int stringStartOffset = 0 ) const;
 
@@ -140,6 +151,10 @@ class EE_API LuaPattern {
 	mutable std::string mErr;
 	std::string mPattern;
 	mutable size_t mMatchNum;
+	/** Set of characters that can start a match, used to skip positions without running the
+	 * matcher. Only valid if mHasFirstChars is true. */
+	Uint8 mFirstChars[32]{};
+	bool mHasFirstChars{ false };
 };
 
 }} // namespace EE::System
@@ -14,8 +14,52 @@
 
 namespace EE { namespace System {
 
+/** @brief Work-stealing thread pool.
+ * Every worker owns a queue per priority. Tasks queued from a worker thread go to its own queue,
+ * tasks queued from any other thread are distributed between the workers. A worker without work
+ * steals from the other workers queues, always running the interactive tasks first. */
 class EE_API ThreadPool : NonCopyable {
   public:
+	enum class Priority : Uint8 {
+		Interactive, //!< Tasks that the user is waiting for. Run before any background task.
+		Background	 //!< Long running tasks that can be delayed (indexing, scans, etc).
+	};
+
+	/** @brief Counts the pending tasks of a group and allows to wait until all of them are done.
+	 */
+	class EE_API WaitGroup : NonCopyable {
+	  public:
+		WaitGroup();
+
+		void add( Uint64 count = 1 );
+
+		void done();
+
+		bool isDone() const;
+
+		/** Blocks until every task of the group is done. From a pool thread use
+		 * ThreadPool::wait instead, it runs the queued tasks of the group while waiting. */
+		void wait();
+
+	  protected:
+		friend class ThreadPool;
+
+		/** Shared with the pool tasks that run the group tasks, they can outlive the group. */
+		struct State {
+			std::mutex mutex;
+			std::condition_variable condition;
+			Uint64 count{ 0 };
+			/** Tasks of the group that didn't start yet. */
+			std::deque<std::function<void()>> tasks;
+		};
+
+		std::shared_ptr<State> mState;
+
+		/** Runs the next task of the group that didn't start yet.
+		 * @return False if every task already started. */
+		static bool runTask( State& state );
+	};
+
 	static std::shared_ptr<ThreadPool> createShared( Uint32 numThreads,
 													 bool terminateOnClose = false );
 
@@ -33,6 +77,28 @@ class EE_API ThreadPool : NonCopyable {
 		const std::function<void( const Uint64& )>& doneCallback = []( const Uint64& ) {},
 		const Uint64& tag = 0 );
 
+	Uint64 run(
+		const std::function<void()>& func, Priority priority,
+		const std::function<void( const Uint64& )>& doneCallback = []( const Uint64& ) {},
+		const Uint64& tag = 0 );
+
+	/** Runs the task as part of the wait group. The task must not be removed from the queue,
+	 * otherwise the group will never be done. */
+	Uint64 run( const std::function<void()>& func, WaitGroup& waitGroup,
+				Priority priority = Priority::Interactive );
+
+	/** Waits until every task of the group is done, running the queued tasks of the group
+	 * meanwhile. Unrelated tasks are never run while waiting, so it's safe to call it from a pool
+	 * thread or while holding a lock. */
+	void wait( WaitGroup& waitGroup );
+
+	/** Calls func( chunkBegin, chunkEnd ) for chunks of at least grainSize indexes until the range
+	 * [begin, end) is covered. The calling thread also processes chunks, it returns once the whole
+	 * range has been processed. */
+	void parallelFor( Int64 begin, Int64 end,
+					  const std::function<void( Int64 chunkBegin, Int64 chunkEnd )>& func,
+					  Int64 grainSize = 1, Priority priority = Priority::Interactive );
+
 	Uint32 numThreads() const;
 
 	bool terminateOnClose() const;
@@ -48,19 +114,35 @@ class EE_API ThreadPool : NonCopyable {
 	bool removeWithTag( const Uint64& tag );
 
   private:
+	static constexpr size_t PriorityCount = 2;
+
 	struct Work {
 		Uint64 id{ 0 };
-		const std::function<void()> func;
-		const std::function<void( const Uint64& )> callback;
+		std::function<void()> func;
+		std::function<void( const Uint64& )> callback;
 		Uint64 tag{ 0 };
 	};
 
-	void threadFunc();
+	/** Works are stored by value, the deque allocates them in blocks instead of once per task. */
+	struct Worker {
+		std::mutex mutex;
+		std::deque<Work> queues[PriorityCount];
+	};
+
+	void threadFunc( size_t index );
+
+	/** Pops a work from the worker queue or steals it from another worker. */
+	bool popWork( size_t index, Work& work );
+
+	void runWork( Work& work );
 
 	std::vector<std::unique_ptr<Thread>> mThreads;
-	std::deque<std::unique_ptr<Work>> mWork;
-	std::atomic<Uint64> mLastWorkId;
-	bool mShuttingDown = false;
+	std::vector<std::unique_ptr<Worker>> mWorkers;
+	std::atomic<Uint64> mLastWorkId{ 0 };
+	std::atomic<size_t> mPendingWork{ 0 };
+	std::atomic<size_t> mSleepingThreads{ 0 };
+	std::atomic<size_t> mNextWorker{ 0 };
+	std::atomic<bool> mShuttingDown{ false };
 	bool mTerminateOnClose = false;
 	mutable std::mutex mMutex;
 	std::condition_variable mWorkAvailable;
@@ -4,6 +4,7 @@
 #include <eepp/ui/css/elementdefinition.hpp>
 #include <eepp/ui/css/keyframesdefinition.hpp>
 #include <eepp/ui/css/mediaquery.hpp>
+#include <eepp/ui/css/stylesheetselectorfilter.hpp>
 #include <eepp/ui/css/stylesheetstyle.hpp>
 #include <memory>
 #include <unordered_map>
@@ -47,6 +48,8 @@ class EE_API StyleSheet {
 
 	static size_t nodeHash( const std::string& tag, const std::string& id );
 
+	static size_t classNodeHash( const std::string& cls );
+
 	void invalidateCache();
 
 	const Uint32& getMarker() const;
@@ -62,18 +65,48 @@ class EE_API StyleSheet {
 
 	bool refreshCacheFromStyles( const std::vector<std::shared_ptr<StyleSheetStyle>>& styles );
 
+	/** The filter of the ancestors of the widgets being restyled, used to reject the selectors
+	 * that need an ancestor that doesn't exist. */
+	StyleSheetSelectorFilter& getSelectorFilter() const;
+
   protected:
 	Uint32 mMarker{ 0 };
 	std::vector<std::shared_ptr<StyleSheetStyle>> mNodes;
 	std::unordered_map<size_t, StyleSheetStyleVector> mNodeIndex;
+	/** Position of every indexed style, styles with the same specificity are applied in this
+	 * order. */
+	std::unordered_map<const StyleSheetStyle*, Uint32> mNodeOrder;
+	Uint32 mNextNodeOrder{ 0 };
 	MediaQueryList::vector mMediaQueryList;
 	KeyframesDefinitionMap mKeyframesMap;
 	using ElementDefinitionCache = std::unordered_map<size_t, std::shared_ptr<ElementDefinition>>;
 	mutable ElementDefinitionCache mNodeCache;
+	mutable StyleSheetSelectorFilter mSelectorFilter;
+
+	/** Definition of a recently styled widget, reused by its siblings that have the same tag, id,
+	 * classes and state while a widget tree is being restyled. */
+	struct SharedStyle {
+		Uint32 generation{ 0 };
+		UIWidget* parent{ nullptr };
+		bool applyPseudo{ false };
+		std::string tag;
+		std::string id;
+		std::vector<std::string> classes;
+		std::vector<std::string> pseudoClasses;
+		/** Match result of every sibling dependent style evaluated. */
+		std::vector<bool> siblingDependentResults;
+		std::shared_ptr<ElementDefinition> definition;
+	};
+	static constexpr size_t StyleSharingCacheSize = 8;
+	mutable std::vector<SharedStyle> mStyleSharingCache;
+	mutable size_t mStyleSharingCacheNext{ 0 };
 
 	void addMediaQueryList( MediaQueryList::ptr list );
 
 	bool addStyleToNodeIndex( StyleSheetStyle* style );
+
+	bool isSharedStyleCandidate( const SharedStyle& shared, UIWidget* element,
+								 const bool& applyPseudo ) const;
 };
 
 }}} // namespace EE::UI::CSS
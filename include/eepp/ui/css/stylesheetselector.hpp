@@ -30,18 +30,32 @@ class EE_API StyleSheetSelector {
 
 	const bool& isStructurallyVolatile() const;
 
+	/** @return True if the selector can match an element and not its sibling, even if both have
+	 * the same tag, id, classes and state ( it has sibling combinators or structural pseudo classes
+	 * ). */
+	const bool& isSiblingDependent() const;
+
 	const StyleSheetSelectorRule& getRule( const Uint32& index );
 
 	const std::string& getSelectorId() const;
 
 	const std::string& getSelectorTagName() const;
 
+	/** @return The first class of the selector rightmost rule, empty if it doesn't have any. */
+	const std::string& getSelectorFirstClass() const;
+
+	/** @return The identifier hashes that the ancestors of an element must have for the selector
+	 * to match. Used to reject the selector with a StyleSheetSelectorFilter. */
+	const std::vector<Uint32>& getAncestorHashes() const;
+
   protected:
 	std::string mName;
 	Uint32 mSpecificity;
 	std::vector<StyleSheetSelectorRule> mSelectorRules;
 	bool mCacheable;
 	bool mStructurallyVolatile;
+	std::vector<Uint32> mAncestorHashes;
+	bool mSiblingDependent{ false };
 
 	void addSelectorRule( std::string& buffer,
 						  StyleSheetSelectorRule::PatternMatch& curPatternMatch,
@@ -0,0 +1,79 @@
+#ifndef EE_UI_CSS_STYLESHEETSELECTORFILTER_HPP
+#define EE_UI_CSS_STYLESHEETSELECTORFILTER_HPP
+
+#include <array>
+#include <eepp/config.hpp>
+#include <string>
+#include <vector>
+
+namespace EE { namespace UI {
+class UIWidget;
+}} // namespace EE::UI
+
+namespace EE { namespace UI { namespace CSS {
+
+/** @brief Counting Bloom filter of the tag, id and classes of the ancestors of the element being
+ * styled.
+ * While a widget tree is being restyled every widget pushes its identifiers before its children
+ * are styled and pops them after. A selector that needs an ancestor with an identifier that is not
+ * in the filter can't match, so it's rejected without walking the parent chain. The filter can
+ * give false positives but never false negatives. */
+class EE_API StyleSheetSelectorFilter {
+  public:
+	static constexpr Uint32 KeyBits = 12;
+
+	static Uint32 tagHash( const std::string& tag );
+
+	static Uint32 idHash( const std::string& id );
+
+	static Uint32 classHash( const std::string& cls );
+
+	/** Pushes the whole chain of style sheet parents from the root to the parent. */
+	void setupParentStack( UIWidget* parent );
+
+	void pushParent( UIWidget* parent );
+
+	void popParent();
+
+	void clear();
+
+	bool isEmpty() const;
+
+	/** @return The last pushed parent. */
+	UIWidget* getParent() const;
+
+	/** @return A number that changes every time the filter is set up or cleared, identifies a
+	 * restyle of a widget tree. */
+	const Uint32& getGeneration() const;
+
+	/** @return True if the filter contains exactly the ancestors of the element. */
+	bool isValidFor( UIWidget* element ) const;
+
+	/** @return True if any of the identifier hashes of the selector ancestors is not in the
+	 * filter, so the selector can't match. */
+	bool fastRejectSelector( const std::vector<Uint32>& ancestorHashes ) const;
+
+  protected:
+	static constexpr Uint32 KeyMask = ( 1 << KeyBits ) - 1;
+	static constexpr Uint8 MaxCount = 0xFF;
+
+	struct ParentStackFrame {
+		UIWidget* parent;
+		size_t hashesCount;
+	};
+
+	std::vector<ParentStackFrame> mParentStack;
+	std::vector<Uint32> mHashes;
+	std::array<Uint8, 1 << KeyBits> mCounters{};
+	Uint32 mGeneration{ 0 };
+
+	void add( const Uint32& hash );
+
+	void remove( const Uint32& hash );
+
+	bool mayContain( const Uint32& hash ) const;
+};
+
+}}} // namespace EE::UI::CSS
+
+#endif
@@ -63,6 +63,8 @@ class EE_API StyleSheetSelectorRule {
 
 	bool hasClass( const std::string& cls ) const;
 
+	const std::vector<std::string>& getClasses() const;
+
 	bool hasPseudoClasses() const;
 
 	bool hasPseudoClass( const std::string& cls ) const;
@@ -0,0 +1,106 @@
+#ifndef EE_UI_DOC_CHUNKINDEX_HPP
+#define EE_UI_DOC_CHUNKINDEX_HPP
+
+#include <array>
+#include <cstddef>
+#include <eepp/config.hpp>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** @brief Fenwick tree of the sizes of a list of chunks.
+ * Used by the chunked line containers to find the chunk that contains an element, and to count the
+ * elements before a chunk, in O(log n). Every chunk can be measured in several dimensions ( for
+ * example lines and visual rows ), and each dimension can be searched independently. */
+template <size_t Dimensions = 1> class ChunkIndex {
+  public:
+	typedef std::array<size_t, Dimensions> Sizes;
+
+	ChunkIndex() : mTree( 1 ) {}
+
+	void clear() {
+		mTree.assign( 1, Sizes() );
+		mStep = 0;
+	}
+
+	size_t chunksCount() const { return mTree.size() - 1; }
+
+	/** Appends a chunk to the end of the list. */
+	void append( const Sizes& sizes = Sizes() ) {
+		// Appending a node to a Fenwick tree: its value is the sum of the nodes it covers.
+		size_t i = mTree.size();
+		Sizes value( sizes );
+		for ( size_t j = i - 1; j > i - lowBit( i ); j -= lowBit( j ) ) {
+			for ( size_t d = 0; d < Dimensions; d++ )
+				value[d] += mTree[j][d];
+		}
+		mTree.push_back( value );
+		updateStep();
+	}
+
+	/** Adds delta to the size of the chunk in the dimension. */
+	void update( const size_t& chunk, const Int64& delta, const size_t& dimension = 0 ) {
+		for ( size_t i = chunk + 1; i < mTree.size(); i += lowBit( i ) )
+			mTree[i][dimension] += static_cast<size_t>( delta );
+	}
+
+	/** Rebuilds the tree for count chunks, sizesOf( chunk ) must return the Sizes of every chunk.
+	 */
+	template <typename SizesOf> void rebuild( const size_t& count, SizesOf sizesOf ) {
+		mTree.assign( count + 1, Sizes() );
+		for ( size_t i = 1; i <= count; i++ ) {
+			Sizes sizes( sizesOf( i - 1 ) );
+			for ( size_t d = 0; d < Dimensions; d++ )
+				mTree[i][d] += sizes[d];
+			size_t parent = i + lowBit( i );
+			if ( parent <= count ) {
+				for ( size_t d = 0; d < Dimensions; d++ )
+					mTree[parent][d] += mTree[i][d];
+			}
+		}
+		updateStep();
+	}
+
+	/** @return The chunk that contains the element index of the dimension, index is converted to
+	 * the local index in the chunk. */
+	size_t find( size_t& index, const size_t& dimension = 0 ) const {
+		size_t pos = 0;
+		for ( size_t step = mStep; step; step >>= 1 ) {
+			if ( pos + step < mTree.size() && mTree[pos + step][dimension] <= index ) {
+				pos += step;
+				index -= mTree[pos][dimension];
+			}
+		}
+		return pos;
+	}
+
+	/** @return The sum of the sizes of the dimension of the chunks before chunk. */
+	size_t sizeBefore( const size_t& chunk, const size_t& dimension = 0 ) const {
+		size_t size = 0;
+		for ( size_t i = chunk; i > 0; i -= lowBit( i ) )
+			size += mTree[i][dimension];
+		return size;
+	}
+
+  protected:
+	/** Chunk sizes ( 1-based ). */
+	std::vector<Sizes> mTree;
+	/** Highest power of two lower or equal than the chunks count, used to walk the tree. */
+	size_t mStep{ 0 };
+
+	static size_t lowBit( const size_t& i ) { return i & ( ~i + 1 ); }
+
+	void updateStep() {
+		size_t count = chunksCount();
+		mStep = 0;
+		if ( count ) {
+			mStep = 1;
+			while ( ( mStep << 1 ) <= count )
+				mStep <<= 1;
+		}
+	}
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif // EE_UI_DOC_CHUNKINDEX_HPP
@@ -4,6 +4,7 @@
 #include <eepp/system/color.hpp>
 #include <eepp/system/iostream.hpp>
 #include <eepp/system/pack.hpp>
+#include <eepp/ui/doc/syntaxstyle.hpp>
 #include <unordered_map>
 #include <vector>
 
@@ -57,8 +58,12 @@ class EE_API SyntaxColorScheme {
 
 	const Style& getSyntaxStyle( const std::string& type ) const;
 
+	const Style& getSyntaxStyle( const SyntaxStyleType& type ) const;
+
 	bool hasSyntaxStyle( const std::string& type ) const;
 
+	bool hasSyntaxStyle( const SyntaxStyleType& type ) const;
+
 	void setSyntaxStyles( const std::unordered_map<std::string, Style>& styles );
 
 	void setSyntaxStyle( const std::string& type, const Style& style );
@@ -80,6 +85,7 @@ class EE_API SyntaxColorScheme {
 	std::unordered_map<std::string, Style> mSyntaxColors;
 	std::unordered_map<std::string, Style> mEditorColors;
 	mutable std::unordered_map<std::string, Style> mStyleCache;
+	mutable std::unordered_map<SyntaxStyleType, Style> mStyleTypeCache;
 };
 
 }}} // namespace EE::UI::Doc
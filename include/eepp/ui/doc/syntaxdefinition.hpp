@@ -3,6 +3,8 @@
 
 #include <eepp/config.hpp>
 #include <eepp/core/string.hpp>
+#include <eepp/system/luapattern.hpp>
+#include <eepp/ui/doc/syntaxstyle.hpp>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -11,16 +13,33 @@ namespace EE { namespace UI { namespace Doc {
 
 struct EE_API SyntaxPattern {
 	std::vector<std::string> patterns;
-	std::vector<std::string> types;
+	std::vector<SyntaxStyleType> types;
+	std::vector<std::string> typesNames;
 	std::string syntax{ "" };
+	/** Patterns compiled once for the tokenizer: the anchored start pattern and, if the pattern
+	 * has an end, the end pattern and the anchored end pattern. */
+	std::vector<System::LuaPattern> matchers;
 
 	SyntaxPattern( std::vector<std::string> _patterns, std::string _type,
 				   std::string _syntax = "" ) :
-		patterns( _patterns ), types( { _type } ), syntax( _syntax ) {}
+		patterns( _patterns ),
+		types( { SyntaxStyleTypes::fromString( _type ) } ),
+		typesNames( { _type } ),
+		syntax( _syntax ) {
+		compile();
+	}
 
 	SyntaxPattern( std::vector<std::string> _patterns, std::vector<std::string> _types,
 				   std::string _syntax = "" ) :
-		patterns( _patterns ), types( _types ), syntax( _syntax ) {}
+		patterns( _patterns ), typesNames( _types ), syntax( _syntax ) {
+		types.reserve( typesNames.size() );
+		for ( const auto& type : typesNames )
+			types.push_back( SyntaxStyleTypes::fromString( type ) );
+		compile();
+	}
+
+  protected:
+	void compile();
 };
 
 class EE_API SyntaxDefinition {
@@ -46,9 +65,10 @@ class EE_API SyntaxDefinition {
 
 	const std::string& getComment() const;
 
-	const std::unordered_map<std::string, std::string>& getSymbols() const;
+	const std::unordered_map<std::string, SyntaxStyleType>& getSymbols() const;
 
-	std::string getSymbol( const std::string& symbol ) const;
+	/** @return The symbol style type, SyntaxStyleTypes::None if the symbol is not defined. */
+	SyntaxStyleType getSymbol( const std::string& symbol ) const;
 
 	/** Accepts lua patterns and file extensions. */
 	SyntaxDefinition& addFileType( const std::string& fileType );
@@ -73,6 +93,10 @@ class EE_API SyntaxDefinition {
 
 	void clearSymbols();
 
+	/** @return An id of the current patterns and symbols of the definition. It changes every time
+	 * they are modified, and copies of the definition share it until they are modified. */
+	const Uint64& getGeneration() const;
+
 	const std::string& getLSPName() const;
 
 	SyntaxDefinition& setVisible( bool visible );
@@ -94,12 +118,13 @@ class EE_API SyntaxDefinition {
 	String::HashType mLanguageId;
 	std::vector<std::string> mFiles;
 	std::vector<SyntaxPattern> mPatterns;
-	std::unordered_map<std::string, std::string> mSymbols;
+	std::unordered_map<std::string, SyntaxStyleType> mSymbols;
 	std::string mComment;
 	std::vector<std::string> mHeaders;
 	std::string mLSPName;
 	bool mAutoCloseXMLTags{ false };
 	bool mVisible{ true };
+	Uint64 mGeneration{ 0 };
 };
 
 }}} // namespace EE::UI::Doc
@@ -3,10 +3,13 @@
 
 #include <eepp/config.hpp>
 #include <eepp/system/iostream.hpp>
+#include <eepp/system/luapattern.hpp>
+#include <eepp/system/mutex.hpp>
 #include <eepp/system/pack.hpp>
 #include <eepp/system/singleton.hpp>
 #include <eepp/ui/doc/syntaxdefinition.hpp>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 using namespace EE::System;
@@ -64,11 +67,47 @@ class EE_API SyntaxDefinitionManager {
 	bool save( const std::string& path, const std::vector<SyntaxDefinition>& def = {} );
 
   protected:
+	/** A file type or header pattern that can't be resolved with a hash lookup. */
+	struct PatternEntry {
+		size_t priority;
+		size_t index;
+		LuaPattern pattern;
+	};
+
+	/** Definition index with its priority, lower priorities win. Definitions added later have
+	 * more priority, and inside a definition the first file types have more priority. */
+	typedef std::pair<size_t, size_t> IndexEntry;
+
 	SyntaxDefinitionManager();
 
 	std::vector<SyntaxDefinition> mDefinitions;
+	mutable Mutex mIndexMutex;
+	mutable bool mIndexDirty{ true };
+	mutable std::unordered_map<std::string, size_t> mLanguageNameIndex;
+	mutable std::unordered_map<std::string, size_t> mLSPNameIndex;
+	mutable std::unordered_map<String::HashType, size_t> mLanguageIdIndex;
+	/** File types that are a plain extension or file name. */
+	mutable std::unordered_map<std::string, IndexEntry> mExtensionIndex;
+	/** File type patterns that only match a literal suffix starting with a dot ( "%.ext$" ). */
+	mutable std::unordered_map<std::string, IndexEntry> mSuffixIndex;
+	/** File type patterns that only match a literal file name ( "^name$" ). */
+	mutable std::unordered_map<std::string, IndexEntry> mFileNameIndex;
+	mutable std::vector<PatternEntry> mFilePatterns;
+	/** Header patterns anchored to a literal first character, bucketed by that character. */
+	mutable std::unordered_map<char, std::vector<PatternEntry>> mHeaderPatternsByChar;
+	mutable std::vector<PatternEntry> mHeaderPatterns;
+	/** Definition found for each file name already classified. */
+	mutable std::unordered_map<std::string, size_t> mFileNameCache;
 
 	std::optional<size_t> getLanguageIndex( const std::string& langName );
+
+	void invalidateIndex();
+
+	void buildIndex() const;
+
+	size_t findIndexByFileName( const std::string& filePath ) const;
+
+	size_t findIndexByHeader( const std::string& header ) const;
 };
 
 }}} // namespace EE::UI::Doc
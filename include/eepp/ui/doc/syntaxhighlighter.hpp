@@ -1,8 +1,11 @@
 #ifndef EE_UI_DOC_SYNTAXHIGHLIGHTER_HPP
 #define EE_UI_DOC_SYNTAXHIGHLIGHTER_HPP
 
+#include <atomic>
+#include <eepp/system/threadpool.hpp>
 #include <eepp/ui/doc/syntaxtokenizer.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
+#include <memory>
 #include <unordered_map>
 
 namespace EE { namespace UI { namespace Doc {
@@ -12,12 +15,19 @@ struct TokenizedLine {
 	String::HashType hash;
 	std::vector<SyntaxTokenPosition> tokens;
 	Uint64 state{ SYNTAX_TOKENIZER_STATE_NONE };
+	/** Unique id of the tokenization, a new one is assigned every time the line tokens change. */
+	Uint64 signature{ 0 };
 };
 
 class EE_API SyntaxHighlighter {
   public:
+	/** Maximum number of lines tokenized by a single background job. */
+	static constexpr Int64 BackgroundBatchSize = 1024;
+
 	explicit SyntaxHighlighter( TextDocument* doc );
 
+	~SyntaxHighlighter();
+
 	void changeDoc( TextDocument* doc );
 
 	void reset();
@@ -26,6 +36,11 @@ class EE_API SyntaxHighlighter {
 
 	const std::vector<SyntaxTokenPosition>& getLine( const size_t& index );
 
+	/** @return The signature of the current tokens of the line, or 0 if the line is not tokenized
+	 * or its tokens are outdated. Used to know if anything derived from the tokens is still valid.
+	 */
+	Uint64 getLineSignature( const size_t& index );
+
 	Int64 getFirstInvalidLine() const;
 
 	Int64 getMaxWantedLine() const;
@@ -34,7 +49,7 @@ class EE_API SyntaxHighlighter {
 
 	const SyntaxDefinition& getSyntaxDefinitionFromTextPosition( const TextPosition& position );
 
-	std::string getTokenTypeAt( const TextPosition& pos );
+	SyntaxStyleType getTokenTypeAt( const TextPosition& pos );
 
 	SyntaxTokenPosition getTokenPositionAt( const TextPosition& pos );
 
@@ -47,13 +62,44 @@ class EE_API SyntaxHighlighter {
 
 	Mutex& getLinesMutex();
 
+	/** Enables the background tokenization. When a thread pool is set updateDirty never tokenizes
+	 * in the caller thread, it publishes the lines tokenized by the last background job and
+	 * schedules the next one. */
+	void setThreadPool( const std::shared_ptr<ThreadPool>& pool );
+
+	const std::shared_ptr<ThreadPool>& getThreadPool() const;
+
+	/** Number of lines past the last wanted line that will be tokenized ahead in background. */
+	void setSpeculativeLinesCount( const Int64& count );
+
+	const Int64& getSpeculativeLinesCount() const;
+
+	bool isTokenizingInBackground() const;
+
   protected:
+	struct BackgroundJob;
+
 	TextDocument* mDoc;
 	std::unordered_map<size_t, TokenizedLine> mLines;
 	std::unordered_map<size_t, TokenizedLine> mTokenizerLines;
 	Mutex mLinesMutex;
 	Int64 mFirstInvalidLine;
 	Int64 mMaxWantedLine;
+	Int64 mLastInvalidLine{ -1 };
+	Int64 mFrontierLine{ -1 };
+	Int64 mSpeculativeLinesCount{ 4096 };
+	std::shared_ptr<ThreadPool> mThreadPool;
+	std::shared_ptr<BackgroundJob> mBackgroundJob;
+	std::shared_ptr<const SyntaxDefinition> mBackgroundSyntax;
+	std::atomic<Uint64> mSignatureCounter{ 0 };
+
+	bool updateDirtyInBackground( int visibleLinesCount );
+
+	bool publishBackgroundJob();
+
+	void scheduleBackgroundJob( const Int64& toLine );
+
+	void cancelBackgroundJob();
 };
 
 }}} // namespace EE::UI::Doc
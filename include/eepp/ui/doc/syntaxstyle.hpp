@@ -0,0 +1,39 @@
+#ifndef EE_UI_DOC_SYNTAXSTYLE_HPP
+#define EE_UI_DOC_SYNTAXSTYLE_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/string.hpp>
+#include <string>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** Interned syntax style type. The id is the hash of the style type name. */
+typedef String::HashType SyntaxStyleType;
+
+class EE_API SyntaxStyleTypes {
+  public:
+	static constexpr SyntaxStyleType None = 0;
+	static constexpr SyntaxStyleType Normal = String::hash( "normal" );
+	static constexpr SyntaxStyleType Symbol = String::hash( "symbol" );
+	static constexpr SyntaxStyleType Comment = String::hash( "comment" );
+	static constexpr SyntaxStyleType Keyword = String::hash( "keyword" );
+	static constexpr SyntaxStyleType Keyword2 = String::hash( "keyword2" );
+	static constexpr SyntaxStyleType Number = String::hash( "number" );
+	static constexpr SyntaxStyleType Literal = String::hash( "literal" );
+	static constexpr SyntaxStyleType Str = String::hash( "string" );
+	static constexpr SyntaxStyleType Operator = String::hash( "operator" );
+	static constexpr SyntaxStyleType Function = String::hash( "function" );
+	static constexpr SyntaxStyleType Link = String::hash( "link" );
+	static constexpr SyntaxStyleType LinkHover = String::hash( "link_hover" );
+
+	/** Registers the style type name.
+	 * @return The style type id. */
+	static SyntaxStyleType fromString( const std::string& type );
+
+	/** @return The name of a registered style type id, "normal" if the id is unknown. */
+	static const std::string& toString( const SyntaxStyleType& type );
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif // EE_UI_DOC_SYNTAXSTYLE_HPP
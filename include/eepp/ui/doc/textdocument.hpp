@@ -13,6 +13,7 @@
 #include <eepp/system/time.hpp>
 #include <eepp/ui/doc/syntaxdefinition.hpp>
 #include <eepp/ui/doc/textdocumentline.hpp>
+#include <eepp/ui/doc/textdocumentrope.hpp>
 #include <eepp/ui/doc/textposition.hpp>
 #include <eepp/ui/doc/textrange.hpp>
 #include <eepp/ui/doc/undostack.hpp>
@@ -113,6 +114,36 @@ class EE_API TextDocument {
 							std::function<void( TextDocument*, bool )> onLoaded =
 								std::function<void( TextDocument*, bool success )>() );
 
+	/**
+	 * @brief Loads the file asynchronously and incrementally.
+	 * The file is memory mapped and its lines are indexed in chunks in a pool worker. Each indexed
+	 * chunk is reported with onProgress (called from the worker thread), and must be published
+	 * into the document by calling commitLoadedLines() from the thread that owns the document.
+	 * This allows to display the first lines of huge files while the rest is still loading.
+	 * onLoaded is called from commitLoadedLines() once the whole file has been published.
+	 */
+	bool loadAsyncIncrementalFromFile(
+		const std::string& path, std::shared_ptr<ThreadPool> pool,
+		std::function<void( TextDocument*, bool )> onLoaded =
+			std::function<void( TextDocument*, bool success )>(),
+		std::function<void( TextDocument*, Float )> onProgress =
+			std::function<void( TextDocument*, Float progress )>() );
+
+	/** Publishes the lines indexed by an incremental load into the document.
+	 * @return True if new lines were added to the document. */
+	bool commitLoadedLines();
+
+	/** Stops calling the onLoaded callback of the current incremental load, used when its owner is
+	 * gone. The load continues until the whole file is published. */
+	void detachIncrementalLoadCallback();
+
+	/** @return True if the document is being loaded incrementally and its first lines are
+	 * already available. */
+	bool isLoadingIncrementally() const;
+
+	/** @return The progress of the current load, from 0 to 1. */
+	Float getLoadProgress() const;
+
 	LoadStatus loadFromMemory( const Uint8* data, const Uint32& size );
 
 	LoadStatus loadFromPack( Pack* pack, std::string filePackPath );
@@ -168,7 +199,7 @@ class EE_API TextDocument {
 
 	const TextDocumentLine& getCurrentLine() const;
 
-	std::vector<TextDocumentLine>& lines();
+	TextDocumentRope& lines();
 
 	bool hasSelection() const;
 
@@ -568,7 +599,7 @@ class EE_API TextDocument {
 	URI mFileURI;
 	URI mLoadingFileURI;
 	FileInfo mFileRealPath;
-	std::vector<TextDocumentLine> mLines;
+	TextDocumentRope mLines;
 	TextRanges mSelection;
 	std::unordered_set<Client*> mClients;
 	Mutex mClientsMutex;
@@ -576,6 +607,8 @@ class EE_API TextDocument {
 	std::atomic<bool> mLoading{ false };
 	std::atomic<bool> mRunningTransaction{ false };
 	std::atomic<bool> mLoadingAsync{ false };
+	std::atomic<bool> mLoadingIncrementally{ false };
+	std::atomic<Float> mLoadProgress{ 0 };
 	bool mIsBOM{ false };
 	bool mAutoDetectIndentType{ true };
 	bool mForceNewLineAtEndOfFile{ false };
@@ -601,6 +634,14 @@ class EE_API TextDocument {
 	mutable Mutex mLoadingFilePathMutex;
 	size_t mLastSelection{ 0 };
 	std::unique_ptr<SyntaxHighlighter> mHighlighter;
+	Mutex mPendingLinesMutex;
+	std::vector<std::vector<TextDocumentLine>> mPendingLines;
+	bool mPendingLinesFinished{ false };
+	LoadStatus mPendingLinesStatus{ LoadStatus::Failed };
+	bool mPendingIsBOM{ false };
+	LineEnding mPendingLineEnding{ LineEnding::LF };
+	bool mPendingMightBeBinary{ false };
+	std::function<void( TextDocument*, bool )> mIncrementalOnLoaded;
 
 	void initializeCommands();
 
@@ -645,14 +686,27 @@ class EE_API TextDocument {
 						 UndoStackContainer& undoStack, const Time& time,
 						 bool fromUndoRedo = false );
 
+	/** Replaces the text of the lines of a lines undo command, and records the replaced texts
+	 * as a single lines command too. The change is notified once for the whole span of lines. */
+	void replaceLines( const std::string& payload, UndoStackContainer& undoStack,
+					   const Time& time );
+
 	void appendLineIfLastLine( const size_t& cursorIdx, Int64 line );
 
 	void guessIndentType();
 
 	std::vector<bool> autoCloseBrackets( const String& text );
 
+	void textInputSelections( const String& text );
+
 	LoadStatus loadFromStream( IOStream& file, std::string path, bool callReset );
 
+	LoadStatus
+	loadIncrementalFromFile( const std::string& path,
+							 const std::function<void( TextDocument*, Float )>& onProgress );
+
+	void finishIncrementalLoad( const LoadStatus& status );
+
 	TextRange findText( String text, TextPosition from = { 0, 0 }, bool caseSensitive = true,
 						bool wholeWord = false,
 						const FindReplaceType& type = FindReplaceType::Normal,
@@ -662,6 +716,19 @@ class EE_API TextDocument {
 							bool wholeWord = false,
 							const FindReplaceType& type = FindReplaceType::Normal,
 							TextRange restrictRange = TextRange() );
+
+	/** Minimum lines scanned by every thread when searching all the occurrences of a text. */
+	static constexpr Int64 FindAllMinLinesPerThread = 16384;
+
+	/** @return True if the search is a plain single line text, that can be found line by line. */
+	static bool isLiteralSearch( const String& text, const FindReplaceType& type );
+
+	TextRanges findAllLiteral( const String& text, bool caseSensitive, bool wholeWord,
+							   TextRange restrictRange );
+
+	/** Replaces all the occurrences of a plain single line text as a single batched edit. */
+	int replaceAllLiteral( const String& text, const String& replace, const bool& caseSensitive,
+						   const bool& wholeWord, TextRange restrictRange );
 };
 
 struct TextSearchParams {
@@ -1,19 +1,47 @@
 #ifndef EE_UI_DOC_TEXTDOCUMENTLINE_HPP
 #define EE_UI_DOC_TEXTDOCUMENTLINE_HPP
 
+#include <atomic>
 #include <eepp/core/string.hpp>
 
 namespace EE { namespace UI { namespace Doc {
 
 class EE_API TextDocumentLine {
   public:
-	TextDocumentLine( const String& text ) : mText( text ) { updateHash(); }
+	TextDocumentLine( const String& text ) : mText( text ) {}
+
+	TextDocumentLine( String&& text ) : mText( std::move( text ) ) {}
+
+	TextDocumentLine( const TextDocumentLine& other ) : mText( other.mText ) {
+		copyHash( other );
+	}
+
+	TextDocumentLine( TextDocumentLine&& other ) : mText( std::move( other.mText ) ) {
+		copyHash( other );
+	}
+
+	TextDocumentLine& operator=( const TextDocumentLine& other ) {
+		mText = other.mText;
+		copyHash( other );
+		return *this;
+	}
+
+	TextDocumentLine& operator=( TextDocumentLine&& other ) {
+		mText = std::move( other.mText );
+		copyHash( other );
+		return *this;
+	}
 
 	void setText( const String& text ) {
 		mText = text;
 		updateHash();
 	}
 
+	void setText( String&& text ) {
+		mText = std::move( text );
+		updateHash();
+	}
+
 	const String& getText() const { return mText; }
 
 	String getTextWithoutNewLine() const { return mText.substr( 0, mText.size() - 1 ); }
@@ -53,15 +81,45 @@ class EE_API TextDocumentLine {
 
 	size_t length() const { return mText.length(); }
 
-	const String::HashType& getHash() const { return mHash; }
+	/** The hash is computed lazily on first request after any modification of the line. It can be
+	 * requested from several threads at once. */
+	String::HashType getHash() const {
+		Uint8 state = mHashState.load( std::memory_order_acquire );
+		if ( state == HashReady )
+			return mHash.load( std::memory_order_relaxed );
+		// Only one thread computes the hash to publish it, the others compute their own copy. If
+		// the line is modified meanwhile the state goes back to dirty and it's not published.
+		if ( state != HashDirty ||
+			 !mHashState.compare_exchange_strong( state, HashComputing,
+												  std::memory_order_acq_rel ) )
+			return mText.getHash();
+		String::HashType hash = mText.getHash();
+		mHash.store( hash, std::memory_order_relaxed );
+		Uint8 computing = HashComputing;
+		mHashState.compare_exchange_strong( computing, HashReady, std::memory_order_release,
+											std::memory_order_relaxed );
+		return hash;
+	}
 
 	std::string toUtf8() const { return mText.toUtf8(); }
 
   protected:
 	String mText;
-	String::HashType mHash;
+	enum HashState : Uint8 { HashDirty, HashComputing, HashReady };
+
+	mutable std::atomic<String::HashType> mHash{ 0 };
+	mutable std::atomic<Uint8> mHashState{ HashDirty };
 
-	void updateHash() { mHash = mText.getHash(); }
+	void updateHash() { mHashState.store( HashDirty, std::memory_order_release ); }
+
+	void copyHash( const TextDocumentLine& other ) {
+		if ( other.mHashState.load( std::memory_order_acquire ) == HashReady ) {
+			mHash.store( other.mHash.load( std::memory_order_relaxed ), std::memory_order_relaxed );
+			mHashState.store( HashReady, std::memory_order_release );
+		} else {
+			mHashState.store( HashDirty, std::memory_order_release );
+		}
+	}
 };
 
 }}} // namespace EE::UI::Doc
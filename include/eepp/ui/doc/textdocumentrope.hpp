@@ -0,0 +1,87 @@
+#ifndef EE_UI_DOC_TEXTDOCUMENTROPE_HPP
+#define EE_UI_DOC_TEXTDOCUMENTROPE_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/ui/doc/chunkindex.hpp>
+#include <eepp/ui/doc/textdocumentline.hpp>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** @brief Line storage used by the TextDocument.
+ * Lines are kept in small contiguous chunks indexed by a Fenwick tree of the chunk sizes. Random
+ * access is O(log n) and inserting or removing lines only shifts the lines of the affected chunk,
+ * instead of the whole document. */
+class EE_API TextDocumentRope {
+  public:
+	/** Maximum number of lines stored in a single chunk before it gets split. */
+	static constexpr size_t MaxChunkSize = 1024;
+
+	TextDocumentRope();
+
+	size_t size() const;
+
+	bool empty() const;
+
+	void clear();
+
+	TextDocumentLine& operator[]( const size_t& index );
+
+	const TextDocumentLine& operator[]( const size_t& index ) const;
+
+	TextDocumentLine& front();
+
+	const TextDocumentLine& front() const;
+
+	TextDocumentLine& back();
+
+	const TextDocumentLine& back() const;
+
+	void push_back( TextDocumentLine&& line );
+
+	void push_back( const TextDocumentLine& line );
+
+	void emplace_back( String&& text );
+
+	void emplace_back( const String& text );
+
+	/** Inserts a line before the line at index. */
+	void insert( const size_t& index, TextDocumentLine&& line );
+
+	/** Inserts a list of lines before the line at index. */
+	void insert( const size_t& index, std::vector<TextDocumentLine>&& lines );
+
+	void erase( const size_t& index );
+
+	/** Erases the lines in the range [first, last). */
+	void erase( const size_t& first, const size_t& last );
+
+	/** Releases the extra capacity reserved by the chunks. */
+	void shrinkToFit();
+
+	size_t chunksCount() const;
+
+  protected:
+	std::vector<std::vector<TextDocumentLine>> mChunks;
+	/** Lines count of every chunk. */
+	ChunkIndex<> mIndex;
+	size_t mSize{ 0 };
+
+	/** @return The chunk that contains the line index, index is converted to the local index in
+	 * the chunk. */
+	size_t findChunk( size_t& index ) const;
+
+	/** @return The chunk where a line should be inserted at index, index is converted to the
+	 * local index in the chunk. */
+	size_t findChunkForInsert( size_t& index );
+
+	void appendChunk();
+
+	void rebuildIndex();
+
+	void splitChunk( const size_t& chunk );
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif // EE_UI_DOC_TEXTDOCUMENTROPE_HPP
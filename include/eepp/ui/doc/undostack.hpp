@@ -7,6 +7,7 @@
 #include <eepp/system/time.hpp>
 #include <eepp/ui/doc/textrange.hpp>
 #include <memory>
+#include <string>
 
 using namespace EE::System;
 
@@ -14,76 +15,66 @@ namespace EE { namespace UI { namespace Doc {
 
 class TextDocument;
 
-enum class TextUndoCommandType { Insert, Remove, Selection };
+enum class TextUndoCommandType : Uint8 { Insert, Remove, Selection, Lines };
 
-class EE_API TextUndoCommand {
+/** @brief A list of undo or redo commands.
+ * Commands are stored by value and their payloads ( the UTF-8 text of an insert or the ranges of
+ * a selection ) are appended to a journal of big contiguous chunks, so recording an edit doesn't
+ * allocate per command. Commands can only be pushed and popped from the back and evicted from the
+ * front, which keeps the payloads of the journal in the same order than the commands. */
+class EE_API UndoStackContainer {
   public:
-	TextUndoCommand( const Uint64& id, const TextUndoCommandType& type, const Time& timestamp );
+	/** Minimum size of every chunk of the payloads journal. */
+	static constexpr size_t JournalChunkSize = 64 * 1024;
+
+	struct Command {
+		Uint64 id{ 0 };
+		Time timestamp;
+		/** Insert: the range start is the insert position. Remove: the range to remove.
+		 * Selection: unused. Lines: the first and last lines replaced. */
+		TextRange range;
+		Uint32 cursorIdx{ 0 };
+		/** Size in bytes of the payload of the command in the journal. */
+		Uint32 payloadSize{ 0 };
+		TextUndoCommandType type{ TextUndoCommandType::Insert };
+		/** Selection: the ranges were sorted. */
+		bool sorted{ false };
+	};
+
+	bool empty() const;
+
+	size_t size() const;
 
-	virtual ~TextUndoCommand();
-
-	const Uint64& getId() const;
-
-	const TextUndoCommandType& getType() const;
-
-	const Time& getTimestamp() const;
-
-  protected:
-	Uint64 mId;
-	TextUndoCommandType mType;
-	Time mTimestamp;
-};
-
-class EE_API TextUndoCommandInsert : public TextUndoCommand {
-  public:
-	TextUndoCommandInsert( const Uint64& id, const size_t& cursorIdx, const String& text,
-						   const TextPosition& position, const Time& timestamp );
-
-	const String& getText() const;
-
-	const TextPosition& getPosition() const;
-
-	size_t getCursorIdx() const;
-
-  protected:
-	String mText;
-	TextPosition mPosition;
-	size_t mCursorIdx;
-};
-
-class EE_API TextUndoCommandRemove : public TextUndoCommand {
-  public:
-	TextUndoCommandRemove( const Uint64& id, const size_t& cursorIdx, const TextRange& range,
-						   const Time& timestamp );
+	void clear();
 
-	const TextRange& getRange() const;
+	const Command& back() const;
 
-	size_t getCursorIdx() const;
+	/** @return The payload of the last command. It's valid until the container is modified. */
+	const char* backPayload() const;
 
-  protected:
-	TextRange mRange;
-	size_t mCursorIdx;
-};
+	void push( const Command& cmd, const char* payload );
 
-class EE_API TextUndoCommandSelection : public TextUndoCommand {
-  public:
-	TextUndoCommandSelection( const Uint64& id, const size_t& cursorIdx,
-							  const TextRanges& selection, const Time& timestamp );
+	void popBack();
 
-	const TextRanges& getSelection() const;
+	void popFront();
 
-	size_t getCursorIdx() const;
+	/** @return The memory used by the commands and their payloads in bytes. */
+	size_t getMemoryUsage() const;
 
   protected:
-	TextRanges mSelection;
-	size_t mCursorIdx;
+	std::deque<Command> mCommands;
+	std::deque<std::string> mJournal;
+	/** Offset of the payload of the first command in the first chunk of the journal. */
+	size_t mJournalHead{ 0 };
+	size_t mMemoryUsage{ 0 };
 };
 
-using UndoStackContainer = std::deque<TextUndoCommand*>;
-
 class EE_API UndoStack {
   public:
-	UndoStack( TextDocument* owner, const Uint32& maxStackSize = 10000 );
+	/** Default memory budget of the undo history. */
+	static constexpr size_t DefaultMaxMemorySize = 64 * 1024 * 1024;
+
+	UndoStack( TextDocument* owner, const size_t& maxMemorySize = DefaultMaxMemorySize );
 
 	~UndoStack();
 
@@ -101,7 +92,23 @@ class EE_API UndoStack {
 
 	bool hasRedo() const;
 
-	const Uint32& getMaxStackSize() const;
+	/** @return The memory budget of the undo and redo history in bytes. When the budget is
+	 * exceeded the oldest commands are discarded. */
+	const size_t& getMaxMemorySize() const;
+
+	void setMaxMemorySize( const size_t& maxMemorySize );
+
+	/** Starts a group of edits that is undone and redone as a single step, regardless of the
+	 * time it takes to apply them. Transactions can be nested. */
+	void beginTransaction( const Time& time );
+
+	void endTransaction();
+
+	bool isInTransaction() const;
+
+	/** @return The timestamp for a new edit: the transaction start time while a transaction is
+	 * running or the time provided otherwise. */
+	Time getTransactionTime( const Time& time ) const;
 
 	const Time& getMergeTimeout() const;
 
@@ -113,13 +120,17 @@ class EE_API UndoStack {
 	friend class TextDocument;
 
 	TextDocument* mDoc;
-	Uint32 mMaxStackSize;
+	size_t mMaxMemorySize;
 	Uint64 mChangeIdCounter;
 	UndoStackContainer mUndoStack;
 	UndoStackContainer mRedoStack;
 	Time mMergeTimeout;
+	Time mTransactionTime;
+	Uint32 mTransactionDepth{ 0 };
+	std::string mPayloadBuffer;
 
-	void pushUndo( UndoStackContainer& undoStack, TextUndoCommand* cmd );
+	void pushUndo( UndoStackContainer& undoStack, UndoStackContainer::Command& cmd,
+				   const char* payload );
 
 	void pushInsert( UndoStackContainer& undoStack, const String& string, const size_t& cursorIdx,
 					 const TextPosition& position, const Time& time );
@@ -130,6 +141,18 @@ class EE_API UndoStack {
 	void pushSelection( UndoStackContainer& undoStack, const size_t& cursorIdx,
 						const TextRanges& selection, const Time& time );
 
+	/** Replaces the text of a group of lines as a single command, payload is a list of lines
+	 * built with appendLinePayload. */
+	void pushLines( UndoStackContainer& undoStack, const std::string& payload,
+					const TextRange& range, const Time& time );
+
+	/** Appends the index and the text of a line to the payload of a lines command. */
+	static void appendLinePayload( std::string& payload, const Int64& line, const String& text );
+
+	/** Reads a line appended with appendLinePayload.
+	 * @return The position of the next line in the payload. */
+	static const char* readLinePayload( const char* payload, Int64& line, String& text );
+
 	UndoStackContainer& getUndoStackContainer();
 
 	UndoStackContainer& getRedoStackContainer();
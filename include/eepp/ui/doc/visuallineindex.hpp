@@ -0,0 +1,117 @@
+#ifndef EE_UI_DOC_VISUALLINEINDEX_HPP
+#define EE_UI_DOC_VISUALLINEINDEX_HPP
+
+#include <eepp/config.hpp>
+#include <eepp/core/core.hpp>
+#include <eepp/ui/doc/chunkindex.hpp>
+#include <map>
+#include <vector>
+
+namespace EE { namespace UI { namespace Doc {
+
+/** @brief Maps document lines to visual rows ( soft wrapped lines ) and keeps track of the longest
+ * line width.
+ * Lines are stored in chunks indexed by a Fenwick tree of the lines and rows count of every chunk,
+ * so converting a row into a line and a line into its first row is O(log n). Only the lines that
+ * change need to be measured again, and the longest line width is updated incrementally. Lines are
+ * created unmeasured and keep track of it, so they can be measured lazily. */
+class EE_API VisualLineIndex {
+  public:
+	/** Maximum number of lines stored in a single chunk before it gets split. */
+	static constexpr size_t MaxChunkSize = 1024;
+
+	struct Line {
+		/** Width of the whole line in pixels. */
+		Float width{ 0 };
+		/** Columns where a new visual row starts. Empty if the line is not wrapped. */
+		std::vector<Int64> breaks;
+		/** If the line was measured with the current configuration, set by setLine. */
+		bool measured{ false };
+
+		size_t rows() const { return breaks.size() + 1; }
+	};
+
+	VisualLineIndex();
+
+	/** Resets the index to count lines of a single row and no width. */
+	void reset( const size_t& count );
+
+	void clear();
+
+	size_t linesCount() const;
+
+	size_t rowsCount() const;
+
+	/** @return The number of lines that were not measured yet. */
+	size_t unmeasuredCount() const;
+
+	/** @return The first unmeasured line starting from the line at index, or linesCount() if every
+	 * remaining line is measured. */
+	size_t findUnmeasured( const size_t& index ) const;
+
+	/** Flags every line as unmeasured, keeping their current widths and rows until they are
+	 * measured again. */
+	void invalidate();
+
+	/** Inserts count unmeasured lines before the line at index. */
+	void insert( const size_t& index, const size_t& count );
+
+	/** Erases the lines in the range [first, last). */
+	void erase( const size_t& first, const size_t& last );
+
+	/** Sets the measures of the line, and flags it as measured. */
+	void setLine( const size_t& index, Line&& line );
+
+	const Line& getLine( const size_t& index ) const;
+
+	/** @return The first visual row of the line. */
+	size_t getLineFirstRow( const size_t& index ) const;
+
+	/** @return The line that contains the visual row. If rowInLine is not null it's set to the
+	 * row number relative to the line first row. */
+	size_t getLineFromRow( size_t row, size_t* rowInLine = nullptr ) const;
+
+	Float getLongestLineWidth() const;
+
+  protected:
+	struct Chunk {
+		std::vector<Line> lines;
+		size_t rows{ 0 };
+		size_t unmeasured{ 0 };
+		/** Rows before every line of the chunk, rebuilt lazily after the chunk changes. */
+		mutable std::vector<size_t> rowsOffset;
+		mutable bool rowsOffsetDirty{ true };
+	};
+
+	/** Dimensions of the chunks index. */
+	enum IndexDimension : size_t { IndexLines = 0, IndexRows = 1 };
+
+	std::vector<Chunk> mChunks;
+	/** Lines and rows count of every chunk. */
+	ChunkIndex<2> mIndex;
+	size_t mLinesCount{ 0 };
+	size_t mRowsCount{ 0 };
+	size_t mUnmeasuredCount{ 0 };
+	/** Count of lines for every measured width. */
+	std::map<Float, size_t> mWidths;
+
+	/** @return The chunk that contains the line index, index is converted to the local index in
+	 * the chunk. */
+	size_t findChunk( size_t& index ) const;
+
+	void updateRowsOffset( const Chunk& chunk ) const;
+
+	void updateIndex( const size_t& chunk, const Int64& linesDelta, const Int64& rowsDelta );
+
+	void rebuildIndex();
+
+	void splitChunk( const size_t& chunk );
+
+	void addWidth( const Float& width );
+
+	void removeWidth( const Float& width );
+};
+
+}}} // namespace EE::UI::Doc
+
+#endif // EE_UI_DOC_VISUALLINEINDEX_HPP
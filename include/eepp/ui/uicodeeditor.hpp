@@ -5,6 +5,7 @@
 #include <eepp/ui/doc/syntaxcolorscheme.hpp>
 #include <eepp/ui/doc/syntaxhighlighter.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
+#include <eepp/ui/doc/visuallineindex.hpp>
 #include <eepp/ui/keyboardshortcut.hpp>
 #include <eepp/ui/uifontstyleconfig.hpp>
 #include <eepp/ui/uiwidget.hpp>
@@ -15,6 +16,7 @@ using namespace EE::UI::Doc;
 
 namespace EE { namespace Graphics {
 class Font;
+class Primitives;
 }} // namespace EE::Graphics
 
 namespace EE { namespace UI {
@@ -173,6 +175,13 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 							std::function<void( std::shared_ptr<TextDocument>, bool )> onLoaded =
 								std::function<void( std::shared_ptr<TextDocument>, bool )>() );
 
+	/** Loads the file incrementally, the first lines are displayed while the rest of the file is
+	 * still being indexed. Recommended for huge files. */
+	bool loadAsyncIncrementalFromFile(
+		const std::string& path, std::shared_ptr<ThreadPool> pool,
+		std::function<void( std::shared_ptr<TextDocument>, bool )> onLoaded =
+			std::function<void( std::shared_ptr<TextDocument>, bool )>() );
+
 	TextDocument::LoadStatus loadFromURL(
 		const std::string& url,
 		const EE::Network::Http::Request::FieldTable& headers = Http::Request::FieldTable() );
@@ -596,6 +605,21 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	bool getShowLinesRelativePosition() const;
 	void showLinesRelativePosition( bool showLinesRelativePosition );
 
+	const bool& getWordWrap() const;
+
+	/** Soft wraps the lines that don't fit in the viewport width. */
+	void setWordWrap( const bool& wordWrap );
+
+	/** @return The number of visual rows, equal to the lines count if word wrap is disabled. */
+	size_t getVisualLinesCount() const;
+
+	/** @return The vertical offset of the first visual row of the line. */
+	Float getLineYOffset( const Int64& line ) const;
+
+	/** @return The offset of the position relative to the document start. If the line is wrapped
+	 * the horizontal offset is relative to the visual row that contains the position. */
+	Vector2f getTextPositionOffset( const TextPosition& position ) const;
+
   protected:
 	struct LastXOffset {
 		TextPosition position{ 0, 0 };
@@ -614,6 +638,8 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	bool mShowWhitespaces{ true };
 	bool mShowLineEndings{ false };
 	bool mLocked{ false };
+	bool mIncrementalLoading{ false };
+	bool mUnlockOnIncrementalLoad{ false };
 	bool mHighlightCurrentLine{ true };
 	bool mHighlightMatchingBracket{ true };
 	bool mHighlightSelectionMatch{ true };
@@ -633,7 +659,9 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	bool mFindReplaceEnabled{ true };
 	bool mShowIndentationGuides{ false };
 	bool mShowLinesRelativePosition{ false };
+	bool mWordWrap{ false };
 	std::atomic<bool> mHighlightWordProcessing{ false };
+	std::atomic<bool> mVisualLinesDirty{ true };
 	TextRange mLinkPosition;
 	String mLink;
 	Uint32 mTabWidth;
@@ -684,6 +712,38 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	UIPopUpMenu* mCurrentMenu{ nullptr };
 	MinimapConfig mMinimapConfig;
 	Int64 mMinimapScrollOffset{ 0 };
+	struct MinimapRect {
+		Float x;
+		Float width;
+		Color color;
+	};
+	/** Minimap text geometry of a range of lines, reused until any of its lines change. */
+	struct MinimapTile {
+		/** Text hash and highlighter signature of every line when the tile was built. */
+		std::vector<String::HashType> hashes;
+		std::vector<Uint64> signatures;
+		/** Index of the first rect of every line, plus the rects count. */
+		std::vector<Uint32> lineRects;
+		std::vector<MinimapRect> rects;
+	};
+	/** Parameters the minimap tiles geometry depends on. */
+	struct MinimapTilesConfig {
+		Float charSpacing{ 0 };
+		Float width{ 0 };
+		Float gutterWidth{ 0 };
+		int tabWidth{ 0 };
+		bool syntaxHighlight{ false };
+
+		bool operator!=( const MinimapTilesConfig& other ) const {
+			return charSpacing != other.charSpacing || width != other.width ||
+				   gutterWidth != other.gutterWidth || tabWidth != other.tabWidth ||
+				   syntaxHighlight != other.syntaxHighlight;
+		}
+	};
+	static constexpr Int64 MinimapTileLines = 64;
+	static constexpr size_t MinimapMaxTiles = 256;
+	std::unordered_map<Int64, MinimapTile> mMinimapTiles;
+	MinimapTilesConfig mMinimapTilesConfig;
 	struct TextLine {
 		Text text;
 		String::HashType hash;
@@ -701,6 +761,23 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	Float mPluginsTopSpace{ 0 };
 	Uint64 mLastExecuteEventId{ 0 };
 	Text mLineTextCache;
+	struct VisualLinesConfig {
+		Font* font{ nullptr };
+		Float characterSize{ 0 };
+		Uint32 fontStyle{ 0 };
+		Uint32 tabWidth{ 0 };
+		Float wrapWidth{ 0 };
+
+		bool operator==( const VisualLinesConfig& other ) const {
+			return font == other.font && characterSize == other.characterSize &&
+				   fontStyle == other.fontStyle && tabWidth == other.tabWidth &&
+				   wrapWidth == other.wrapWidth;
+		}
+	};
+	VisualLineIndex mVisualLines;
+	VisualLinesConfig mVisualLinesConfig;
+	/** Maximum number of lines measured per update while the visual lines are being measured. */
+	static constexpr size_t VisualLinesMeasureBatchSize = 2048;
 
 	UICodeEditor( const std::string& elementTag, const bool& autoRegisterBaseCommands = true,
 				  const bool& autoRegisterBaseKeybindings = true );
@@ -711,6 +788,9 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	void updateLongestLineWidth();
 
+	/** Stops waiting the incremental load of the current document, the document keeps loading. */
+	void detachIncrementalLoad();
+
 	void invalidateEditor( bool dirtyScroll = true );
 
 	void invalidateLongestLineWidth();
@@ -719,6 +799,37 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	virtual void findLongestLine();
 
+	VisualLinesConfig getVisualLinesConfig() const;
+
+	/** Rebuilds the visual lines index if the document or the measuring configuration changed.
+	 * Only the visible lines are measured, the rest are measured by measurePendingVisualLines. */
+	void updateVisualLines();
+
+	void measureVisibleVisualLines();
+
+	/** Measures the next batch of unmeasured lines, called on every update until all the lines are
+	 * measured. */
+	void measurePendingVisualLines();
+
+	void invalidateVisualLines();
+
+	VisualLineIndex::Line measureVisualLine( const Int64& line, const Float& wrapWidth );
+
+	/** @return True if the lines are being wrapped and the visual lines index is up to date. */
+	bool isWordWrapActive() const;
+
+	/** @return The visual row that contains the position. */
+	Int64 getTextPositionRow( const TextPosition& position ) const;
+
+	/** @return The column range [start, end) of a visual row of the line. */
+	std::pair<Int64, Int64> getLineRowColumns( const Int64& line, const Int64& rowInLine ) const;
+
+	/** @return The column of the line at the x offset relative to the visual row start. */
+	Int64 getColFromRowXOffset( const Int64& line, const Int64& rowInLine, const Float& x ) const;
+
+	/** @return The width of the columns range [startCol, endCol) of the line. */
+	Float getColumnsWidth( const Int64& line, const Int64& startCol, const Int64& endCol ) const;
+
 	virtual Uint32 onFocus();
 
 	virtual Uint32 onFocusLoss();
@@ -779,6 +890,9 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	void checkColorPickerAction();
 
+	/** Invalidates only the rows of the cursors, used when the cursors blink. */
+	void invalidateCursors();
+
 	virtual void drawCursor( const Vector2f& startScroll, const Float& lineHeight,
 							 const TextPosition& cursor );
 
@@ -787,6 +901,9 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 	virtual void drawLineText( const Int64& line, Vector2f position, const Float& fontSize,
 							   const Float& lineHeight );
 
+	void drawWrappedLineText( const Int64& line, Vector2f position, const Float& fontSize,
+							  const Float& lineHeight );
+
 	virtual void drawSelectionMatch( const std::pair<int, int>& lineRange,
 									 const Vector2f& startScroll, const Float& lineHeight );
 
@@ -807,6 +924,10 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 								const Vector2f& startScroll, const Float& lineHeight,
 								const Color& backgroundColor );
 
+	/** Draws the rectangles that cover the columns range of the line, one per visual row. */
+	void drawLineRange( Primitives& primitives, const Int64& line, const Int64& startCol,
+						const Int64& endCol, const Vector2f& startScroll, const Float& lineHeight );
+
 	virtual void drawLineNumbers( const std::pair<int, int>& lineRange, const Vector2f& startScroll,
 								  const Vector2f& screenStart, const Float& lineHeight,
 								  const Float& lineNumberWidth, const int& lineNumberDigits,
@@ -848,6 +969,13 @@ class EE_API UICodeEditor : public UIWidget, public TextDocument::Client {
 
 	void drawMinimap( const Vector2f& start, const std::pair<Uint64, Uint64>& lineRange );
 
+	/** @return The minimap tile, built again if any of its lines changed. */
+	const MinimapTile& getMinimapTile( const Int64& tileIndex );
+
+	void buildMinimapTile( MinimapTile& tile, const Int64& firstLine, const Int64& lastLine );
+
+	void invalidateMinimapTiles();
+
 	Float getMinimapLineSpacing() const;
 
 	bool isMinimapFileTooLarge() const;
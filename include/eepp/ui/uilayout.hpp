@@ -44,10 +44,35 @@ class EE_API UILayout : public UIWidget {
 
 	void setLayoutDirty();
 
+	/** Constraints the layout result depends on, besides the notifications of its children. */
+	struct LayoutConstraints {
+		Sizef size;
+		Rectf padding;
+		Sizef parentSize;
+		Rectf parentPadding;
+		/** Viewport relative lengths ( vw, vh ) depend on the scene size. */
+		Sizef sceneSize;
+
+		bool operator==( const LayoutConstraints& other ) const {
+			return size == other.size && padding == other.padding &&
+				   parentSize == other.parentSize && parentPadding == other.parentPadding &&
+				   sceneSize == other.sceneSize;
+		}
+	};
+
 	std::unordered_set<UILayout*> mLayouts;
 	bool mDirtyLayout{ false };
 	bool mPacking{ false };
 	bool mGravityOwner{ false };
+	/** The layout result can be reused while nothing notifies the layout and its constraints
+	 * don't change. */
+	bool mLayoutCacheEnabled{ false };
+	bool mLayoutCacheValid{ false };
+	/** Layout pass of the scene node in which the layout tree was last updated. */
+	Uint32 mLayoutPass{ 0 };
+	LayoutConstraints mLayoutConstraints;
+
+	LayoutConstraints getLayoutConstraints() const;
 };
 
 }} // namespace EE::UI
@@ -116,6 +116,18 @@ class EE_API UISceneNode : public SceneNode {
 
 	const bool& isUpdatingLayouts() const;
 
+	struct LayoutStats {
+		/** Dirty layouts that started a layout tree update. */
+		Uint32 roots{ 0 };
+		/** Layouts that were laid out. */
+		Uint32 layouts{ 0 };
+		/** Layouts skipped because nothing changed since their last layout. */
+		Uint32 cachedLayouts{ 0 };
+	};
+
+	/** @return The layout work done during the last update. */
+	const LayoutStats& getLayoutStats() const;
+
 	UIIconThemeManager* getUIIconThemeManager() const;
 
 	UIIcon* findIcon( const std::string& iconName );
@@ -168,6 +180,7 @@ class EE_API UISceneNode : public SceneNode {
   protected:
 	friend class EE::UI::UIWindow;
 	friend class EE::UI::UIWidget;
+	friend class EE::UI::UILayout;
 	UIWidget* mRoot{ nullptr };
 	Sizef mDpSize;
 	Uint32 mFlags;
@@ -188,6 +201,11 @@ class EE_API UISceneNode : public SceneNode {
 	std::unordered_set<UIWidget*> mDirtyStyleState;
 	std::unordered_map<UIWidget*, bool> mDirtyStyleStateCSSAnimations;
 	std::unordered_set<UILayout*> mDirtyLayouts;
+	static constexpr Uint32 MaxLayoutPasses = 8;
+	/** Dirty layouts being updated, sorted by their depth in the tree. */
+	std::vector<std::pair<size_t, UILayout*>> mLayoutQueue;
+	Uint32 mLayoutPass{ 0 };
+	LayoutStats mLayoutStats;
 	std::vector<std::pair<Float, std::string>> mTimes;
 	ColorSchemePreference mColorSchemePreference{ ColorSchemePreference::Dark };
 	Uint32 mMaxInvalidationDepth{ 2 };
@@ -128,6 +128,8 @@ class EE_API UITabWidget : public UIWidget {
 
 	void invalidate( Node* invalidator );
 
+	void invalidateArea( Node* invalidator, const Rectf& area );
+
 	void selectPreviousTab();
 
 	void selectNextTab();
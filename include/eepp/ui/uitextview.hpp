@@ -130,6 +130,8 @@ class EE_API UITextView : public UIWidget {
 
 	virtual void onSizeChange();
 
+	virtual void updateDrawBounds();
+
 	virtual void autoWrap();
 
 	virtual void onAutoSize();
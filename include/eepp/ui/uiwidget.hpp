@@ -279,6 +279,12 @@ class EE_API UIWidget : public UINode {
 
 	virtual void onAutoSize();
 
+	virtual void updateDrawBounds();
+
+	/** Expands the draw bounds with a rectangle in screen coordinates. Rotated or scaled nodes
+	 * can't map it to the screen, so they are considered to draw over the whole scene. */
+	void expandDrawBounds( const Rectf& rect );
+
 	virtual void onWidgetCreated();
 
 	virtual void onPaddingChange();
@@ -281,6 +281,8 @@ class EE_API UIWindow : public UIWidget {
 
 	virtual void drawShadow();
 
+	virtual void updateDrawBounds();
+
 	virtual void onPaddingChange();
 
 	virtual void preDraw();
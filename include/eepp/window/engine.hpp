@@ -64,7 +64,7 @@ class EE_API Engine {
 		BitColor		32,16,8
 		Windowed		bool
 		Resizeable		bool
-		Backend			SDL2
+		Backend			SDL2 or Headless
 		WinIcon			The path to the window icon
 		WinTitle		The window default title
 
@@ -80,7 +80,7 @@ class EE_API Engine {
 		BitColor		32,16,8
 		Windowed		bool
 		Resizeable		bool
-		Backend			SDL2
+		Backend			SDL2 or Headless
 		WinIcon			The path to the window icon
 		WinTitle		The window default title
 
@@ -169,6 +169,9 @@ class EE_API Engine {
 	EE::Window::Window* createSDL2Window( const WindowSettings& Settings,
 										  const ContextSettings& Context );
 
+	EE::Window::Window* createHeadlessWindow( const WindowSettings& Settings,
+											  const ContextSettings& Context );
+
 	EE::Window::Window* createDefaultWindow( const WindowSettings& Settings,
 											 const ContextSettings& Context );
 
@@ -2,6 +2,7 @@
 #define EE_WINDOWCINPUT_H
 
 #include <eepp/graphics/view.hpp>
+#include <eepp/system/mutex.hpp>
 #include <eepp/window/base.hpp>
 #include <eepp/window/inputevent.hpp>
 #include <eepp/window/inputfinger.hpp>
@@ -244,6 +245,10 @@ class EE_API Input {
 	/** Process an input event. Called by the input update. */
 	void processEvent( InputEvent* Event );
 
+	/** Queues a synthetic input event, it will be processed in the next input update as any other
+	 * event coming from the backend. It's safe to call it from any thread. */
+	void injectEvent( const InputEvent& event );
+
 	/** @return An id of the current event update processed ( */
 	const Uint64& getEventsSentId() const;
 
@@ -285,6 +290,11 @@ class EE_API Input {
 	Uint64 mEventsSentId{ 0 };
 
 	std::map<Uint32, InputCallback> mCallbacks;
+	std::vector<InputEvent> mInjectedEvents;
+	Mutex mInjectedEventsMutex;
+
+	/** Processes the events queued with injectEvent. Called by the backend input update. */
+	void processInjectedEvents();
 
 	InputFinger* getFingerId( const Int64& fingerId );
 
@@ -29,7 +29,9 @@ enum WindowStyle {
 #endif
 };
 
-enum class WindowBackend : Uint32 { SDL2, Default };
+/** Headless creates a hidden window with an offscreen GL context when the platform supports it,
+ * intended for automated tests and server side rendering. */
+enum class WindowBackend : Uint32 { SDL2, Default, Headless };
 
 #ifndef EE_SCREEN_KEYBOARD_ENABLED
 #if EE_PLATFORM == EE_PLATFORM_ANDROID || EE_PLATFORM == EE_PLATFORM_IOS
@@ -465,6 +467,14 @@ class EE_API Window {
 
 	const Sizei& getLastWindowedSize() const;
 
+	/** Sets a fixed frame time. When set the elapsed time of every frame will be the fixed time
+	 * step instead of the measured time, making the animations and timers deterministic.
+	 * @param timeStep The fixed frame time ( Time::Zero disables it ) */
+	void setFixedTimeStep( const System::Time& timeStep );
+
+	/** @return The fixed frame time ( Time::Zero if disabled ) */
+	const System::Time& getFixedTimeStep() const;
+
   protected:
 	friend class Engine;
 	friend class Input;
@@ -503,6 +513,7 @@ class EE_API Window {
 		FPSData FPS;
 		Clock* FrameElapsed;
 		System::Time ElapsedTime;
+		System::Time FixedTimeStep;
 
 		FrameData();
 
@@ -1148,6 +1148,13 @@ workspace "eepp"
 		includedirs { "src/thirdparty" }
 		build_link_configuration( "eepp-ui-perf-test", true )
 
+	project "eepp-benchmark"
+		kind "ConsoleApp"
+		language "C++"
+		files { "src/tests/benchmark/*.cpp" }
+		includedirs { "src/thirdparty" }
+		build_link_configuration( "eepp-benchmark", true )
+
 if os.isfile("external_projects.lua") then
 	dofile("external_projects.lua")
 end
@@ -155,6 +155,20 @@ void ClippingMask::setScissorsClipped( const std::list<Rectf>& scissorsClipped )
 	}
 }
 
+bool ClippingMask::getScissorClip( Rectf& rect ) const {
+	if ( mScissorsClipped.empty() )
+		return false;
+	rect = mScissorsClipped.back();
+	return true;
+}
+
+bool ClippingMask::getPlaneClip( Rectf& rect ) const {
+	if ( mPlanesClipped.empty() )
+		return false;
+	rect = mPlanesClipped.back();
+	return true;
+}
+
 std::list<Rectf> ClippingMask::getPlanesClipped() const {
 	return mPlanesClipped;
 }
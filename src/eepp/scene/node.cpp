@@ -41,6 +41,9 @@ Node::~Node() {
 
 		if ( isMouseOverMeOrChilds() )
 			mSceneNode->removeMouseOverNode( this );
+
+		if ( mSceneNode != this )
+			mSceneNode->invalidateNodeArea( this, false );
 	}
 
 	childDeleteAll();
@@ -245,6 +248,9 @@ Node* Node::setParent( Node* parent ) {
 	if ( parent == mParentNode )
 		return this;
 
+	if ( NULL != mSceneNode && mSceneNode != this )
+		mSceneNode->invalidateNodeArea( this, true );
+
 	if ( NULL != mParentNode )
 		mParentNode->childRemove( this );
 
@@ -483,6 +489,14 @@ Rectf Node::getScreenBounds() {
 				  Sizef( (Float)(int)mSize.getWidth(), (Float)(int)mSize.getHeight() ) );
 }
 
+void Node::updateDrawBounds() {
+	if ( mNodeFlags & ( NODE_FLAG_ROTATED | NODE_FLAG_SCALED ) ) {
+		mDrawBounds = getWorldBounds();
+	} else {
+		mDrawBounds = Rectf( mScreenPos, mSize );
+	}
+}
+
 Rectf Node::getLocalBounds() const {
 	return Rectf( 0, 0, mSize.getWidth(), mSize.getHeight() );
 }
@@ -496,11 +510,14 @@ void Node::setNodeFlags( const Uint32& flags ) {
 }
 
 void Node::drawChilds() {
+	Rectf clip;
+	bool cull = getChildsDrawClip( clip );
+
 	if ( isReverseDraw() ) {
 		Node* child = mChildLast;
 
 		while ( NULL != child ) {
-			if ( child->mVisible ) {
+			if ( child->mVisible && ( !cull || !child->isDrawCulled( clip ) ) ) {
 				child->nodeDraw();
 			}
 
@@ -510,7 +527,7 @@ void Node::drawChilds() {
 		Node* child = mChild;
 
 		while ( NULL != child ) {
-			if ( child->mVisible ) {
+			if ( child->mVisible && ( !cull || !child->isDrawCulled( clip ) ) ) {
 				child->nodeDraw();
 			}
 
@@ -519,11 +536,63 @@ void Node::drawChilds() {
 	}
 }
 
+bool Node::getChildsDrawClip( Rectf& clip ) const {
+	if ( NULL == mChild )
+		return false;
+
+	// Nodes are clipped with planes when drawn transformed or into a frame buffer, and the clip
+	// planes are in the untransformed coordinates, so only untransformed trees can be culled.
+	bool frameBuffer = false;
+
+	for ( const Node* node = this; NULL != node; node = node->mParentNode ) {
+		if ( node->mNodeFlags & ( NODE_FLAG_ROTATED | NODE_FLAG_SCALED ) )
+			return false;
+
+		if ( node->mNodeFlags & NODE_FLAG_FRAME_BUFFER )
+			frameBuffer = true;
+	}
+
+	ClippingMask* clippingMask = GLi->getClippingMask();
+
+	return frameBuffer ? clippingMask->getPlaneClip( clip ) : clippingMask->getScissorClip( clip );
+}
+
+bool Node::isDrawCulled( const Rectf& clip ) {
+	// Unclipped nodes can draw their children anywhere, windows and scene nodes reset the clipping.
+	if ( ( NULL != mChild && !isClipped() ) || isWindow() || isSceneNode() ||
+		 ( mNodeFlags & ( NODE_FLAG_ROTATED | NODE_FLAG_SCALED ) ) )
+		return false;
+
+	if ( mNodeFlags & NODE_FLAG_POSITION_DIRTY )
+		updateScreenPos();
+
+	// The same bounds used to damage the scene, including anything drawn around the box
+	updateDrawBounds();
+
+	if ( !clip.intersect( mDrawBounds ) )
+		return true;
+
+	// The node is drawn right after, nodeDraw doesn't need to update the bounds again
+	mNodeFlags |= NODE_FLAG_DRAW_BOUNDS_UPDATED;
+
+	return false;
+}
+
+void Node::updateDrawBoundsForDraw() {
+	if ( mNodeFlags & NODE_FLAG_DRAW_BOUNDS_UPDATED ) {
+		mNodeFlags &= ~NODE_FLAG_DRAW_BOUNDS_UPDATED;
+	} else {
+		updateDrawBounds();
+	}
+}
+
 void Node::nodeDraw() {
 	if ( mVisible ) {
 		if ( mNodeFlags & NODE_FLAG_POSITION_DIRTY )
 			updateScreenPos();
 
+		updateDrawBoundsForDraw();
+
 		matrixSet();
 
 		clipStart();
@@ -928,12 +997,17 @@ Node* Node::overFind( const Vector2f& point ) {
 			Node* child = mChildLast;
 
 			while ( NULL != child ) {
-				Node* childOver = child->overFind( point );
+				// Skips the call for the children that can't contain the point, overFind would
+				// reject them too before visiting their trees.
+				if ( child->mVisible && child->mEnabled &&
+					 child->getWorldBounds().contains( point ) ) {
+					Node* childOver = child->overFind( point );
 
-				if ( NULL != childOver ) {
-					pOver = childOver;
+					if ( NULL != childOver ) {
+						pOver = childOver;
 
-					break; // Search from top to bottom, so the first over will be the topmost
+						break; // Search from top to bottom, so the first over will be the topmost
+					}
 				}
 
 				child = child->mPrev;
@@ -949,6 +1023,9 @@ Node* Node::overFind( const Vector2f& point ) {
 
 void Node::detach() {
 	if ( mParentNode ) {
+		if ( NULL != mSceneNode && mSceneNode != this )
+			mSceneNode->invalidateNodeArea( this, true );
+
 		mParentNode->childRemove( this );
 		mParentNode = NULL;
 	}
@@ -1236,6 +1313,12 @@ void Node::invalidateDraw() {
 	}
 }
 
+void Node::invalidateDraw( const Rectf& area ) {
+	if ( NULL != mNodeDrawInvalidator ) {
+		mNodeDrawInvalidator->invalidateArea( this, area );
+	}
+}
+
 SceneNode* Node::getSceneNode() const {
 	return mSceneNode;
 }
@@ -1694,6 +1777,10 @@ void Node::invalidate( Node* ) {
 	}
 }
 
+void Node::invalidateArea( Node* invalidator, const Rectf& ) {
+	invalidate( invalidator );
+}
+
 bool Node::invalidated() const {
 	return 0 != ( mNodeFlags & NODE_FLAG_VIEW_DIRTY );
 }
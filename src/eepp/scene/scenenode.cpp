@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <eepp/graphics/framebuffer.hpp>
 #include <eepp/graphics/globalbatchrenderer.hpp>
+#include <eepp/graphics/primitives.hpp>
 #include <eepp/graphics/renderer/renderer.hpp>
 #include <eepp/graphics/textureregion.hpp>
 #include <eepp/scene/actionmanager.hpp>
@@ -11,6 +12,24 @@
 
 namespace EE { namespace Scene {
 
+// Above this count of damaged nodes the whole scene is redrawn.
+static constexpr size_t MaxDamagedNodes = 512;
+
+static bool isEmptyRect( const Rectf& rect ) {
+	return rect.Right <= rect.Left || rect.Bottom <= rect.Top;
+}
+
+static void damageRegionAdd( Rectf& region, const Rectf& rect ) {
+	if ( isEmptyRect( rect ) )
+		return;
+
+	if ( isEmptyRect( region ) ) {
+		region = rect;
+	} else {
+		region.expand( rect );
+	}
+}
+
 SceneNode* SceneNode::New( EE::Window::Window* window ) {
 	return eeNew( SceneNode, ( window ) );
 }
@@ -54,6 +73,10 @@ SceneNode::SceneNode( EE::Window::Window* window ) :
 }
 
 SceneNode::~SceneNode() {
+	// The children are deleted after the scene node, they must not report their area.
+	mUseDrawDamageRegions = false;
+	mDamagedNodes.clear();
+
 	if ( -1 != mResizeCb && NULL != Engine::existsSingleton() &&
 		 Engine::instance()->existsWindow( mWindow ) ) {
 		mWindow->popResizeCallback( mResizeCb );
@@ -94,6 +117,8 @@ void SceneNode::draw() {
 	if ( mVisible && 0 != mAlpha ) {
 		updateScreenPos();
 
+		updateDrawDamageRegion();
+
 		preDraw();
 
 		ClippingMask* clippingMask = GLi->getClippingMask();
@@ -108,7 +133,19 @@ void SceneNode::draw() {
 		if ( NULL == mFrameBuffer || !usesInvalidation() || invalidated() ) {
 			clipStart();
 
-			drawChilds();
+			if ( !mDrawDamagePartial ) {
+				drawChilds();
+			} else if ( !isEmptyRect( mDrawDamageRegion ) ) {
+				clippingMask->clipPlaneEnable( mDrawDamageRegion.Left, mDrawDamageRegion.Top,
+											   mDrawDamageRegion.getWidth(),
+											   mDrawDamageRegion.getHeight() );
+
+				clearDrawDamageRegion();
+
+				drawChilds();
+
+				clippingMask->clipPlaneDisable();
+			}
 
 			clipEnd();
 		}
@@ -161,6 +198,8 @@ void SceneNode::update( const Time& time ) {
 }
 
 void SceneNode::onSizeChange() {
+	mDrawDamageFull = true;
+
 	if ( NULL != mFrameBuffer && ( mFrameBuffer->getWidth() < mSize.getWidth() ||
 								   mFrameBuffer->getHeight() < mSize.getHeight() ) ) {
 		if ( NULL == mFrameBuffer ) {
@@ -250,6 +289,7 @@ Sizei SceneNode::getFrameBufferSize() {
 
 void SceneNode::createFrameBuffer() {
 	writeNodeFlag( NODE_FLAG_FRAME_BUFFER, 1 );
+	mDrawDamageFull = true;
 	eeSAFE_DELETE( mFrameBuffer );
 	Sizei fboSize( getFrameBufferSize() );
 	if ( fboSize.getWidth() < 1 )
@@ -288,6 +328,179 @@ void SceneNode::disableDrawInvalidation() {
 	mUseInvalidation = false;
 }
 
+void SceneNode::enableDrawDamageRegions() {
+	if ( !mUseDrawDamageRegions ) {
+		mUseDrawDamageRegions = true;
+		mDrawDamageFull = true;
+		invalidateDraw();
+	}
+}
+
+void SceneNode::disableDrawDamageRegions() {
+	mUseDrawDamageRegions = false;
+	mDrawDamagePartial = false;
+	mDrawDamageRegion = Rectf();
+	mDamagedArea = Rectf();
+	mDamagedNodes.clear();
+}
+
+bool SceneNode::usesDrawDamageRegions() const {
+	return mUseDrawDamageRegions;
+}
+
+const Rectf& SceneNode::getDrawDamageRegion() const {
+	return mDrawDamageRegion;
+}
+
+void SceneNode::invalidate( Node* invalidator ) {
+	Node::invalidate( invalidator );
+
+	if ( mUseDrawDamageRegions && !mDrawDamageFull ) {
+		if ( NULL == invalidator || invalidator == this ||
+			 mDamagedNodes.size() >= MaxDamagedNodes ) {
+			mDrawDamageFull = true;
+			mDamagedNodes.clear();
+		} else {
+			mDamagedNodes.insert( invalidator );
+		}
+	}
+}
+
+void SceneNode::invalidateArea( Node* invalidator, const Rectf& area ) {
+	// The node damage already covers the area, and transformed nodes can't damage a screen area.
+	if ( !mUseDrawDamageRegions || mDrawDamageFull || NULL == invalidator || invalidator == this ||
+		 mDamagedNodes.find( invalidator ) != mDamagedNodes.end() ||
+		 invalidator->isMeOrParentTreeScaledOrRotated() ) {
+		invalidate( invalidator );
+		return;
+	}
+
+	Node::invalidate( invalidator );
+
+	damageRegionAdd( mDamagedArea, area );
+}
+
+void SceneNode::invalidateNodeArea( Node* node, bool recursive ) {
+	if ( !mUseDrawDamageRegions )
+		return;
+
+	mDamagedNodes.erase( node );
+
+	damageRegionAdd( mDamagedArea, node->mDrawBounds );
+
+	if ( recursive ) {
+		for ( Node* child = node->mChild; NULL != child; child = child->mNext )
+			invalidateNodeArea( child, true );
+	}
+}
+
+bool SceneNode::addDrawDamage( Node* node, Rectf& region ) {
+	if ( node->isRotated() || node->isScaled() )
+		return false;
+
+	damageRegionAdd( region, node->mDrawBounds );
+
+	if ( node->mVisible ) {
+		if ( node->mNodeFlags & NODE_FLAG_POSITION_DIRTY )
+			node->updateScreenPos();
+
+		node->updateDrawBounds();
+
+		damageRegionAdd( region, node->mDrawBounds );
+
+		// The children of a clipped node can't be drawn outside of it.
+		if ( node->isClipped() )
+			return true;
+	}
+
+	for ( Node* child = node->mChild; NULL != child; child = child->mNext ) {
+		if ( !addDrawDamage( child, region ) )
+			return false;
+	}
+
+	return true;
+}
+
+void SceneNode::findUnclippedNodes( Node* node, std::vector<Node*>& nodes ) {
+	for ( Node* child = node->mChild; NULL != child; child = child->mNext ) {
+		if ( !child->mVisible )
+			continue;
+
+		// Windows and scene nodes reset the clipping planes to draw themselves.
+		if ( child->isWindow() || child->isSceneNode() )
+			nodes.push_back( child );
+
+		findUnclippedNodes( child, nodes );
+	}
+}
+
+void SceneNode::updateDrawDamageRegion() {
+	if ( !mUseDrawDamageRegions || NULL == mFrameBuffer || !mUseInvalidation || !invalidated() ) {
+		mDrawDamagePartial = false;
+		mDrawDamageRegion = Rectf();
+		return;
+	}
+
+	Rectf region( mDamagedArea );
+	bool partial = !mDrawDamageFull && !mDrawDebugData && !mDrawBoxes && !mHighlightOver &&
+				   !mHighlightFocus && !mHighlightInvalidation &&
+				   !isMeOrParentTreeScaledOrRotated();
+
+	if ( partial ) {
+		for ( Node* node : mDamagedNodes ) {
+			if ( node->isMeOrParentTreeScaledOrRotated() || !addDrawDamage( node, region ) ) {
+				partial = false;
+				break;
+			}
+		}
+	}
+
+	if ( partial && !isEmptyRect( region ) ) {
+		// Nodes drawn without the damage clipping must be redrawn entirely over a cleared area.
+		std::vector<Node*> unclippedNodes;
+		findUnclippedNodes( this, unclippedNodes );
+
+		bool expanded = !unclippedNodes.empty();
+
+		while ( expanded ) {
+			expanded = false;
+
+			for ( Node* node : unclippedNodes ) {
+				if ( !isEmptyRect( node->mDrawBounds ) && region.intersect( node->mDrawBounds ) &&
+					 !region.contains( node->mDrawBounds ) ) {
+					region.expand( node->mDrawBounds );
+					expanded = true;
+				}
+			}
+		}
+
+		Rectf sceneRect( mScreenPos, mSize );
+		region = Rectf( eefloor( region.Left ) - 1, eefloor( region.Top ) - 1,
+						eeceil( region.Right ) + 1, eeceil( region.Bottom ) + 1 );
+		region.shrink( sceneRect );
+
+		// Redrawing most of the scene in a clipped pass is not worth it.
+		if ( region.area() > sceneRect.area() * 0.5f )
+			partial = false;
+	}
+
+	mDrawDamagePartial = partial;
+	mDrawDamageRegion = partial ? region : Rectf();
+	mDrawDamageFull = false;
+	mDamagedArea = Rectf();
+	mDamagedNodes.clear();
+}
+
+void SceneNode::clearDrawDamageRegion() {
+	ColorAf clearColor( mFrameBuffer->getClearColor() );
+
+	Primitives P;
+	P.setBlendMode( BlendMode::None() );
+	P.setColor( Color( clearColor.r * 255, clearColor.g * 255, clearColor.b * 255,
+					   clearColor.a * 255 ) );
+	P.drawRectangle( mDrawDamageRegion );
+}
+
 EE::Window::Window* SceneNode::getWindow() {
 	return mWindow;
 }
@@ -299,7 +512,9 @@ void SceneNode::matrixSet() {
 
 			mFrameBuffer->bind();
 
-			mFrameBuffer->clear();
+			// A partial redraw keeps the last frame and only clears the damaged region.
+			if ( !mDrawDamagePartial )
+				mFrameBuffer->clear();
 		}
 
 		if ( 0.f != mScreenPos ) {
@@ -0,0 +1,169 @@
+#include <cstring>
+#include <eepp/core/memorymanager.hpp>
+#include <eepp/core/string.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
+
+#if EE_PLATFORM == EE_PLATFORM_WIN
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined( EE_PLATFORM_POSIX )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace EE { namespace System {
+
+IOStreamMappedFile* IOStreamMappedFile::New( const std::string& path ) {
+	return eeNew( IOStreamMappedFile, ( path ) );
+}
+
+IOStreamMappedFile::IOStreamMappedFile( const std::string& path ) :
+	mData( nullptr ),
+	mSize( 0 ),
+	mPos( 0 ),
+	mOpen( false ),
+	mMapped( false )
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	,
+	mFileHandle( INVALID_HANDLE_VALUE ),
+	mMappingHandle( nullptr )
+#endif
+{
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	HANDLE file = CreateFileW( String( path ).toWideString().c_str(), GENERIC_READ,
+							   FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+							   OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+	if ( file == INVALID_HANDLE_VALUE )
+		return;
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( file, &size ) ) {
+		CloseHandle( file );
+		return;
+	}
+	mFileHandle = file;
+	mSize = static_cast<ios_size>( size.QuadPart );
+	mOpen = true;
+	if ( mSize == 0 )
+		return;
+	HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	if ( mapping != NULL ) {
+		void* data = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( data != NULL ) {
+			mMappingHandle = mapping;
+			mData = static_cast<const char*>( data );
+			mMapped = true;
+			return;
+		}
+		CloseHandle( mapping );
+	}
+	CloseHandle( file );
+	mFileHandle = INVALID_HANDLE_VALUE;
+#elif defined( EE_PLATFORM_POSIX )
+	int fd = ::open( path.c_str(), O_RDONLY );
+	if ( fd == -1 )
+		return;
+	struct stat st;
+	if ( ::fstat( fd, &st ) != 0 ) {
+		::close( fd );
+		return;
+	}
+	mSize = static_cast<ios_size>( st.st_size );
+	mOpen = true;
+	if ( mSize > 0 ) {
+		void* data = ::mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if ( data != MAP_FAILED ) {
+#ifdef MADV_SEQUENTIAL
+			::madvise( data, mSize, MADV_SEQUENTIAL );
+#endif
+			mData = static_cast<const char*>( data );
+			mMapped = true;
+		}
+	}
+	::close( fd );
+	if ( mMapped || mSize == 0 )
+		return;
+#endif
+	// Memory mapping not available, fallback to read the whole file.
+	mOpen = false;
+	mSize = 0;
+	if ( FileSystem::fileGet( path, mBuffer ) ) {
+		mData = reinterpret_cast<const char*>( mBuffer.get() );
+		mSize = mBuffer.length();
+		mOpen = true;
+	}
+}
+
+IOStreamMappedFile::~IOStreamMappedFile() {
+	close();
+}
+
+ios_size IOStreamMappedFile::read( char* data, ios_size size ) {
+	if ( !isOpen() || mPos >= mSize )
+		return 0;
+	ios_size count = eemin( size, mSize - mPos );
+	std::memcpy( data, mData + mPos, count );
+	mPos += count;
+	return count;
+}
+
+ios_size IOStreamMappedFile::write( const char*, ios_size ) {
+	return 0;
+}
+
+ios_size IOStreamMappedFile::seek( ios_size position ) {
+	mPos = eemax<ios_size>( 0, eemin( position, mSize ) );
+	return mPos;
+}
+
+ios_size IOStreamMappedFile::tell() {
+	return isOpen() ? mPos : -1;
+}
+
+ios_size IOStreamMappedFile::getSize() {
+	return mSize;
+}
+
+bool IOStreamMappedFile::isOpen() {
+	return mOpen;
+}
+
+void IOStreamMappedFile::close() {
+	if ( !mOpen )
+		return;
+	if ( mMapped ) {
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		UnmapViewOfFile( mData );
+		CloseHandle( (HANDLE)mMappingHandle );
+		mMappingHandle = nullptr;
+#elif defined( EE_PLATFORM_POSIX )
+		::munmap( const_cast<char*>( mData ), mSize );
+#endif
+	} else {
+		mBuffer.clear();
+	}
+#if EE_PLATFORM == EE_PLATFORM_WIN
+	if ( mFileHandle != INVALID_HANDLE_VALUE ) {
+		CloseHandle( (HANDLE)mFileHandle );
+		mFileHandle = INVALID_HANDLE_VALUE;
+	}
+#endif
+	mData = nullptr;
+	mSize = 0;
+	mPos = 0;
+	mOpen = false;
+	mMapped = false;
+}
+
+const char* IOStreamMappedFile::getData() const {
+	return mData;
+}
+
+}} // namespace EE::System
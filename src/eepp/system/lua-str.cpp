@@ -414,8 +414,100 @@ static int push_captures( MatchState* ms, const char* s, const char* e, LuaMatch
 	return nlevels; /* number of strings pushed */
 }
 
+#define in_first_chars( set, c ) ( ( set )[uchar( c ) >> 3] & ( 1 << ( uchar( c ) & 7 ) ) )
+
+static void add_class_chars( const char* p, const char* ep, unsigned char* set ) {
+	int c;
+	for ( c = 0; c < 256; c++ ) {
+		int res;
+		switch ( *p ) {
+			case '.':
+				res = 1;
+				break;
+			case L_ESC:
+				res = match_class( c, uchar( *( p + 1 ) ) );
+				break;
+			case '[':
+				res = matchbracketclass( c, p, ep - 1 );
+				break;
+			default:
+				res = ( uchar( *p ) == c );
+		}
+		if ( res )
+			set[c >> 3] |= ( 1 << ( c & 7 ) );
+	}
+}
+
+int lua_str_first_chars( const char* p, size_t lp, unsigned char* set ) {
+	MatchState ms;
+	memset( set, 0, 32 );
+	if ( *p == '^' ) {
+		p++;
+		lp--;
+	}
+	ms.p_end = p + lp;
+	while ( p < ms.p_end ) {
+		const char* ep;
+		switch ( *p ) {
+			case '(': /* captures don't consume characters */
+				p += ( *( p + 1 ) == ')' ) ? 2 : 1;
+				continue;
+			case ')':
+				p++;
+				continue;
+			case '$':
+				if ( ( p + 1 ) == ms.p_end ) /* only matches the end of the string */
+					return 0;
+				break;
+			case L_ESC: {
+				switch ( *( p + 1 ) ) {
+					case 'b': /* balanced string starts with its first argument */
+						if ( p + 3 >= ms.p_end )
+							return 0;
+						set[uchar( p[2] ) >> 3] |= ( 1 << ( uchar( p[2] ) & 7 ) );
+						return 1;
+					case 'f': /* frontier doesn't consume characters */
+						p += 2;
+						if ( *p != '[' )
+							return 0;
+						p = classend( &ms, p );
+						continue;
+					case '0':
+					case '1':
+					case '2':
+					case '3':
+					case '4':
+					case '5':
+					case '6':
+					case '7':
+					case '8':
+					case '9': /* captures can be empty */
+						return 0;
+					default:
+						break;
+				}
+				break;
+			}
+			default:
+				break;
+		}
+		ep = classend( &ms, p );
+		add_class_chars( p, ep, set );
+		if ( *ep == '*' || *ep == '?' || *ep == '-' ) { /* accepts empty, keep looking */
+			p = ep + 1;
+			continue;
+		}
+		return 1;
+	}
+	return 0;
+}
+
 int lua_str_match( const char* s, int offset, size_t ls, const char* p, LuaMatch* mm ) {
-	size_t lp = strlen( p );
+	return lua_str_match_ex( s, offset, ls, p, strlen( p ), NULL, mm );
+}
+
+int lua_str_match_ex( const char* s, int offset, size_t ls, const char* p, size_t lp,
+					  const unsigned char* firstChars, LuaMatch* mm ) {
 	const char* s1 = s + offset;
 	MatchState ms;
 	int anchor = ( *p == '^' );
@@ -429,6 +521,17 @@ int lua_str_match( const char* s, int offset, size_t ls, const char* p, LuaMatch
 	ms.p_end = p + lp;
 	do {
 		const char* res;
+		if ( firstChars ) { /* skip the positions that can't start a match */
+			if ( anchor ) {
+				if ( s1 >= ms.src_end || !in_first_chars( firstChars, *s1 ) )
+					return 0;
+			} else {
+				while ( s1 < ms.src_end && !in_first_chars( firstChars, *s1 ) )
+					s1++;
+				if ( s1 >= ms.src_end )
+					return 0;
+			}
+		}
 		ms.level = 0;
 		if ( ( res = match( &ms, s1, p ) ) != NULL ) {
 			mm[0].start = s1 - s; /* start */
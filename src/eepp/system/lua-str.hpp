@@ -14,4 +14,13 @@ struct LuaMatch {
 
 int lua_str_match( const char* text, int offset, size_t len, const char* pattern, LuaMatch* mm );
 
+/* Fills firstChars ( a 256 bits set ) with the characters that can start a match of the pattern.
+** Returns 0 if the pattern can match an empty string, in that case it can't be used as a filter. */
+int lua_str_first_chars( const char* pattern, size_t patternLen, unsigned char* firstChars );
+
+/* Same as lua_str_match but receives the pattern length and an optional first characters set
+** ( see lua_str_first_chars ) used to skip the positions that can't start a match. */
+int lua_str_match_ex( const char* text, int offset, size_t len, const char* pattern,
+					  size_t patternLen, const unsigned char* firstChars, LuaMatch* mm );
+
 #endif // EE_SYSTEM_LUA_STR_HPP
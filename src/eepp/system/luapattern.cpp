@@ -57,6 +57,13 @@ LuaPattern::LuaPattern( const std::string& pattern ) : mPattern( pattern ) {
 		sFailHandlerInitialized = true;
 		lua_str_fail_func( failHandler );
 	}
+	try {
+		mHasFirstChars = !mPattern.empty() &&
+						 lua_str_first_chars( mPattern.c_str(), mPattern.size(), mFirstChars ) != 0;
+	} catch ( const std::string& patternError ) {
+		mErr = patternError;
+		mHasFirstChars = false;
+	}
 }
 
 bool LuaPattern::matches( const char* stringSearch, int stringStartOffset,
@@ -67,8 +74,9 @@ bool LuaPattern::matches( const char* stringSearch, int stringStartOffset,
 	if ( stringLength == 0 )
 		stringLength = strlen( stringSearch );
 	try {
-		mMatchNum = lua_str_match( stringSearch, stringStartOffset, stringLength, mPattern.c_str(),
-								   (LuaMatch*)matchList );
+		mMatchNum = lua_str_match_ex( stringSearch, stringStartOffset, stringLength,
+									  mPattern.c_str(), mPattern.size(),
+									  mHasFirstChars ? mFirstChars : nullptr, (LuaMatch*)matchList );
 	} catch ( const std::string& patternError ) {
 		mErr = std::move( patternError );
 		mMatchNum = 0;
@@ -76,6 +84,32 @@ bool LuaPattern::matches( const char* stringSearch, int stringStartOffset,
 	return mMatchNum == 0 ? false : true;
 }
 
+size_t LuaPattern::getMatches( const char* stringSearch, int stringStartOffset,
+							   LuaPattern::Range* matchList, size_t stringLength ) const {
+	if ( stringLength == 0 )
+		stringLength = strlen( stringSearch );
+	try {
+		return lua_str_match_ex( stringSearch, stringStartOffset, stringLength, mPattern.c_str(),
+								 mPattern.size(), mHasFirstChars ? mFirstChars : nullptr,
+								 (LuaMatch*)matchList );
+	} catch ( const std::string& ) {
+		return 0;
+	}
+}
+
+size_t LuaPattern::getMatchesUnfiltered( const char* stringSearch, int stringStartOffset,
+										 LuaPattern::Range* matchList,
+										 size_t stringLength ) const {
+	if ( stringLength == 0 )
+		stringLength = strlen( stringSearch );
+	try {
+		return lua_str_match_ex( stringSearch, stringStartOffset, stringLength, mPattern.c_str(),
+								 mPattern.size(), nullptr, (LuaMatch*)matchList );
+	} catch ( const std::string& ) {
+		return 0;
+	}
+}
+
 bool LuaPattern::matches( const std::string& str, LuaPattern::Range* matchList,
 						  int stringStartOffset ) const {
 	return matches( str.c_str(), stringStartOffset, matchList, str.size() );
@@ -3,6 +3,50 @@
 
 namespace EE { namespace System {
 
+static thread_local ThreadPool* sCurrentPool = nullptr;
+static thread_local size_t sCurrentWorker = 0;
+
+ThreadPool::WaitGroup::WaitGroup() : mState( std::make_shared<State>() ) {}
+
+void ThreadPool::WaitGroup::add( Uint64 count ) {
+	std::unique_lock<std::mutex> lock( mState->mutex );
+	mState->count += count;
+}
+
+void ThreadPool::WaitGroup::done() {
+	std::unique_lock<std::mutex> lock( mState->mutex );
+	if ( mState->count > 0 && --mState->count == 0 )
+		mState->condition.notify_all();
+}
+
+bool ThreadPool::WaitGroup::isDone() const {
+	std::unique_lock<std::mutex> lock( mState->mutex );
+	return mState->count == 0;
+}
+
+void ThreadPool::WaitGroup::wait() {
+	std::unique_lock<std::mutex> lock( mState->mutex );
+	mState->condition.wait( lock, [this]() { return mState->count == 0; } );
+}
+
+bool ThreadPool::WaitGroup::runTask( State& state ) {
+	std::function<void()> task;
+	{
+		std::unique_lock<std::mutex> lock( state.mutex );
+		if ( state.tasks.empty() )
+			return false;
+		task = std::move( state.tasks.front() );
+		state.tasks.pop_front();
+	}
+
+	task();
+
+	std::unique_lock<std::mutex> lock( state.mutex );
+	if ( state.count > 0 && --state.count == 0 )
+		state.condition.notify_all();
+	return true;
+}
+
 std::shared_ptr<ThreadPool> ThreadPool::createShared( Uint32 numThreads, bool terminateOnClose ) {
 	std::shared_ptr<ThreadPool> pool( new ThreadPool( numThreads, terminateOnClose ) );
 	return pool;
@@ -19,8 +63,12 @@ ThreadPool* ThreadPool::createRaw( Uint32 numThreads, bool terminateOnClose ) {
 
 ThreadPool::ThreadPool( Uint32 numThreads, bool terminateOnClose ) :
 	mTerminateOnClose( terminateOnClose ) {
+	// Keep at least one queue so tasks can be queued even without threads
+	for ( Uint32 i = 0; i < std::max<Uint32>( 1, numThreads ); ++i )
+		mWorkers.emplace_back( std::make_unique<Worker>() );
+
 	for ( Uint32 i = 0; i < numThreads; ++i ) {
-		mThreads.emplace_back( std::make_unique<Thread>( &ThreadPool::threadFunc, this ) );
+		mThreads.emplace_back( std::make_unique<Thread>( [this, i]() { threadFunc( i ); } ) );
 		mThreads.back().get()->launch();
 	}
 }
@@ -42,26 +90,61 @@ ThreadPool::~ThreadPool() {
 	}
 }
 
-void ThreadPool::threadFunc() {
-	while ( true ) {
-		std::unique_ptr<Work> work;
-		{
-			std::unique_lock<std::mutex> lock( mMutex );
-
-			mWorkAvailable.wait( lock, [this]() { return !mWork.empty() || mShuttingDown; } );
+bool ThreadPool::popWork( size_t index, Work& work ) {
+	size_t count = mWorkers.size();
 
-			if ( mShuttingDown && mWork.empty() ) {
-				return;
+	for ( size_t priority = 0; priority < PriorityCount; ++priority ) {
+		// The owner consumes its queue in order, thieves take from the back
+		for ( size_t i = 0; i < count; ++i ) {
+			Worker& worker = *mWorkers[( index + i ) % count];
+			std::unique_lock<std::mutex> lock( worker.mutex );
+			auto& queue = worker.queues[priority];
+			if ( queue.empty() )
+				continue;
+			if ( i == 0 ) {
+				work = std::move( queue.front() );
+				queue.pop_front();
+			} else {
+				work = std::move( queue.back() );
+				queue.pop_back();
 			}
+			--mPendingWork;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::runWork( Work& work ) {
+	work.func();
+
+	if ( work.callback != nullptr ) {
+		work.callback( work.id );
+	}
+}
+
+void ThreadPool::threadFunc( size_t index ) {
+	sCurrentPool = this;
+	sCurrentWorker = index;
 
-			work = std::move( mWork.front() );
-			mWork.pop_front();
+	Work work;
+
+	while ( true ) {
+		if ( popWork( index, work ) ) {
+			runWork( work );
+			work = {};
+			continue;
 		}
 
-		work->func();
+		std::unique_lock<std::mutex> lock( mMutex );
 
-		if ( work->callback != nullptr ) {
-			work->callback( work->id );
+		++mSleepingThreads;
+		mWorkAvailable.wait( lock, [this]() { return mPendingWork > 0 || mShuttingDown; } );
+		--mSleepingThreads;
+
+		if ( mShuttingDown && mPendingWork == 0 ) {
+			return;
 		}
 	}
 }
@@ -75,61 +158,183 @@ void ThreadPool::setTerminateOnClose( bool terminateOnClose ) {
 }
 
 bool ThreadPool::existsIdInQueue( const Uint64& id ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	return std::any_of( mWork.begin(), mWork.end(),
-						[id]( const std::unique_ptr<Work>& work ) { return work->id == id; } );
+	for ( auto& worker : mWorkers ) {
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		for ( const auto& queue : worker->queues ) {
+			if ( std::any_of( queue.begin(), queue.end(),
+							  [id]( const Work& work ) { return work.id == id; } ) )
+				return true;
+		}
+	}
+	return false;
 }
 
 bool ThreadPool::existsTagInQueue( const Uint64& tag ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	return std::any_of( mWork.begin(), mWork.end(),
-						[tag]( const std::unique_ptr<Work>& work ) { return work->tag == tag; } );
+	for ( auto& worker : mWorkers ) {
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		for ( const auto& queue : worker->queues ) {
+			if ( std::any_of( queue.begin(), queue.end(),
+							  [tag]( const Work& work ) { return work.tag == tag; } ) )
+				return true;
+		}
+	}
+	return false;
 }
 
 bool ThreadPool::removeId( const Uint64& id ) {
-	std::unique_lock<std::mutex> lock( mMutex );
-	for ( auto it = mWork.begin(); it != mWork.end(); ++it ) {
-		if ( it->get()->id == id ) {
-			mWork.erase( it );
-			return true;
+	for ( auto& worker : mWorkers ) {
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		for ( auto& queue : worker->queues ) {
+			for ( auto it = queue.begin(); it != queue.end(); ++it ) {
+				if ( it->id == id ) {
+					queue.erase( it );
+					--mPendingWork;
+					return true;
+				}
+			}
 		}
 	}
 	return false;
 }
 
 bool ThreadPool::removeWithTag( const Uint64& tag ) {
-	std::vector<Uint64> ids;
-	{
-		std::unique_lock<std::mutex> lock( mMutex );
-		for ( const auto& work : mWork )
-			if ( work->tag == tag )
-				ids.emplace_back( work->id );
+	bool removed = false;
+	for ( auto& worker : mWorkers ) {
+		std::unique_lock<std::mutex> lock( worker->mutex );
+		for ( auto& queue : worker->queues ) {
+			for ( auto it = queue.begin(); it != queue.end(); ) {
+				if ( it->tag == tag ) {
+					it = queue.erase( it );
+					--mPendingWork;
+					removed = true;
+				} else {
+					++it;
+				}
+			}
+		}
 	}
-	for ( const auto& id : ids )
-		removeId( id );
-	return !ids.empty();
+	return removed;
 }
 
 Uint64 ThreadPool::run( const std::function<void()>& func,
 						const std::function<void( const Uint64& )>& doneCallback,
 						const Uint64& tag ) {
+	return run( func, Priority::Interactive, doneCallback, tag );
+}
+
+Uint64 ThreadPool::run( const std::function<void()>& func, Priority priority,
+						const std::function<void( const Uint64& )>& doneCallback,
+						const Uint64& tag ) {
 	Uint64 id = ++mLastWorkId;
-	{
-		std::unique_lock<std::mutex> lock( mMutex );
 
-		if ( mShuttingDown )
-			return id;
+	if ( mShuttingDown )
+		return id;
+
+	size_t index =
+		sCurrentPool == this ? sCurrentWorker : mNextWorker.fetch_add( 1 ) % mWorkers.size();
+
+	// Counted before the work is visible, a worker could pop it and decrement the counter before
+	// it's incremented otherwise.
+	++mPendingWork;
 
-		mWork.emplace_back( new Work{ id, func, doneCallback, tag } );
+	{
+		Worker& worker = *mWorkers[index];
+		std::unique_lock<std::mutex> lock( worker.mutex );
+		worker.queues[static_cast<size_t>( priority )].push_back(
+			Work{ id, func, doneCallback, tag } );
 	}
 
-	mWorkAvailable.notify_one();
+	// A thread going to sleep increments the counter before checking for pending work, so either
+	// it sees the new work or we see it sleeping.
+	if ( mSleepingThreads > 0 ) {
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+		}
+		mWorkAvailable.notify_one();
+	}
 
 	return id;
 }
 
+Uint64 ThreadPool::run( const std::function<void()>& func, WaitGroup& waitGroup,
+						Priority priority ) {
+	// The task is kept by the group, so the waiting thread can run it. The pool only gets a task
+	// that runs the next pending task of the group, if any.
+	std::shared_ptr<WaitGroup::State> state( waitGroup.mState );
+	{
+		std::unique_lock<std::mutex> lock( state->mutex );
+		state->count++;
+		state->tasks.push_back( func );
+	}
+	state->condition.notify_all();
+	return run( [state]() { WaitGroup::runTask( *state ); }, priority );
+}
+
+void ThreadPool::wait( WaitGroup& waitGroup ) {
+	WaitGroup::State& state = *waitGroup.mState;
+
+	// Only the tasks of the group are run here, running any other task could re-enter the caller
+	// while it holds its own locks.
+	while ( true ) {
+		if ( WaitGroup::runTask( state ) )
+			continue;
+
+		std::unique_lock<std::mutex> lock( state.mutex );
+		state.condition.wait(
+			lock, [&state]() { return state.count == 0 || !state.tasks.empty(); } );
+		if ( state.count == 0 )
+			return;
+	}
+}
+
+void ThreadPool::parallelFor( Int64 begin, Int64 end,
+							  const std::function<void( Int64, Int64 )>& func, Int64 grainSize,
+							  Priority priority ) {
+	if ( begin >= end )
+		return;
+
+	Int64 count = end - begin;
+	Int64 threads = static_cast<Int64>( mThreads.size() );
+	// A few chunks per thread so faster threads can take more of them
+	Int64 targetChunks = ( threads + 1 ) * 4;
+	Int64 chunkSize = std::max<Int64>( std::max<Int64>( 1, grainSize ),
+									   ( count + targetChunks - 1 ) / targetChunks );
+	Int64 chunks = ( count + chunkSize - 1 ) / chunkSize;
+
+	if ( threads == 0 || chunks == 1 ) {
+		func( begin, end );
+		return;
+	}
+
+	struct ParallelForState {
+		std::atomic<Int64> next{ 0 };
+		WaitGroup chunksDone;
+	};
+
+	// Helpers can start after every chunk was processed, they only touch the shared state then.
+	auto state = std::make_shared<ParallelForState>();
+	state->chunksDone.add( chunks );
+
+	const std::function<void( Int64, Int64 )>* funcPtr = &func;
+	auto process = [state, funcPtr, begin, end, chunkSize, chunks]() {
+		Int64 chunk;
+		while ( ( chunk = state->next++ ) < chunks ) {
+			Int64 chunkBegin = begin + chunk * chunkSize;
+			( *funcPtr )( chunkBegin, std::min( end, chunkBegin + chunkSize ) );
+			state->chunksDone.done();
+		}
+	};
+
+	Int64 helpers = std::min( threads, chunks - 1 );
+	for ( Int64 i = 0; i < helpers; ++i )
+		run( process, priority );
+
+	process();
+
+	wait( state->chunksDone );
+}
+
 Uint32 ThreadPool::numThreads() const {
-	std::unique_lock<std::mutex> lock( mMutex );
 	return mShuttingDown ? 0 : static_cast<Uint32>( mThreads.size() );
 }
 
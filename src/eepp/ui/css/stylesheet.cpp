@@ -24,8 +24,16 @@ size_t StyleSheet::nodeHash( const std::string& tag, const std::string& id ) {
 	return seed;
 }
 
+size_t StyleSheet::classNodeHash( const std::string& cls ) {
+	size_t seed = std::hash<std::string>()( cls );
+	HashCombine( seed, '.' );
+	return seed;
+}
+
 void StyleSheet::invalidateCache() {
 	mNodeCache.clear();
+	mStyleSharingCache.clear();
+	mStyleSharingCacheNext = 0;
 }
 
 const Uint32& StyleSheet::getMarker() const {
@@ -73,6 +81,9 @@ void StyleSheet::removeAllWithMarker( const Uint32& marker ) {
 	for ( auto removeIndex : deprecatedNodeIndex )
 		mNodeIndex.erase( removeIndex );
 
+	for ( auto& node : removeNodes )
+		mNodeOrder.erase( node.get() );
+
 	std::vector<MediaQueryList::ptr> removeMediaQueries;
 	for ( auto& mediaQueryList : mMediaQueryList ) {
 		if ( mediaQueryList->getMarker() == marker )
@@ -132,15 +143,25 @@ bool StyleSheet::refreshCacheFromStyles(
 	return refreshed;
 }
 
+StyleSheetSelectorFilter& StyleSheet::getSelectorFilter() const {
+	return mSelectorFilter;
+}
+
 bool StyleSheet::addStyleToNodeIndex( StyleSheetStyle* style ) {
 	const std::string& id = style->getSelector().getSelectorId();
 	const std::string& tag = style->getSelector().getSelectorTagName();
+	const std::string& cls = style->getSelector().getSelectorFirstClass();
 	if ( style->hasProperties() || style->hasVariables() ) {
-		size_t nodeHash = this->nodeHash( "*" == tag ? "" : tag, id );
+		// Rules without tag and id are indexed by its first class, every element that matches
+		// them must have it. A global tag matches any element, those must be always evaluated.
+		size_t nodeHash = tag.empty() && id.empty() && !cls.empty()
+							  ? classNodeHash( cls )
+							  : this->nodeHash( "*" == tag ? "" : tag, id );
 		StyleSheetStyleVector& nodes = mNodeIndex[nodeHash];
 		auto it = std::find( nodes.begin(), nodes.end(), style );
 		if ( it == nodes.end() ) {
 			nodes.push_back( style );
+			mNodeOrder[style] = mNextNodeOrder++;
 			return true;
 		} else {
 			Log::debug( "Ignored style %s", style->getSelector().getName().c_str() );
@@ -152,6 +173,8 @@ bool StyleSheet::addStyleToNodeIndex( StyleSheetStyle* style ) {
 void StyleSheet::addStyle( std::shared_ptr<StyleSheetStyle> node ) {
 	if ( addStyleToNodeIndex( node.get() ) ) {
 		mNodes.push_back( node );
+		mStyleSharingCache.clear();
+		mStyleSharingCacheNext = 0;
 	}
 	addMediaQueryList( node->getMediaQueryList() );
 }
@@ -189,62 +212,146 @@ void StyleSheet::combineStyleSheet( const StyleSheet& styleSheet ) {
 	addKeyframes( styleSheet.getKeyframes() );
 }
 
-inline static bool StyleSheetNodeSort( const StyleSheetStyle* lhs, const StyleSheetStyle* rhs ) {
-	return lhs->getSelector().getSpecificity() < rhs->getSelector().getSpecificity();
+inline static bool StyleSheetNodeSort( const std::pair<Uint32, StyleSheetStyle*>& lhs,
+									   const std::pair<Uint32, StyleSheetStyle*>& rhs ) {
+	Uint32 lhsSpecificity = lhs.second->getSelector().getSpecificity();
+	Uint32 rhsSpecificity = rhs.second->getSelector().getSpecificity();
+	return lhsSpecificity < rhsSpecificity ||
+		   ( lhsSpecificity == rhsSpecificity && lhs.first < rhs.first );
 }
 
 // This is based on the RmlUi implementation.
 std::shared_ptr<ElementDefinition> StyleSheet::getElementStyles( UIWidget* element,
 																 const bool& applyPseudo ) const {
+	static std::vector<std::pair<Uint32, StyleSheetStyle*>> applicableOrder;
 	static StyleSheetStyleVector applicableNodes;
+	static std::vector<size_t> nodeHashes;
+	applicableOrder.clear();
 	applicableNodes.clear();
+	nodeHashes.clear();
 
 	const std::string& tag = element->getElementTag();
 	const std::string& id = element->getId();
 
-	std::array<size_t, 4> nodeHash;
-	int numHashes = 2;
-
-	nodeHash[0] = 0;
-	nodeHash[1] = this->nodeHash( tag, "" );
+	nodeHashes.push_back( 0 );
+	nodeHashes.push_back( this->nodeHash( tag, "" ) );
 
 	if ( !id.empty() ) {
-		numHashes = 4;
-		nodeHash[2] = this->nodeHash( "", id );
-		nodeHash[3] = this->nodeHash( tag, id );
+		nodeHashes.push_back( this->nodeHash( "", id ) );
+		nodeHashes.push_back( this->nodeHash( tag, id ) );
 	}
 
-	for ( int i = 0; i < numHashes; i++ ) {
-		auto itNodes = mNodeIndex.find( nodeHash[i] );
-		if ( itNodes != mNodeIndex.end() ) {
-			const StyleSheetStyleVector& nodes = itNodes->second;
-			for ( StyleSheetStyle* node : nodes ) {
-				if ( node->isMediaValid() && node->getSelector().select( element, applyPseudo ) ) {
-					applicableNodes.push_back( node );
-				}
+	for ( const auto& cls : element->getStyleSheetClasses() )
+		nodeHashes.push_back( classNodeHash( cls ) );
+
+	const bool useFilter = mSelectorFilter.isValidFor( element );
+
+	auto matchNode = [&]( StyleSheetStyle* node ) {
+		return node->isMediaValid() &&
+			   ( !useFilter ||
+				 !mSelectorFilter.fastRejectSelector( node->getSelector().getAncestorHashes() ) ) &&
+			   node->getSelector().select( element, applyPseudo );
+	};
+
+	auto forEachNode = [&]( auto callback ) {
+		for ( size_t i = 0; i < nodeHashes.size(); i++ ) {
+			if ( std::find( nodeHashes.begin(), nodeHashes.begin() + i, nodeHashes[i] ) !=
+				 nodeHashes.begin() + i )
+				continue;
+
+			auto itNodes = mNodeIndex.find( nodeHashes[i] );
+			if ( itNodes != mNodeIndex.end() ) {
+				for ( StyleSheetStyle* node : itNodes->second )
+					callback( node );
+			}
+		}
+	};
+
+	static std::vector<bool> siblingDependentResults;
+	siblingDependentResults.clear();
+
+	// While restyling a tree a sibling with the same tag, id, classes and state matches the same
+	// styles, except the sibling dependent ones that must be evaluated for every element.
+	if ( useFilter ) {
+		bool evaluated = false;
+		for ( const auto& shared : mStyleSharingCache ) {
+			if ( !isSharedStyleCandidate( shared, element, applyPseudo ) )
+				continue;
+
+			if ( !evaluated ) {
+				forEachNode( [&]( StyleSheetStyle* node ) {
+					if ( node->getSelector().isSiblingDependent() )
+						siblingDependentResults.push_back( matchNode( node ) );
+				} );
+				evaluated = true;
 			}
+
+			if ( shared.siblingDependentResults == siblingDependentResults )
+				return shared.definition;
 		}
+		siblingDependentResults.clear();
 	}
 
-	std::sort( applicableNodes.begin(), applicableNodes.end(), StyleSheetNodeSort );
+	forEachNode( [&]( StyleSheetStyle* node ) {
+		bool matches = matchNode( node );
 
-	if ( applicableNodes.empty() )
-		return nullptr;
+		if ( node->getSelector().isSiblingDependent() )
+			siblingDependentResults.push_back( matches );
 
-	size_t seed = 0;
-	for ( const StyleSheetStyle* node : applicableNodes )
-		HashCombine( seed, node );
+		if ( matches ) {
+			auto order = mNodeOrder.find( node );
+			applicableOrder.emplace_back( order != mNodeOrder.end() ? order->second : 0, node );
+		}
+	} );
+
+	std::sort( applicableOrder.begin(), applicableOrder.end(), StyleSheetNodeSort );
+
+	for ( const auto& node : applicableOrder )
+		applicableNodes.push_back( node.second );
+
+	std::shared_ptr<ElementDefinition> definition;
 
-	auto cacheIterator = mNodeCache.find( seed );
-	if ( cacheIterator != mNodeCache.end() ) {
-		std::shared_ptr<ElementDefinition>& definition = ( *cacheIterator ).second;
-		return definition;
+	if ( !applicableNodes.empty() ) {
+		size_t seed = 0;
+		for ( const StyleSheetStyle* node : applicableNodes )
+			HashCombine( seed, node );
+
+		auto cacheIterator = mNodeCache.find( seed );
+		if ( cacheIterator != mNodeCache.end() ) {
+			definition = ( *cacheIterator ).second;
+		} else {
+			definition = std::make_shared<ElementDefinition>( applicableNodes );
+			mNodeCache[seed] = definition;
+		}
 	}
 
-	auto newDefinition = std::make_shared<ElementDefinition>( applicableNodes );
-	mNodeCache[seed] = newDefinition;
+	if ( useFilter ) {
+		if ( mStyleSharingCache.size() < StyleSharingCacheSize )
+			mStyleSharingCache.emplace_back();
+
+		SharedStyle& shared = mStyleSharingCache[mStyleSharingCacheNext];
+		mStyleSharingCacheNext = ( mStyleSharingCacheNext + 1 ) % StyleSharingCacheSize;
+		shared.generation = mSelectorFilter.getGeneration();
+		shared.parent = element->getStyleSheetParentElement();
+		shared.applyPseudo = applyPseudo;
+		shared.tag = tag;
+		shared.id = id;
+		shared.classes = element->getStyleSheetClasses();
+		shared.pseudoClasses = element->getStyleSheetPseudoClasses();
+		shared.siblingDependentResults = siblingDependentResults;
+		shared.definition = definition;
+	}
+
+	return definition;
+}
 
-	return newDefinition;
+bool StyleSheet::isSharedStyleCandidate( const SharedStyle& shared, UIWidget* element,
+										 const bool& applyPseudo ) const {
+	return shared.generation == mSelectorFilter.getGeneration() &&
+		   shared.parent == element->getStyleSheetParentElement() &&
+		   shared.applyPseudo == applyPseudo && shared.tag == element->getElementTag() &&
+		   shared.id == element->getId() && shared.classes == element->getStyleSheetClasses() &&
+		   ( !applyPseudo || shared.pseudoClasses == element->getStyleSheetPseudoClasses() );
 }
 
 const std::vector<std::shared_ptr<StyleSheetStyle>>& StyleSheet::getStyles() const {
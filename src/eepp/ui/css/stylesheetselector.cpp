@@ -1,4 +1,5 @@
 #include <eepp/ui/css/stylesheetselector.hpp>
+#include <eepp/ui/css/stylesheetselectorfilter.hpp>
 #include <eepp/ui/uiwidget.hpp>
 
 namespace EE { namespace UI { namespace CSS {
@@ -101,6 +102,37 @@ void StyleSheetSelector::parseSelector( std::string selector ) {
 				}
 			}
 		}
+
+		mSiblingDependent = mStructurallyVolatile;
+
+		for ( size_t i = 1; i < mSelectorRules.size(); i++ ) {
+			if ( mSelectorRules[i].getPatternMatch() == StyleSheetSelectorRule::DIRECT_SIBLING ||
+				 mSelectorRules[i].getPatternMatch() == StyleSheetSelectorRule::SIBLING ) {
+				mSiblingDependent = true;
+				break;
+			}
+		}
+
+		// Siblings share the parent chain, so every rule reached through a descendant or child
+		// combinator must match an ancestor of the element. A global tag matches any element.
+		for ( size_t i = 1; i < mSelectorRules.size(); i++ ) {
+			const StyleSheetSelectorRule& rule = mSelectorRules[i];
+
+			if ( ( rule.getPatternMatch() != StyleSheetSelectorRule::DESCENDANT &&
+				   rule.getPatternMatch() != StyleSheetSelectorRule::CHILD ) ||
+				 rule.getTagName() == "*" )
+				continue;
+
+			if ( !rule.getTagName().empty() )
+				mAncestorHashes.push_back(
+					StyleSheetSelectorFilter::tagHash( rule.getTagName() ) );
+
+			if ( !rule.getId().empty() )
+				mAncestorHashes.push_back( StyleSheetSelectorFilter::idHash( rule.getId() ) );
+
+			for ( const auto& cls : rule.getClasses() )
+				mAncestorHashes.push_back( StyleSheetSelectorFilter::classHash( cls ) );
+		}
 	}
 }
 
@@ -309,6 +341,10 @@ const bool& StyleSheetSelector::isStructurallyVolatile() const {
 	return mStructurallyVolatile;
 }
 
+const bool& StyleSheetSelector::isSiblingDependent() const {
+	return mSiblingDependent;
+}
+
 const StyleSheetSelectorRule& StyleSheetSelector::getRule( const Uint32& index ) {
 	return mSelectorRules[index];
 }
@@ -321,4 +357,14 @@ const std::string& StyleSheetSelector::getSelectorTagName() const {
 	return mSelectorRules[0].getTagName();
 }
 
+const std::string& StyleSheetSelector::getSelectorFirstClass() const {
+	static std::string EMPTY;
+	const std::vector<std::string>& classes = mSelectorRules[0].getClasses();
+	return classes.empty() ? EMPTY : classes[0];
+}
+
+const std::vector<Uint32>& StyleSheetSelector::getAncestorHashes() const {
+	return mAncestorHashes;
+}
+
 }}} // namespace EE::UI::CSS
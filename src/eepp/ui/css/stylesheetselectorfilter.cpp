@@ -0,0 +1,120 @@
+#include <eepp/ui/css/stylesheetselectorfilter.hpp>
+#include <eepp/ui/uiwidget.hpp>
+
+namespace EE { namespace UI { namespace CSS {
+
+// Salts the identifier hashes so a tag, an id and a class with the same name don't collide.
+static constexpr Uint32 TagHashSalt = 13;
+static constexpr Uint32 IdHashSalt = 17;
+static constexpr Uint32 ClassHashSalt = 19;
+
+Uint32 StyleSheetSelectorFilter::tagHash( const std::string& tag ) {
+	return String::hash( tag ) * TagHashSalt;
+}
+
+Uint32 StyleSheetSelectorFilter::idHash( const std::string& id ) {
+	return String::hash( id ) * IdHashSalt;
+}
+
+Uint32 StyleSheetSelectorFilter::classHash( const std::string& cls ) {
+	return String::hash( cls ) * ClassHashSalt;
+}
+
+void StyleSheetSelectorFilter::setupParentStack( UIWidget* parent ) {
+	clear();
+
+	std::vector<UIWidget*> parents;
+	for ( UIWidget* cur = parent; NULL != cur; cur = cur->getStyleSheetParentElement() )
+		parents.push_back( cur );
+
+	for ( auto it = parents.rbegin(); it != parents.rend(); ++it )
+		pushParent( *it );
+}
+
+void StyleSheetSelectorFilter::pushParent( UIWidget* parent ) {
+	size_t hashesCount = mHashes.size();
+
+	mHashes.push_back( tagHash( parent->getElementTag() ) );
+
+	if ( !parent->getId().empty() )
+		mHashes.push_back( idHash( parent->getId() ) );
+
+	for ( const auto& cls : parent->getStyleSheetClasses() )
+		mHashes.push_back( classHash( cls ) );
+
+	for ( size_t i = hashesCount; i < mHashes.size(); i++ )
+		add( mHashes[i] );
+
+	mParentStack.push_back( { parent, hashesCount } );
+}
+
+void StyleSheetSelectorFilter::popParent() {
+	if ( mParentStack.empty() )
+		return;
+
+	size_t hashesCount = mParentStack.back().hashesCount;
+
+	for ( size_t i = hashesCount; i < mHashes.size(); i++ )
+		remove( mHashes[i] );
+
+	mHashes.resize( hashesCount );
+	mParentStack.pop_back();
+}
+
+void StyleSheetSelectorFilter::clear() {
+	mGeneration++;
+	mParentStack.clear();
+	mHashes.clear();
+	mCounters.fill( 0 );
+}
+
+bool StyleSheetSelectorFilter::isEmpty() const {
+	return mParentStack.empty();
+}
+
+UIWidget* StyleSheetSelectorFilter::getParent() const {
+	return mParentStack.empty() ? NULL : mParentStack.back().parent;
+}
+
+const Uint32& StyleSheetSelectorFilter::getGeneration() const {
+	return mGeneration;
+}
+
+bool StyleSheetSelectorFilter::isValidFor( UIWidget* element ) const {
+	return !mParentStack.empty() &&
+		   mParentStack.back().parent == element->getStyleSheetParentElement();
+}
+
+bool StyleSheetSelectorFilter::fastRejectSelector(
+	const std::vector<Uint32>& ancestorHashes ) const {
+	for ( const auto& hash : ancestorHashes ) {
+		if ( !mayContain( hash ) )
+			return true;
+	}
+	return false;
+}
+
+void StyleSheetSelectorFilter::add( const Uint32& hash ) {
+	Uint8& first = mCounters[hash & KeyMask];
+	if ( first != MaxCount )
+		++first;
+	Uint8& second = mCounters[( hash >> KeyBits ) & KeyMask];
+	if ( second != MaxCount )
+		++second;
+}
+
+void StyleSheetSelectorFilter::remove( const Uint32& hash ) {
+	// Saturated counters can't know how many times they were incremented, they are kept.
+	Uint8& first = mCounters[hash & KeyMask];
+	if ( first != MaxCount )
+		--first;
+	Uint8& second = mCounters[( hash >> KeyBits ) & KeyMask];
+	if ( second != MaxCount )
+		--second;
+}
+
+bool StyleSheetSelectorFilter::mayContain( const Uint32& hash ) const {
+	return mCounters[hash & KeyMask] != 0 && mCounters[( hash >> KeyBits ) & KeyMask] != 0;
+}
+
+}}} // namespace EE::UI::CSS
@@ -221,17 +221,33 @@ const SyntaxColorScheme::Style& SyntaxColorScheme::getSyntaxStyle( const std::st
 	return StyleEmpty;
 }
 
+const SyntaxColorScheme::Style&
+SyntaxColorScheme::getSyntaxStyle( const SyntaxStyleType& type ) const {
+	auto it = mStyleTypeCache.find( type );
+	if ( it != mStyleTypeCache.end() )
+		return it->second;
+	return mStyleTypeCache[type] = getSyntaxStyle( SyntaxStyleTypes::toString( type ) );
+}
+
 bool SyntaxColorScheme::hasSyntaxStyle( const std::string& type ) const {
 	return mSyntaxColors.find( type ) != mSyntaxColors.end();
 }
 
+bool SyntaxColorScheme::hasSyntaxStyle( const SyntaxStyleType& type ) const {
+	return hasSyntaxStyle( SyntaxStyleTypes::toString( type ) );
+}
+
 void SyntaxColorScheme::setSyntaxStyles( const std::unordered_map<std::string, Style>& styles ) {
 	mSyntaxColors.insert( styles.begin(), styles.end() );
+	mStyleCache.clear();
+	mStyleTypeCache.clear();
 }
 
 void SyntaxColorScheme::setSyntaxStyle( const std::string& type,
 										const SyntaxColorScheme::Style& style ) {
 	mSyntaxColors[type] = style;
+	mStyleCache.clear();
+	mStyleTypeCache.clear();
 }
 
 const SyntaxColorScheme::Style&
@@ -1,10 +1,27 @@
+#include <atomic>
 #include <eepp/core/memorymanager.hpp>
 #include <eepp/core/string.hpp>
 #include <eepp/ui/doc/syntaxdefinition.hpp>
 
 namespace EE { namespace UI { namespace Doc {
 
-SyntaxDefinition::SyntaxDefinition() {}
+void SyntaxPattern::compile() {
+	if ( patterns.empty() )
+		return;
+	matchers.reserve( patterns.size() >= 2 ? 3 : 1 );
+	matchers.emplace_back( patterns[0][0] == '^' ? patterns[0] : "^" + patterns[0] );
+	if ( patterns.size() >= 2 ) {
+		matchers.emplace_back( patterns[1] );
+		matchers.emplace_back( "^" + patterns[1] );
+	}
+}
+
+static Uint64 nextGeneration() {
+	static std::atomic<Uint64> generation{ 0 };
+	return ++generation;
+}
+
+SyntaxDefinition::SyntaxDefinition() : mGeneration( nextGeneration() ) {}
 
 SyntaxDefinition::SyntaxDefinition( const std::string& languageName,
 									const std::vector<std::string>& files,
@@ -17,10 +34,13 @@ SyntaxDefinition::SyntaxDefinition( const std::string& languageName,
 	mLanguageId( String::hash( String::toLower( languageName ) ) ),
 	mFiles( files ),
 	mPatterns( patterns ),
-	mSymbols( symbols ),
 	mComment( comment ),
 	mHeaders( headers ),
-	mLSPName( lspName.empty() ? String::toLower( mLanguageName ) : lspName ) {}
+	mLSPName( lspName.empty() ? String::toLower( mLanguageName ) : lspName ),
+	mGeneration( nextGeneration() ) {
+	for ( const auto& symbol : symbols )
+		addSymbol( symbol.first, symbol.second );
+}
 
 const std::vector<std::string>& SyntaxDefinition::getFiles() const {
 	return mFiles;
@@ -40,7 +60,7 @@ std::string SyntaxDefinition::getFileExtension() const {
 std::vector<SyntaxPattern> SyntaxDefinition::getPatternsOfType( const std::string& type ) const {
 	std::vector<SyntaxPattern> patterns;
 	for ( const auto& pattern : mPatterns ) {
-		if ( pattern.types.size() == 1 && pattern.types[0] == type )
+		if ( pattern.types.size() == 1 && pattern.types[0] == String::hash( type ) )
 			patterns.emplace_back( pattern );
 	}
 	return patterns;
@@ -54,15 +74,15 @@ const std::string& SyntaxDefinition::getComment() const {
 	return mComment;
 }
 
-const std::unordered_map<std::string, std::string>& SyntaxDefinition::getSymbols() const {
+const std::unordered_map<std::string, SyntaxStyleType>& SyntaxDefinition::getSymbols() const {
 	return mSymbols;
 }
 
-std::string SyntaxDefinition::getSymbol( const std::string& symbol ) const {
+SyntaxStyleType SyntaxDefinition::getSymbol( const std::string& symbol ) const {
 	auto it = mSymbols.find( symbol );
 	if ( it != mSymbols.end() )
 		return it->second;
-	return "";
+	return SyntaxStyleTypes::None;
 }
 
 SyntaxDefinition& SyntaxDefinition::addFileType( const std::string& fileType ) {
@@ -72,6 +92,7 @@ SyntaxDefinition& SyntaxDefinition::addFileType( const std::string& fileType ) {
 
 SyntaxDefinition& SyntaxDefinition::addPattern( const SyntaxPattern& pattern ) {
 	mPatterns.push_back( pattern );
+	mGeneration = nextGeneration();
 	return *this;
 }
 
@@ -81,12 +102,14 @@ SyntaxDefinition& SyntaxDefinition::addPatternToFront( const SyntaxPattern& patt
 	mPatterns.push_back( pattern );
 	for ( const auto& pa : patterns )
 		mPatterns.push_back( pa );
+	mGeneration = nextGeneration();
 	return *this;
 }
 
 SyntaxDefinition& SyntaxDefinition::addSymbol( const std::string& symbolName,
 											   const std::string& typeName ) {
-	mSymbols[symbolName] = typeName;
+	mSymbols[symbolName] = SyntaxStyleTypes::fromString( typeName );
+	mGeneration = nextGeneration();
 	return *this;
 }
 
@@ -114,10 +137,16 @@ SyntaxDefinition& SyntaxDefinition::setHeaders( const std::vector<std::string>&
 
 void SyntaxDefinition::clearPatterns() {
 	mPatterns.clear();
+	mGeneration = nextGeneration();
 }
 
 void SyntaxDefinition::clearSymbols() {
 	mSymbols.clear();
+	mGeneration = nextGeneration();
+}
+
+const Uint64& SyntaxDefinition::getGeneration() const {
+	return mGeneration;
 }
 
 const std::string& SyntaxDefinition::getLSPName() const {
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/lock.hpp>
 #include <eepp/system/iostreammemory.hpp>
 #include <eepp/system/luapattern.hpp>
 #include <eepp/system/packmanager.hpp>
@@ -13,6 +14,7 @@
 #include <eepp/ui/doc/languages/x86assembly.hpp>
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/uiwidgetcreator.hpp>
+#include <limits>
 #include <nlohmann/json.hpp>
 
 using namespace EE::System;
@@ -4203,10 +4205,10 @@ static json toJson( const SyntaxDefinition& def ) {
 			} else {
 				pattern["pattern"] = ptrn.patterns;
 			}
-			if ( ptrn.types.size() == 1 ) {
-				pattern["type"] = ptrn.types[0];
+			if ( ptrn.typesNames.size() == 1 ) {
+				pattern["type"] = ptrn.typesNames[0];
 			} else {
-				pattern["type"] = ptrn.types;
+				pattern["type"] = ptrn.typesNames;
 			}
 			if ( !ptrn.syntax.empty() )
 				pattern["syntax"] = ptrn.syntax;
@@ -4216,7 +4218,8 @@ static json toJson( const SyntaxDefinition& def ) {
 	if ( !def.getSymbols().empty() ) {
 		j["symbols"] = json::array();
 		for ( const auto& sym : def.getSymbols() )
-			j["symbols"].emplace_back( json{ json{ sym.first, sym.second } } );
+			j["symbols"].emplace_back(
+				json{ json{ sym.first, SyntaxStyleTypes::toString( sym.second ) } } );
 	}
 
 	if ( !def.getHeaders().empty() )
@@ -4311,13 +4314,14 @@ namespace EE { namespace UI { namespace Doc { namespace Language {
 	// patterns
 	buf += "{\n";
 	for ( const auto& pattern : def.getPatterns() )
-		buf += "{ " + join( pattern.patterns ) + ", " + join( pattern.types, true, true ) +
+		buf += "{ " + join( pattern.patterns ) + ", " + join( pattern.typesNames, true, true ) +
 			   str( pattern.syntax, ", ", "", false ) + " },\n";
 	buf += "\n},\n";
 	// symbols
 	buf += "{\n";
 	for ( const auto& symbol : def.getSymbols() )
-		buf += "{ " + str( symbol.first ) + " , " + str( symbol.second ) + " },\n";
+		buf += "{ " + str( symbol.first ) + " , " +
+			   str( SyntaxStyleTypes::toString( symbol.second ) ) + " },\n";
 	buf += "\n},\n";
 	buf += str( def.getComment(), "", "", false ) + ",\n";
 	std::string lspName =
@@ -4340,6 +4344,7 @@ namespace EE { namespace UI { namespace Doc { namespace Language {
 }
 
 SyntaxDefinition& SyntaxDefinitionManager::add( SyntaxDefinition&& syntaxStyle ) {
+	invalidateIndex();
 	mDefinitions.emplace_back( std::move( syntaxStyle ) );
 	return mDefinitions.back();
 }
@@ -4349,37 +4354,43 @@ const SyntaxDefinition& SyntaxDefinitionManager::getPlainStyle() const {
 }
 
 SyntaxDefinition& SyntaxDefinitionManager::getByExtensionRef( const std::string& filePath ) {
-	return const_cast<SyntaxDefinition&>( getByExtension( filePath ) );
+	SyntaxDefinition& def = const_cast<SyntaxDefinition&>( getByExtension( filePath ) );
+	// The definition can be modified by the caller
+	invalidateIndex();
+	return def;
 }
 
 const SyntaxDefinition&
 SyntaxDefinitionManager::getByLanguageName( const std::string& name ) const {
-	for ( auto& style : mDefinitions ) {
-		if ( style.getLanguageName() == name )
-			return style;
-	}
-	return mDefinitions[0];
+	Lock l( mIndexMutex );
+	if ( mIndexDirty )
+		buildIndex();
+	auto found = mLanguageNameIndex.find( name );
+	return found != mLanguageNameIndex.end() ? mDefinitions[found->second] : mDefinitions[0];
 }
 
 const SyntaxDefinition& SyntaxDefinitionManager::getByLSPName( const std::string& name ) const {
-	for ( auto& style : mDefinitions ) {
-		if ( style.getLSPName() == name )
-			return style;
-	}
-	return mDefinitions[0];
+	Lock l( mIndexMutex );
+	if ( mIndexDirty )
+		buildIndex();
+	auto found = mLSPNameIndex.find( name );
+	return found != mLSPNameIndex.end() ? mDefinitions[found->second] : mDefinitions[0];
 }
 
 const SyntaxDefinition&
 SyntaxDefinitionManager::getByLanguageId( const String::HashType& id ) const {
-	for ( auto& style : mDefinitions ) {
-		if ( style.getLanguageId() == id )
-			return style;
-	}
-	return mDefinitions[0];
+	Lock l( mIndexMutex );
+	if ( mIndexDirty )
+		buildIndex();
+	auto found = mLanguageIdIndex.find( id );
+	return found != mLanguageIdIndex.end() ? mDefinitions[found->second] : mDefinitions[0];
 }
 
 SyntaxDefinition& SyntaxDefinitionManager::getByLanguageNameRef( const std::string& name ) {
-	return const_cast<SyntaxDefinition&>( getByLanguageName( name ) );
+	SyntaxDefinition& def = const_cast<SyntaxDefinition&>( getByLanguageName( name ) );
+	// The definition can be modified by the caller
+	invalidateIndex();
+	return def;
 }
 
 std::vector<std::string> SyntaxDefinitionManager::getLanguageNames() const {
@@ -4539,6 +4550,8 @@ bool SyntaxDefinitionManager::loadFromStream( IOStream& stream,
 		}
 	}
 
+	invalidateIndex();
+
 	return true;
 }
 
@@ -4589,46 +4602,201 @@ void SyntaxDefinitionManager::loadFromFolder( const std::string& folderPath ) {
 	}
 }
 
-const SyntaxDefinition&
-SyntaxDefinitionManager::getByExtension( const std::string& filePath ) const {
-	std::string extension( FileSystem::fileExtension( filePath ) );
+static constexpr size_t FILE_NAME_CACHE_MAX_SIZE = 65536;
+
+static bool isFileTypePattern( const std::string& ext ) {
+	return String::startsWith( ext, "%." ) || String::startsWith( ext, "^" ) ||
+		   String::endsWith( ext, "$" );
+}
+
+/** Decodes the pattern range [start, end) into literal if it doesn't contain any magic character.
+ */
+static bool patternToLiteral( const std::string& pattern, size_t start, size_t end,
+							  std::string& literal ) {
+	static const std::string specials( "^$*+?.([%-" );
+	literal.clear();
+	for ( size_t i = start; i < end; i++ ) {
+		char c = pattern[i];
+		if ( c == '%' ) {
+			if ( i + 1 >= end || std::isalnum( static_cast<unsigned char>( pattern[i + 1] ) ) )
+				return false;
+			literal += pattern[++i];
+		} else if ( specials.find( c ) != std::string::npos ) {
+			return false;
+		} else {
+			literal += c;
+		}
+	}
+	return true;
+}
+
+/** @return True if the pattern is anchored and always starts with the same character. */
+static bool patternFirstChar( const std::string& pattern, char& firstChar ) {
+	static const std::string specials( "^$*+?.([%-" );
+	size_t next = 2;
+	if ( pattern.size() < 2 || pattern[0] != '^' )
+		return false;
+	if ( pattern[1] == '%' ) {
+		if ( pattern.size() < 3 || std::isalnum( static_cast<unsigned char>( pattern[2] ) ) )
+			return false;
+		firstChar = pattern[2];
+		next = 3;
+	} else if ( specials.find( pattern[1] ) != std::string::npos ) {
+		return false;
+	} else {
+		firstChar = pattern[1];
+	}
+	return next >= pattern.size() ||
+		   ( pattern[next] != '*' && pattern[next] != '?' && pattern[next] != '-' );
+}
+
+void SyntaxDefinitionManager::invalidateIndex() {
+	Lock l( mIndexMutex );
+	mIndexDirty = true;
+	mFileNameCache.clear();
+}
+
+void SyntaxDefinitionManager::buildIndex() const {
+	mLanguageNameIndex.clear();
+	mLSPNameIndex.clear();
+	mLanguageIdIndex.clear();
+	mExtensionIndex.clear();
+	mSuffixIndex.clear();
+	mFileNameIndex.clear();
+	mFilePatterns.clear();
+	mHeaderPatternsByChar.clear();
+	mHeaderPatterns.clear();
+	mFileNameCache.clear();
+
+	for ( size_t i = 0; i < mDefinitions.size(); i++ ) {
+		const SyntaxDefinition& def = mDefinitions[i];
+		mLanguageNameIndex.emplace( def.getLanguageName(), i );
+		mLSPNameIndex.emplace( def.getLSPName(), i );
+		mLanguageIdIndex.emplace( def.getLanguageId(), i );
+	}
+
+	// Same order used by the linear search: last definitions first
+	size_t priority = 0;
+	std::string literal;
+	for ( size_t i = mDefinitions.size(); i-- > 0; ) {
+		const SyntaxDefinition& def = mDefinitions[i];
+
+		for ( const auto& ext : def.getFiles() ) {
+			IndexEntry entry( priority++, i );
+			if ( !isFileTypePattern( ext ) ) {
+				mExtensionIndex.emplace( ext, entry );
+			} else if ( String::startsWith( ext, "%." ) && String::endsWith( ext, "$" ) &&
+						patternToLiteral( ext, 0, ext.size() - 1, literal ) ) {
+				mSuffixIndex.emplace( literal, entry );
+			} else if ( ext.size() > 2 && ext[0] == '^' && String::endsWith( ext, "$" ) &&
+						patternToLiteral( ext, 1, ext.size() - 1, literal ) ) {
+				mFileNameIndex.emplace( literal, entry );
+			} else {
+				mFilePatterns.push_back( { entry.first, i, LuaPattern( ext ) } );
+			}
+		}
+
+		for ( const auto& hdr : def.getHeaders() ) {
+			PatternEntry entry{ priority++, i, LuaPattern( hdr ) };
+			char firstChar;
+			if ( patternFirstChar( hdr, firstChar ) ) {
+				mHeaderPatternsByChar[firstChar].emplace_back( std::move( entry ) );
+			} else {
+				mHeaderPatterns.emplace_back( std::move( entry ) );
+			}
+		}
+	}
+
+	mIndexDirty = false;
+}
+
+size_t SyntaxDefinitionManager::findIndexByFileName( const std::string& filePath ) const {
 	std::string fileName( FileSystem::fileNameFromPath( filePath ) );
 
+	auto cached = mFileNameCache.find( fileName );
+	if ( cached != mFileNameCache.end() )
+		return cached->second;
+
+	std::string extension( FileSystem::fileExtension( filePath ) );
+
 	// Use the filename instead
 	if ( extension.empty() )
-		extension = FileSystem::fileNameFromPath( filePath );
+		extension = fileName;
+
+	IndexEntry found( std::numeric_limits<size_t>::max(), 0 );
 
 	if ( !extension.empty() ) {
-		for ( auto style = mDefinitions.rbegin(); style != mDefinitions.rend(); ++style ) {
-			for ( const auto& ext : style->getFiles() ) {
-				if ( String::startsWith( ext, "%." ) || String::startsWith( ext, "^" ) ||
-					 String::endsWith( ext, "$" ) ) {
-					LuaPattern words( ext );
-					int start, end;
-					if ( words.find( fileName, start, end ) )
-						return *style;
-				} else if ( extension == ext ) {
-					return *style;
-				}
+		auto lookup = [&found]( const std::unordered_map<std::string, IndexEntry>& index,
+								const std::string& key ) {
+			auto it = index.find( key );
+			if ( it != index.end() && it->second.first < found.first )
+				found = it->second;
+		};
+
+		lookup( mExtensionIndex, extension );
+		lookup( mFileNameIndex, fileName );
+		for ( size_t pos = fileName.find( '.' ); pos != std::string::npos;
+			  pos = fileName.find( '.', pos + 1 ) )
+			lookup( mSuffixIndex, fileName.substr( pos ) );
+
+		// Only the patterns with more priority than the best hash match need to be tested
+		LuaPattern::Range matches[12];
+		for ( const auto& entry : mFilePatterns ) {
+			if ( entry.priority >= found.first )
+				break;
+			if ( entry.pattern.getMatches( fileName.c_str(), 0, matches, fileName.size() ) > 0 ) {
+				found = { entry.priority, entry.index };
+				break;
 			}
 		}
 	}
-	return mDefinitions[0];
+
+	size_t index = found.first != std::numeric_limits<size_t>::max() ? found.second : 0;
+
+	if ( mFileNameCache.size() >= FILE_NAME_CACHE_MAX_SIZE )
+		mFileNameCache.clear();
+	mFileNameCache[fileName] = index;
+
+	return index;
 }
 
-const SyntaxDefinition& SyntaxDefinitionManager::getByHeader( const std::string& header ) const {
-	if ( !header.empty() ) {
-		for ( auto style = mDefinitions.rbegin(); style != mDefinitions.rend(); ++style ) {
-			for ( const auto& hdr : style->getHeaders() ) {
-				LuaPattern words( hdr );
-				int start, end;
-				if ( words.find( header, start, end ) ) {
-					return *style;
-				}
-			}
-		}
+size_t SyntaxDefinitionManager::findIndexByHeader( const std::string& header ) const {
+	if ( header.empty() )
+		return 0;
+
+	static const std::vector<PatternEntry> EMPTY_PATTERNS;
+	auto bucketIt = mHeaderPatternsByChar.find( header[0] );
+	const std::vector<PatternEntry>& bucket =
+		bucketIt != mHeaderPatternsByChar.end() ? bucketIt->second : EMPTY_PATTERNS;
+	LuaPattern::Range matches[12];
+	size_t b = 0;
+	size_t p = 0;
+
+	// Merge both lists by priority, the first match wins
+	while ( b < bucket.size() || p < mHeaderPatterns.size() ) {
+		bool fromBucket = b < bucket.size() && ( p >= mHeaderPatterns.size() ||
+												 bucket[b].priority < mHeaderPatterns[p].priority );
+		const PatternEntry& entry = fromBucket ? bucket[b++] : mHeaderPatterns[p++];
+		if ( entry.pattern.getMatches( header.c_str(), 0, matches, header.size() ) > 0 )
+			return entry.index;
 	}
-	return mDefinitions[0];
+
+	return 0;
+}
+
+const SyntaxDefinition&
+SyntaxDefinitionManager::getByExtension( const std::string& filePath ) const {
+	Lock l( mIndexMutex );
+	if ( mIndexDirty )
+		buildIndex();
+	return mDefinitions[findIndexByFileName( filePath )];
+}
+
+const SyntaxDefinition& SyntaxDefinitionManager::getByHeader( const std::string& header ) const {
+	Lock l( mIndexMutex );
+	if ( mIndexDirty )
+		buildIndex();
+	return mDefinitions[findIndexByHeader( header )];
 }
 
 const SyntaxDefinition& SyntaxDefinitionManager::find( const std::string& filePath,
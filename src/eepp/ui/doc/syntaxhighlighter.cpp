@@ -1,14 +1,65 @@
 #include <eepp/ui/doc/syntaxdefinitionmanager.hpp>
 #include <eepp/ui/doc/syntaxhighlighter.hpp>
 #include <eepp/ui/doc/syntaxtokenizer.hpp>
+#include <limits>
 
 namespace EE { namespace UI { namespace Doc {
 
+struct SyntaxHighlighter::BackgroundJob {
+	struct PreviousLine {
+		bool valid{ false };
+		Uint64 initState{ SYNTAX_TOKENIZER_STATE_NONE };
+	};
+
+	std::shared_ptr<const SyntaxDefinition> syntax;
+	Int64 startIndex{ 0 };
+	Uint64 startState{ SYNTAX_TOKENIZER_STATE_NONE };
+	Int64 lastInvalidLine{ -1 };
+	/** First line modified after the job was scheduled, results from there are discarded. */
+	Int64 invalidFrom{ std::numeric_limits<Int64>::max() };
+	std::vector<std::string> texts;
+	std::vector<String::HashType> hashes;
+	std::vector<PreviousLine> previous;
+	std::vector<TokenizedLine> results;
+	bool converged{ false };
+	std::atomic<bool> cancelled{ false };
+	std::atomic<bool> done{ false };
+
+	void run() {
+		Uint64 state = startState;
+		results.reserve( texts.size() );
+		for ( size_t i = 0; i < texts.size(); i++ ) {
+			if ( cancelled )
+				break;
+			Int64 index = startIndex + i;
+			// Once a line past every modified line starts with the same state it had before, the
+			// rest of the document can't change.
+			if ( previous[i].valid && previous[i].initState == state && index > lastInvalidLine ) {
+				converged = true;
+				break;
+			}
+			TokenizedLine line;
+			line.initState = state;
+			line.hash = hashes[i];
+			auto res = SyntaxTokenizer::tokenizePosition( *syntax, texts[i], state );
+			line.tokens = std::move( res.first );
+			line.state = res.second;
+			state = line.state;
+			results.emplace_back( std::move( line ) );
+		}
+		done = true;
+	}
+};
+
 SyntaxHighlighter::SyntaxHighlighter( TextDocument* doc ) :
 	mDoc( doc ), mFirstInvalidLine( 0 ), mMaxWantedLine( 0 ) {
 	reset();
 }
 
+SyntaxHighlighter::~SyntaxHighlighter() {
+	cancelBackgroundJob();
+}
+
 void SyntaxHighlighter::changeDoc( TextDocument* doc ) {
 	mDoc = doc;
 	reset();
@@ -16,15 +67,22 @@ void SyntaxHighlighter::changeDoc( TextDocument* doc ) {
 }
 
 void SyntaxHighlighter::reset() {
+	cancelBackgroundJob();
+	mBackgroundSyntax.reset();
 	Lock l( mLinesMutex );
 	mLines.clear();
 	mFirstInvalidLine = 0;
 	mMaxWantedLine = 0;
+	mLastInvalidLine = -1;
+	mFrontierLine = -1;
 }
 
 void SyntaxHighlighter::invalidate( Int64 lineIndex ) {
 	mFirstInvalidLine = eemin( lineIndex, mFirstInvalidLine );
 	mMaxWantedLine = eemin<Int64>( mMaxWantedLine, (Int64)mDoc->linesCount() - 1 );
+	mLastInvalidLine = eemax( lineIndex, mLastInvalidLine );
+	if ( mBackgroundJob )
+		mBackgroundJob->invalidFrom = eemin( lineIndex, mBackgroundJob->invalidFrom );
 }
 
 TokenizedLine SyntaxHighlighter::tokenizeLine( const size_t& line, const Uint64& state ) {
@@ -35,6 +93,7 @@ TokenizedLine SyntaxHighlighter::tokenizeLine( const size_t& line, const Uint64&
 												  mDoc->line( line ).toUtf8(), state );
 	tokenizedLine.tokens = std::move( res.first );
 	tokenizedLine.state = std::move( res.second );
+	tokenizedLine.signature = ++mSignatureCounter;
 	return tokenizedLine;
 }
 
@@ -44,7 +103,8 @@ Mutex& SyntaxHighlighter::getLinesMutex() {
 
 const std::vector<SyntaxTokenPosition>& SyntaxHighlighter::getLine( const size_t& index ) {
 	if ( mDoc->getSyntaxDefinition().getPatterns().empty() ) {
-		static std::vector<SyntaxTokenPosition> noHighlightVector = { { "normal", 0 } };
+		static std::vector<SyntaxTokenPosition> noHighlightVector = {
+			{ SyntaxStyleTypes::Normal, 0 } };
 		noHighlightVector[0].len = mDoc->line( index ).size();
 		return noHighlightVector;
 	}
@@ -68,6 +128,17 @@ const std::vector<SyntaxTokenPosition>& SyntaxHighlighter::getLine( const size_t
 	return it->second.tokens;
 }
 
+Uint64 SyntaxHighlighter::getLineSignature( const size_t& index ) {
+	if ( mDoc->getSyntaxDefinition().getPatterns().empty() )
+		return index < mDoc->linesCount() ? mDoc->line( index ).getHash() : 0;
+	Lock l( mLinesMutex );
+	const auto& it = mLines.find( index );
+	if ( it == mLines.end() ||
+		 ( index < mDoc->linesCount() && mDoc->line( index ).getHash() != it->second.hash ) )
+		return 0;
+	return it->second.signature;
+}
+
 Int64 SyntaxHighlighter::getFirstInvalidLine() const {
 	return mFirstInvalidLine;
 }
@@ -79,6 +150,8 @@ Int64 SyntaxHighlighter::getMaxWantedLine() const {
 bool SyntaxHighlighter::updateDirty( int visibleLinesCount ) {
 	if ( visibleLinesCount <= 0 )
 		return 0;
+	if ( mThreadPool )
+		return updateDirtyInBackground( visibleLinesCount );
 	if ( mFirstInvalidLine > mMaxWantedLine ) {
 		mMaxWantedLine = 0;
 	} else {
@@ -107,6 +180,137 @@ bool SyntaxHighlighter::updateDirty( int visibleLinesCount ) {
 	return false;
 }
 
+bool SyntaxHighlighter::updateDirtyInBackground( int visibleLinesCount ) {
+	bool changed = false;
+
+	if ( mBackgroundJob ) {
+		if ( !mBackgroundJob->done )
+			return false;
+		changed = publishBackgroundJob();
+	}
+
+	Int64 lastLine = (Int64)mDoc->linesCount() - 1;
+	Int64 wantedLine = eemax<Int64>( mMaxWantedLine, mFirstInvalidLine + visibleLinesCount );
+	Int64 toLine = eemin( lastLine, wantedLine + mSpeculativeLinesCount );
+
+	if ( mFirstInvalidLine > toLine ) {
+		mLastInvalidLine = -1;
+		return changed;
+	}
+
+	scheduleBackgroundJob( eemin( toLine, mFirstInvalidLine + BackgroundBatchSize - 1 ) );
+	return changed;
+}
+
+void SyntaxHighlighter::scheduleBackgroundJob( const Int64& toLine ) {
+	const SyntaxDefinition& syntax = mDoc->getSyntaxDefinition();
+	// The copy is refreshed when the definition is replaced or modified, even under the same name
+	if ( !mBackgroundSyntax || mBackgroundSyntax->getGeneration() != syntax.getGeneration() )
+		mBackgroundSyntax = std::make_shared<const SyntaxDefinition>( syntax );
+
+	auto job = std::make_shared<BackgroundJob>();
+	job->syntax = mBackgroundSyntax;
+	job->startIndex = mFirstInvalidLine;
+	job->lastInvalidLine = mLastInvalidLine;
+
+	size_t count = toLine - mFirstInvalidLine + 1;
+	job->texts.reserve( count );
+	job->hashes.reserve( count );
+	job->previous.reserve( count );
+
+	{
+		Lock l( mLinesMutex );
+		if ( mFirstInvalidLine > 0 ) {
+			auto prevIt = mLines.find( mFirstInvalidLine - 1 );
+			if ( prevIt != mLines.end() )
+				job->startState = prevIt->second.state;
+		}
+
+		for ( Int64 index = mFirstInvalidLine; index <= toLine; index++ ) {
+			const auto& line = mDoc->line( index );
+			auto it = mLines.find( index );
+			BackgroundJob::PreviousLine previous;
+			if ( it != mLines.end() && it->second.hash == line.getHash() ) {
+				previous.valid = true;
+				previous.initState = it->second.initState;
+			}
+			job->texts.emplace_back( line.toUtf8() );
+			job->hashes.emplace_back( line.getHash() );
+			job->previous.emplace_back( previous );
+		}
+	}
+
+	mBackgroundJob = job;
+	mThreadPool->run( [job] { job->run(); } );
+}
+
+bool SyntaxHighlighter::publishBackgroundJob() {
+	std::shared_ptr<BackgroundJob> job( std::move( mBackgroundJob ) );
+	mBackgroundJob.reset();
+
+	// A line before the job range was modified, every result depends on it.
+	if ( mFirstInvalidLine < job->startIndex )
+		return false;
+
+	Int64 linesCount = mDoc->linesCount();
+	Int64 index = job->startIndex;
+
+	{
+		Lock l( mLinesMutex );
+		for ( auto& line : job->results ) {
+			if ( index >= job->invalidFrom || index >= linesCount ||
+				 mDoc->line( index ).getHash() != line.hash )
+				break;
+			line.signature = ++mSignatureCounter;
+			mTokenizerLines[index] = line;
+			mLines[index] = std::move( line );
+			index++;
+		}
+	}
+
+	bool accepted = index == job->startIndex + (Int64)job->results.size();
+
+	if ( accepted && job->converged && job->invalidFrom == std::numeric_limits<Int64>::max() ) {
+		mFirstInvalidLine = eemax( index, eemin( mFrontierLine, linesCount - 1 ) + 1 );
+	} else {
+		mFirstInvalidLine = index;
+	}
+
+	mFrontierLine = eemax( mFrontierLine, index - 1 );
+
+	return index > job->startIndex;
+}
+
+void SyntaxHighlighter::cancelBackgroundJob() {
+	if ( mBackgroundJob ) {
+		mBackgroundJob->cancelled = true;
+		mBackgroundJob.reset();
+	}
+}
+
+void SyntaxHighlighter::setThreadPool( const std::shared_ptr<ThreadPool>& pool ) {
+	if ( pool == mThreadPool )
+		return;
+	cancelBackgroundJob();
+	mThreadPool = pool;
+}
+
+const std::shared_ptr<ThreadPool>& SyntaxHighlighter::getThreadPool() const {
+	return mThreadPool;
+}
+
+void SyntaxHighlighter::setSpeculativeLinesCount( const Int64& count ) {
+	mSpeculativeLinesCount = eemax<Int64>( 0, count );
+}
+
+const Int64& SyntaxHighlighter::getSpeculativeLinesCount() const {
+	return mSpeculativeLinesCount;
+}
+
+bool SyntaxHighlighter::isTokenizingInBackground() const {
+	return mBackgroundJob != nullptr;
+}
+
 const SyntaxDefinition&
 SyntaxHighlighter::getSyntaxDefinitionFromTextPosition( const TextPosition& position ) {
 	Lock l( mLinesMutex );
@@ -124,19 +328,19 @@ SyntaxHighlighter::getSyntaxDefinitionFromTextPosition( const TextPosition& posi
 	return *state.currentSyntax;
 }
 
-std::string SyntaxHighlighter::getTokenTypeAt( const TextPosition& pos ) {
+SyntaxStyleType SyntaxHighlighter::getTokenTypeAt( const TextPosition& pos ) {
 	if ( !pos.isValid() || pos.line() < 0 || pos.line() >= (Int64)mDoc->linesCount() )
-		return "normal";
+		return SyntaxStyleTypes::Normal;
 	auto tokens = getLine( pos.line() );
 	if ( tokens.empty() )
-		return "normal";
+		return SyntaxStyleTypes::Normal;
 	Int64 col = 0;
 	for ( const auto& token : tokens ) {
 		col += token.len;
 		if ( col > pos.column() )
 			return token.type;
 	}
-	return "normal";
+	return SyntaxStyleTypes::Normal;
 }
 
 SyntaxTokenPosition SyntaxHighlighter::getTokenPositionAt( const TextPosition& pos ) {
@@ -157,6 +361,7 @@ SyntaxTokenPosition SyntaxHighlighter::getTokenPositionAt( const TextPosition& p
 void SyntaxHighlighter::setLine( const size_t& line, const TokenizedLine& tokenization ) {
 	Lock l( mLinesMutex );
 	mLines[line] = tokenization;
+	mLines[line].signature = ++mSignatureCounter;
 }
 
 void SyntaxHighlighter::mergeLine( const size_t& line, const TokenizedLine& tokenization ) {
@@ -201,6 +406,7 @@ void SyntaxHighlighter::mergeLine( const size_t& line, const TokenizedLine& toke
 		}
 	}
 
+	tline.signature = ++mSignatureCounter;
 	Lock l( mLinesMutex );
 	mLines[line] = std::move( tline );
 }
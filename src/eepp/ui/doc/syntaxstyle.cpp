@@ -0,0 +1,47 @@
+#include <eepp/system/lock.hpp>
+#include <eepp/system/mutex.hpp>
+#include <eepp/ui/doc/syntaxstyle.hpp>
+#include <unordered_map>
+
+using namespace EE::System;
+
+namespace EE { namespace UI { namespace Doc {
+
+struct SyntaxStyleTypeRegistry {
+	Mutex mutex;
+	std::unordered_map<SyntaxStyleType, std::string> names;
+
+	SyntaxStyleTypeRegistry() {
+		for ( const auto& name : { "normal", "symbol", "comment", "keyword", "keyword2", "number",
+								   "literal", "string", "operator", "function", "link",
+								   "link_hover" } )
+			names[String::hash( name )] = name;
+	}
+};
+
+static SyntaxStyleTypeRegistry& getRegistry() {
+	static SyntaxStyleTypeRegistry registry;
+	return registry;
+}
+
+SyntaxStyleType SyntaxStyleTypes::fromString( const std::string& type ) {
+	SyntaxStyleType id = String::hash( type );
+	auto& registry = getRegistry();
+	Lock l( registry.mutex );
+	auto it = registry.names.find( id );
+	if ( it == registry.names.end() )
+		registry.names[id] = type;
+	return id;
+}
+
+const std::string& SyntaxStyleTypes::toString( const SyntaxStyleType& type ) {
+	auto& registry = getRegistry();
+	Lock l( registry.mutex );
+	auto it = registry.names.find( type );
+	// Elements are never removed and references to unordered_map values remain valid.
+	if ( it != registry.names.end() )
+		return it->second;
+	return registry.names[Normal];
+}
+
+}}} // namespace EE::UI::Doc
@@ -31,7 +31,8 @@ static int isInMultiByteCodePoint( const char* text, const size_t& textSize, con
 }
 
 template <typename T>
-static void pushToken( std::vector<T>& tokens, const std::string& type, const std::string& text ) {
+static void pushToken( std::vector<T>& tokens, const SyntaxStyleType& type,
+					   const std::string& text ) {
 	if ( !tokens.empty() && ( tokens[tokens.size() - 1].type == type ) ) {
 		size_t tpos = tokens.size() - 1;
 		tokens[tpos].type = type;
@@ -91,16 +92,15 @@ bool isScaped( const std::string& text, const size_t& startIndex, const std::str
 	return count % 2 == 1;
 }
 
-std::pair<int, int> findNonEscaped( const std::string& text, const std::string& pattern, int offset,
+std::pair<int, int> findNonEscaped( const std::string& text, const LuaPattern& pattern, int offset,
 									const std::string& escapeStr ) {
+	LuaPattern::Range matches[12];
 	while ( true ) {
-		LuaPattern words( pattern );
-		int start, end;
-		if ( words.find( text, start, end, offset ) ) {
-			if ( !escapeStr.empty() && isScaped( text, start, escapeStr ) ) {
-				offset = end;
+		if ( pattern.getMatches( text.c_str(), offset, matches, text.size() ) > 0 ) {
+			if ( !escapeStr.empty() && isScaped( text, matches[0].start, escapeStr ) ) {
+				offset = matches[0].end;
 			} else {
-				return std::make_pair( start, end );
+				return std::make_pair( matches[0].start, matches[0].end );
 			}
 		} else {
 			return std::make_pair( -1, -1 );
@@ -148,7 +148,7 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 	size_t numMatches;
 
 	if ( syntax.getPatterns().empty() ) {
-		pushToken( tokens, "normal", text );
+		pushToken( tokens, SyntaxStyleTypes::Normal, text );
 		return std::make_pair( std::move( tokens ), SYNTAX_TOKENIZER_STATE_NONE );
 	}
 
@@ -184,14 +184,14 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 			const SyntaxPattern& pattern =
 				curState.currentSyntax->getPatterns()[curState.currentPatternIdx - 1];
 			std::pair<int, int> range =
-				findNonEscaped( text, pattern.patterns[1], i,
+				findNonEscaped( text, pattern.matchers[1], i,
 								pattern.patterns.size() >= 3 ? pattern.patterns[2] : "" );
 
 			bool skip = false;
 
 			if ( curState.subsyntaxInfo != nullptr ) {
 				std::pair<int, int> rangeSubsyntax =
-					findNonEscaped( text, curState.subsyntaxInfo->patterns[1], i,
+					findNonEscaped( text, curState.subsyntaxInfo->matchers[1], i,
 									curState.subsyntaxInfo->patterns.size() >= 3
 										? curState.subsyntaxInfo->patterns[2]
 										: "" );
@@ -222,7 +222,7 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 
 		if ( curState.subsyntaxInfo != nullptr ) {
 			std::pair<int, int> rangeSubsyntax = findNonEscaped(
-				text, "^" + curState.subsyntaxInfo->patterns[1], i,
+				text, curState.subsyntaxInfo->matchers[2], i,
 				curState.subsyntaxInfo->patterns.size() >= 3 ? curState.subsyntaxInfo->patterns[2]
 															 : "" );
 
@@ -243,10 +243,8 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 			const SyntaxPattern& pattern = curState.currentSyntax->getPatterns()[patternIndex];
 			if ( i != 0 && pattern.patterns[0][0] == '^' )
 				continue;
-			const std::string& patternStr(
-				pattern.patterns[0][0] == '^' ? pattern.patterns[0] : "^" + pattern.patterns[0] );
-			LuaPattern words( patternStr );
-			if ( words.matches( text, matches, i ) && ( numMatches = words.getNumMatches() ) > 0 ) {
+			const LuaPattern& words = pattern.matchers[0];
+			if ( ( numMatches = words.getMatches( text.c_str(), i, matches, text.size() ) ) > 0 ) {
 				if ( numMatches > 1 ) {
 					int patternMatchStart = matches[0].start;
 					int patternMatchEnd = matches[0].end;
@@ -272,13 +270,14 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 						}
 
 						std::string patternText( text.substr( start, end - start ) );
-						std::string type = curState.currentSyntax->getSymbol( patternText );
+						SyntaxStyleType type = curState.currentSyntax->getSymbol( patternText );
 						if ( !skipSubSyntaxSeparator || pattern.syntax.empty() ) {
 							pushToken( tokens,
-									   type.empty() ? ( curMatch < pattern.types.size()
-															? pattern.types[curMatch]
-															: pattern.types[0] )
-													: type,
+									   type == SyntaxStyleTypes::None
+										   ? ( curMatch < pattern.types.size()
+												   ? pattern.types[curMatch]
+												   : pattern.types[0] )
+										   : type,
 									   patternText );
 						}
 
@@ -309,13 +308,14 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 							 text[i - 1] == pattern.patterns[2][0] )
 							continue;
 						std::string patternText( text.substr( start, end - start ) );
-						std::string type = curState.currentSyntax->getSymbol( patternText );
+						SyntaxStyleType type = curState.currentSyntax->getSymbol( patternText );
 						if ( !skipSubSyntaxSeparator || pattern.syntax.empty() ) {
 							pushToken( tokens,
-									   type.empty() ? ( curMatch < pattern.types.size()
-															? pattern.types[curMatch]
-															: pattern.types[0] )
-													: type,
+									   type == SyntaxStyleTypes::None
+										   ? ( curMatch < pattern.types.size()
+												   ? pattern.types[curMatch]
+												   : pattern.types[0] )
+										   : type,
 									   patternText );
 						}
 						if ( !pattern.syntax.empty() ) {
@@ -337,7 +337,7 @@ _tokenize( const SyntaxDefinition& syntax, const std::string& text, const Uint32
 			String::utf8Next( strEnd );
 			int dist = strEnd - strStart;
 			if ( dist > 0 ) {
-				pushToken( tokens, "normal", text.substr( i, dist ) );
+				pushToken( tokens, SyntaxStyleTypes::Normal, text.substr( i, dist ) );
 				i += dist;
 			} else {
 				Log::error( "Error parsing \"%s\" using syntax: %s", text.c_str(),
@@ -1,9 +1,11 @@
 ﻿#include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <eepp/core/debug.hpp>
 #include <eepp/network/uri.hpp>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/iostreamfile.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
 #include <eepp/system/iostreammemory.hpp>
 #include <eepp/system/log.hpp>
 #include <eepp/system/luapattern.hpp>
@@ -412,6 +414,239 @@ bool TextDocument::loadAsyncFromFile( const std::string& path, std::shared_ptr<T
 	return true;
 }
 
+bool TextDocument::loadAsyncIncrementalFromFile(
+	const std::string& path, std::shared_ptr<ThreadPool> pool,
+	std::function<void( TextDocument*, bool )> onLoaded,
+	std::function<void( TextDocument*, Float )> onProgress ) {
+	if ( mLoading )
+		return false;
+	reset();
+	mLoading = true;
+	mLoadingAsync = true;
+	mLoadProgress = 0;
+	mIncrementalOnLoaded = onLoaded;
+	{
+		Lock l( mPendingLinesMutex );
+		mPendingLines.clear();
+		mPendingLinesFinished = false;
+		mPendingLinesStatus = LoadStatus::Failed;
+		mPendingIsBOM = false;
+		mPendingLineEnding = LineEnding::LF;
+		mPendingMightBeBinary = false;
+	}
+	{
+		Lock l( mLoadingFilePathMutex );
+		mLoadingFilePath = path;
+		mLoadingFileURI = URI( "file://" + mLoadingFilePath );
+	}
+	pool->run( [this, path, onProgress] {
+		Lock l( mLoadingMutex );
+		LoadStatus status = loadIncrementalFromFile( path, onProgress );
+		{
+			Lock pl( mPendingLinesMutex );
+			mPendingLinesFinished = true;
+			mPendingLinesStatus = status;
+		}
+		mLoadProgress = 1;
+		if ( onProgress )
+			onProgress( this, 1 );
+	} );
+	return true;
+}
+
+TextDocument::LoadStatus TextDocument::loadIncrementalFromFile(
+	const std::string& path, const std::function<void( TextDocument*, Float )>& onProgress ) {
+	// The first chunk is small so the first screen can be displayed as soon as possible.
+	const size_t FIRST_CHUNK_SIZE = 64 * 1024;
+	const size_t CHUNK_SIZE = 4 * EE_1MB;
+	Clock clock;
+	IOStreamMappedFile file( path );
+	if ( !file.isOpen() )
+		return LoadStatus::Failed;
+
+	const char* data = file.getData();
+	size_t size = file.getSize();
+	size_t pos = 0;
+	// The document is read from the main thread while loading, the file properties are published
+	// with the first lines by commitLoadedLines.
+	bool isBOM = false;
+	LineEnding lineEnding = LineEnding::LF;
+
+	if ( size >= 3 && (char)0xef == data[0] && (char)0xbb == data[1] && (char)0xbf == data[2] ) {
+		pos = 3;
+		isBOM = true;
+	}
+
+	// The line ending and binary guess are based on the first line, as in loadFromStream.
+	const char* firstLineEnd = data + pos;
+	while ( firstLineEnd < data + size && *firstLineEnd != '\n' && *firstLineEnd != '\r' )
+		firstLineEnd++;
+	if ( firstLineEnd < data + size && *firstLineEnd == '\r' ) {
+		lineEnding = firstLineEnd + 1 < data + size && firstLineEnd[1] == '\n' ? LineEnding::CRLF
+																				: LineEnding::CR;
+	}
+	bool mightBeBinary =
+		size > 0 && std::memchr( data + pos, '\0', firstLineEnd - ( data + pos ) );
+
+	{
+		Lock l( mPendingLinesMutex );
+		mPendingIsBOM = isBOM;
+		mPendingLineEnding = lineEnding;
+		mPendingMightBeBinary = mightBeBinary;
+	}
+
+	const char lineBreak = lineEnding == LineEnding::CR ? '\r' : '\n';
+	size_t chunkSize = FIRST_CHUNK_SIZE;
+	bool lastEndsWithNewLine = false;
+	bool first = true;
+
+	while ( mLoading && ( pos < size || first ) ) {
+		size_t end = eemin( size, pos + chunkSize );
+		if ( end < size ) {
+			const char* br =
+				static_cast<const char*>( std::memchr( data + end, lineBreak, size - end ) );
+			end = br ? br - data + 1 : size;
+		}
+
+		std::vector<TextDocumentLine> lines;
+		while ( pos < end ) {
+			const char* br =
+				static_cast<const char*>( std::memchr( data + pos, lineBreak, end - pos ) );
+			size_t lineEnd = br ? br - data + 1 : end;
+			size_t len = lineEnd - pos;
+			lastEndsWithNewLine = br != nullptr;
+			if ( lastEndsWithNewLine ) {
+				// Normalize the line ending to a single \n.
+				if ( lineEnding == LineEnding::CRLF && len > 1 && data[lineEnd - 2] == '\r' )
+					len--;
+				String line( data + pos, len - 1 );
+				line.push_back( '\n' );
+				lines.emplace_back( std::move( line ) );
+			} else {
+				String line( data + pos, len );
+				line.push_back( '\n' );
+				lines.emplace_back( std::move( line ) );
+			}
+			pos = lineEnd;
+		}
+
+		if ( pos >= size && ( lastEndsWithNewLine || lines.empty() ) && mLoading )
+			lines.emplace_back( String( "\n" ) );
+
+		{
+			Lock l( mPendingLinesMutex );
+			mPendingLines.emplace_back( std::move( lines ) );
+		}
+
+		mLoadProgress = size ? (Float)pos / size : 1.f;
+		if ( onProgress && pos < size )
+			onProgress( this, mLoadProgress );
+
+		chunkSize = CHUNK_SIZE;
+		first = false;
+	}
+
+	if ( mVerbose )
+		Log::info( "Document \"%s\" indexed in %.2fms.", path.c_str(),
+				   clock.getElapsedTime().asMilliseconds() );
+
+	return mLoading ? LoadStatus::Loaded : LoadStatus::Interrupted;
+}
+
+bool TextDocument::commitLoadedLines() {
+	std::vector<std::vector<TextDocumentLine>> pending;
+	bool finished;
+	LoadStatus status;
+	bool isBOM;
+	LineEnding lineEnding;
+	bool mightBeBinary;
+	{
+		Lock l( mPendingLinesMutex );
+		pending.swap( mPendingLines );
+		finished = mPendingLinesFinished;
+		status = mPendingLinesStatus;
+		mPendingLinesFinished = false;
+		isBOM = mPendingIsBOM;
+		lineEnding = mPendingLineEnding;
+		mightBeBinary = mPendingMightBeBinary;
+	}
+
+	bool changed = false;
+	if ( !pending.empty() && mLoading ) {
+		size_t lastCount = mLines.size();
+		if ( !mLoadingIncrementally ) {
+			// Drop the empty line set by reset().
+			mLines.clear();
+		}
+		for ( auto& lines : pending )
+			mLines.insert( mLines.size(), std::move( lines ) );
+		if ( mLines.empty() )
+			mLines.push_back( String( "\n" ) );
+		if ( !mLoadingIncrementally ) {
+			mLoadingIncrementally = true;
+			mIsBOM = isBOM;
+			mLineEnding = lineEnding;
+			mMightBeBinary = mightBeBinary;
+			if ( mAutoDetectIndentType )
+				guessIndentType();
+		}
+		notifyLineCountChanged( lastCount, mLines.size() );
+		changed = true;
+	}
+
+	if ( finished )
+		finishIncrementalLoad( status );
+
+	return changed;
+}
+
+void TextDocument::finishIncrementalLoad( const LoadStatus& status ) {
+	std::string path;
+	{
+		Lock l( mLoadingFilePathMutex );
+		path = mLoadingFilePath;
+		mLoadingFilePath.clear();
+		mLoadingFileURI = URI();
+	}
+
+	if ( status == LoadStatus::Loaded ) {
+		mFilePath = path;
+		mFileURI = URI( "file://" + mFilePath );
+		mFileRealPath = FileInfo::isLink( mFilePath )
+							? FileInfo( FileInfo( mFilePath ).linksTo() )
+							: FileInfo( mFilePath );
+		mLoadingIncrementally = false;
+		mLoading = false;
+		resetSyntax();
+	} else {
+		size_t lastCount = mLines.size();
+		mLoadingIncrementally = false;
+		mLoading = false;
+		reset();
+		if ( lastCount != mLines.size() )
+			notifyLineCountChanged( lastCount, mLines.size() );
+	}
+
+	mLoadingAsync = false;
+	auto onLoaded = std::move( mIncrementalOnLoaded );
+	mIncrementalOnLoaded = nullptr;
+	if ( status != LoadStatus::Interrupted && onLoaded )
+		onLoaded( this, status == LoadStatus::Loaded );
+	notifyDocumentLoaded();
+}
+
+void TextDocument::detachIncrementalLoadCallback() {
+	mIncrementalOnLoaded = nullptr;
+}
+
+bool TextDocument::isLoadingIncrementally() const {
+	return mLoadingIncrementally;
+}
+
+Float TextDocument::getLoadProgress() const {
+	return mLoadProgress;
+}
+
 TextDocument::LoadStatus TextDocument::loadFromMemory( const Uint8* data, const Uint32& size ) {
 	IOStreamMemory stream( (const char*)data, size );
 	return loadFromStream( stream, mFilePath, true );
@@ -780,7 +1015,7 @@ const TextDocumentLine& TextDocument::getCurrentLine() const {
 	return mLines[getSelection().start().line()];
 }
 
-std::vector<TextDocumentLine>& TextDocument::lines() {
+TextDocumentRope& TextDocument::lines() {
 	return mLines;
 }
 
@@ -794,12 +1029,16 @@ String TextDocument::getText( const TextRange& range ) const {
 		return mLines[nrange.start().line()].substr(
 			nrange.start().column(), nrange.end().column() - nrange.start().column() );
 	}
-	std::vector<String> lines = { mLines[nrange.start().line()].substr( nrange.start().column() ) };
-	for ( auto i = nrange.start().line() + 1; i <= nrange.end().line() - 1; i++ ) {
-		lines.emplace_back( mLines[i].getText() );
-	}
-	lines.emplace_back( mLines[nrange.end().line()].substr( 0, nrange.end().column() ) );
-	return String::join( lines, -1 );
+	size_t size = 0;
+	for ( auto i = nrange.start().line(); i <= nrange.end().line(); i++ )
+		size += mLines[i].size();
+	String text;
+	text.reserve( size );
+	text.append( mLines[nrange.start().line()].substr( nrange.start().column() ) );
+	for ( auto i = nrange.start().line() + 1; i <= nrange.end().line() - 1; i++ )
+		text.append( mLines[i].getText() );
+	text.append( mLines[nrange.end().line()].substr( 0, nrange.end().column() ) );
+	return text;
 }
 
 String TextDocument::getText() const {
@@ -831,7 +1070,13 @@ bool TextDocument::isRunningTransaction() const {
 }
 
 void TextDocument::setRunningTransaction( const bool runningTransaction ) {
-	mRunningTransaction = runningTransaction;
+	bool wasRunning = mRunningTransaction.exchange( runningTransaction );
+	// Undo and redo run as a transaction too, but they don't record new edits
+	if ( runningTransaction && !wasRunning ) {
+		mUndoStack.beginTransaction( mTimer.getElapsedTime() );
+	} else if ( !runningTransaction && wasRunning ) {
+		mUndoStack.endTransaction();
+	}
 }
 
 String TextDocument::getSelectedText() const {
@@ -871,7 +1116,7 @@ TextPosition TextDocument::insert( const size_t& cursorIdx, const TextPosition&
 								   const String& text ) {
 	mUndoStack.clearRedoStack();
 	return insert( cursorIdx, position, text, mUndoStack.getUndoStackContainer(),
-				   mTimer.getElapsedTime() );
+				   mUndoStack.getTransactionTime( mTimer.getElapsedTime() ) );
 }
 
 TextPosition TextDocument::insert( const size_t& cursorIdx, TextPosition position,
@@ -902,12 +1147,17 @@ TextPosition TextDocument::insert( const size_t& cursorIdx, TextPosition positio
 	lines[0] = before + lines[0];
 	lines[lines.size() - 1] = lines[lines.size() - 1] + after;
 
-	mLines[position.line()] = TextDocumentLine( lines[0] );
+	mLines[position.line()].setText( std::move( lines[0] ) );
 	notifyLineChanged( position.line() );
 
-	for ( Int64 i = 1; i < (Int64)lines.size(); i++ ) {
-		mLines.insert( mLines.begin() + position.line() + i, TextDocumentLine( lines[i] ) );
-		notifyLineChanged( position.line() + i );
+	if ( lines.size() > 1 ) {
+		std::vector<TextDocumentLine> newLines;
+		newLines.reserve( lines.size() - 1 );
+		for ( size_t i = 1; i < lines.size(); i++ )
+			newLines.emplace_back( std::move( lines[i] ) );
+		mLines.insert( position.line() + 1, std::move( newLines ) );
+		for ( Int64 i = 1; i < (Int64)lines.size(); i++ )
+			notifyLineChanged( position.line() + i );
 	}
 
 	TextPosition cursor = positionOffset( position, text.size() );
@@ -947,8 +1197,9 @@ TextPosition TextDocument::insert( const size_t& cursorIdx, TextPosition positio
 size_t TextDocument::remove( const size_t& cursorIdx, TextRange range ) {
 	size_t lineCount = mLines.size();
 	mUndoStack.clearRedoStack();
-	size_t linesRemoved = remove( cursorIdx, sanitizeRange( range.normalized() ),
-								  mUndoStack.getUndoStackContainer(), mTimer.getElapsedTime() );
+	size_t linesRemoved =
+		remove( cursorIdx, sanitizeRange( range.normalized() ), mUndoStack.getUndoStackContainer(),
+				mUndoStack.getTransactionTime( mTimer.getElapsedTime() ) );
 	if ( lineCount != mLines.size() ) {
 		notifyLineCountChanged( lineCount, mLines.size() );
 	}
@@ -980,8 +1231,7 @@ size_t TextDocument::remove( const size_t& cursorIdx, TextRange range,
 
 	// First delete all the lines in between the first and last one.
 	if ( range.start().line() + 1 < range.end().line() ) {
-		mLines.erase( mLines.begin() + range.start().line() + 1,
-					  mLines.begin() + range.end().line() );
+		mLines.erase( range.start().line() + 1, range.end().line() );
 		range.end().setLine( range.start().line() + 1 );
 		linesRemoved = range.end().line() - ( range.start().line() + 1 );
 	}
@@ -1025,7 +1275,7 @@ size_t TextDocument::remove( const size_t& cursorIdx, TextRange range,
 			afterSelection += '\n';
 
 		firstLine.setText( beforeSelection + afterSelection );
-		mLines.erase( mLines.begin() + range.end().line() );
+		mLines.erase( range.end().line() );
 		linesRemoved += 1;
 	}
 
@@ -1346,6 +1596,12 @@ std::vector<bool> TextDocument::autoCloseBrackets( const String& text ) {
 }
 
 void TextDocument::textInput( const String& text ) {
+	mUndoStack.beginTransaction( mTimer.getElapsedTime() );
+	textInputSelections( text );
+	mUndoStack.endTransaction();
+}
+
+void TextDocument::textInputSelections( const String& text ) {
 	if ( mAutoCloseBrackets && 1 == text.size() ) {
 		auto inserted = autoCloseBrackets( text );
 
@@ -2320,6 +2576,9 @@ TextRange TextDocument::findLast( const String& text, TextPosition from, bool ca
 
 TextRanges TextDocument::findAll( const String& text, bool caseSensitive, bool wholeWord,
 								  const FindReplaceType& type, TextRange restrictRange ) {
+	if ( isLiteralSearch( text, type ) )
+		return findAllLiteral( text, caseSensitive, wholeWord, restrictRange );
+
 	TextRanges all;
 	TextRange found;
 	TextPosition from = startOfDoc();
@@ -2339,17 +2598,103 @@ TextRanges TextDocument::findAll( const String& text, bool caseSensitive, bool w
 	return all;
 }
 
+bool TextDocument::isLiteralSearch( const String& text, const FindReplaceType& type ) {
+	return type == FindReplaceType::Normal && !text.empty() &&
+		   text.find( '\n' ) == String::InvalidPos;
+}
+
+TextRanges TextDocument::findAllLiteral( const String& text, bool caseSensitive, bool wholeWord,
+										 TextRange restrictRange ) {
+	TextRanges all;
+	if ( text.empty() || mLines.empty() )
+		return all;
+
+	TextPosition from = startOfDoc();
+	TextPosition to = endOfDoc();
+	if ( restrictRange.isValid() ) {
+		restrictRange = sanitizeRange( restrictRange.normalized() );
+		from = restrictRange.start();
+		to = restrictRange.end();
+	}
+
+	String search( caseSensitive ? text : String::toLower( text ) );
+
+	const auto scanLines = [&]( Int64 firstLine, Int64 lastLine, TextRanges& ranges ) {
+		const TextDocumentRope& lines = mLines;
+		String lowerLine;
+		for ( Int64 i = firstLine; i <= lastLine; i++ ) {
+			const String& lineText = lines[i].getText();
+			const String* haystack = &lineText;
+			if ( !caseSensitive ) {
+				lowerLine = String::toLower( lineText );
+				haystack = &lowerLine;
+			}
+			size_t start = i == from.line() ? from.column() : 0;
+			size_t end = i == to.line() ? eemin<size_t>( to.column(), haystack->size() )
+										: haystack->size();
+			size_t pos = haystack->find( search, start );
+			while ( pos != String::InvalidPos && pos + search.size() <= end ) {
+				if ( !wholeWord || String::isWholeWord( lineText, search, pos ) ) {
+					TextRange range( { i, (Int64)pos }, { i, (Int64)( pos + search.size() ) } );
+					if ( range.end().column() == (Int64)lineText.size() )
+						range.setEnd( { i + 1, 0 } );
+					ranges.push_back( range );
+					pos += search.size();
+				} else {
+					pos++;
+				}
+				pos = haystack->find( search, pos );
+			}
+		}
+	};
+
+	// Big documents are split in chunks of lines that are scanned in parallel in the document
+	// thread pool, every chunk keeps its own results so they are already sorted when joined
+	Int64 linesCount = to.line() - from.line() + 1;
+	std::shared_ptr<ThreadPool> pool( mHighlighter ? mHighlighter->getThreadPool() : nullptr );
+
+	if ( !pool || pool->numThreads() == 0 || linesCount < FindAllMinLinesPerThread * 2 ) {
+		scanLines( from.line(), to.line(), all );
+	} else {
+		// Chunks are at least FindAllMinLinesPerThread lines long, so their first line identifies
+		// them
+		std::vector<TextRanges> results( linesCount / FindAllMinLinesPerThread + 1 );
+		pool->parallelFor(
+			from.line(), to.line() + 1,
+			[&]( Int64 chunkBegin, Int64 chunkEnd ) {
+				scanLines( chunkBegin, chunkEnd - 1,
+						   results[( chunkBegin - from.line() ) / FindAllMinLinesPerThread] );
+			},
+			FindAllMinLinesPerThread );
+
+		size_t total = 0;
+		for ( const auto& result : results )
+			total += result.size();
+		all.reserve( total );
+		for ( const auto& result : results )
+			all.insert( all.end(), result.begin(), result.end() );
+	}
+
+	if ( !all.empty() )
+		all.setSorted();
+	return all;
+}
+
 int TextDocument::replaceAll( const String& text, const String& replace, const bool& caseSensitive,
 							  const bool& wholeWord, const FindReplaceType& type,
 							  TextRange restrictRange ) {
 	if ( text.empty() )
 		return 0;
+	if ( isLiteralSearch( text, type ) && replace.find( '\n' ) == String::InvalidPos )
+		return replaceAllLiteral( text, replace, caseSensitive, wholeWord, restrictRange );
 	int count = 0;
 	TextRange found;
 	TextPosition startedPosition = getSelection().start();
 	TextPosition from = startOfDoc();
 	if ( restrictRange.isValid() )
 		from = restrictRange.normalized().start();
+	// All the replacements are undone as a single step
+	mUndoStack.beginTransaction( mTimer.getElapsedTime() );
 	do {
 		found = find( text, from, caseSensitive, wholeWord, type, restrictRange );
 		if ( found.isValid() ) {
@@ -2358,10 +2703,124 @@ int TextDocument::replaceAll( const String& text, const String& replace, const b
 			count++;
 		}
 	} while ( found.isValid() && endOfDoc() != found.end() );
+	mUndoStack.endTransaction();
 	setSelection( startedPosition );
 	return count;
 }
 
+int TextDocument::replaceAllLiteral( const String& text, const String& replace,
+									const bool& caseSensitive, const bool& wholeWord,
+									TextRange restrictRange ) {
+	TextRanges found = findAllLiteral( text, caseSensitive, wholeWord, restrictRange );
+	if ( found.empty() )
+		return 0;
+
+	// Every line is rewritten once and its previous text is recorded in a single lines command,
+	// so undo and redo restore all the lines at once and notify the change once too
+	TextPosition startedPosition = getSelection().start();
+	mUndoStack.clearRedoStack();
+	UndoStackContainer& undoStack = mUndoStack.getUndoStackContainer();
+	Time time( mUndoStack.getTransactionTime( mTimer.getElapsedTime() ) );
+	mUndoStack.pushSelection( undoStack, 0, mSelection, time );
+
+	const Int64 textSize = text.size();
+	const Int64 replaceSize = replace.size();
+	TextPosition changeStart( found.front().start() );
+	TextPosition changeEnd;
+	String changeText;
+	std::string undoLines;
+	size_t index = 0;
+
+	while ( index < found.size() ) {
+		Int64 lineIdx = found[index].start().line();
+		const String& oldLine = mLines[lineIdx].getText();
+		String newLine;
+		newLine.reserve( oldLine.size() + eemax<Int64>( 0, replaceSize - textSize ) * 4 );
+		Int64 last = 0;
+		Int64 shift = 0;
+		Int64 lastEnd = 0;
+
+		UndoStack::appendLinePayload( undoLines, lineIdx, oldLine );
+
+		for ( ; index < found.size() && found[index].start().line() == lineIdx; index++ ) {
+			Int64 col = found[index].start().column();
+			TextPosition pos( lineIdx, col + shift );
+			newLine += oldLine.substr( last, col - last );
+			newLine += replace;
+			last = col + textSize;
+			shift += replaceSize - textSize;
+			lastEnd = pos.column() + replaceSize;
+			changeEnd = { lineIdx, last };
+		}
+
+		newLine += oldLine.substr( last );
+
+		if ( lineIdx == changeStart.line() ) {
+			changeText = newLine.substr( changeStart.column(), lastEnd - changeStart.column() );
+		} else {
+			changeText += newLine.substr( 0, lastEnd );
+		}
+
+		mLines[lineIdx].setText( std::move( newLine ) );
+		notifyLineChanged( lineIdx );
+
+		// The lines between the lines that changed are part of the change too
+		if ( index < found.size() ) {
+			const String& endText = mLines[lineIdx].getText();
+			changeText += endText.substr( lastEnd );
+			for ( Int64 i = lineIdx + 1; i < found[index].start().line(); i++ )
+				changeText += mLines[i].getText();
+		}
+	}
+
+	mUndoStack.pushLines( undoStack, undoLines,
+						  { { changeStart.line(), 0 }, { changeEnd.line(), 0 } }, time );
+	notifyTextChanged( { { changeStart, changeEnd }, changeText } );
+	setSelection( startedPosition );
+	return found.size();
+}
+
+void TextDocument::replaceLines( const std::string& payload, UndoStackContainer& undoStack,
+								 const Time& time ) {
+	if ( payload.empty() )
+		return;
+
+	mUndoStack.pushSelection( undoStack, 0, mSelection, time );
+
+	std::string replacedLines;
+	replacedLines.reserve( payload.size() );
+	const char* cur = payload.data();
+	const char* end = cur + payload.size();
+	Int64 firstLine = -1;
+	Int64 lastLine = -1;
+	Int64 lastLineLength = 0;
+	String text;
+
+	while ( cur < end ) {
+		Int64 lineIdx;
+		cur = UndoStack::readLinePayload( cur, lineIdx, text );
+		eeASSERT( lineIdx >= 0 && lineIdx < (Int64)mLines.size() );
+		const String& oldText = mLines[lineIdx].getText();
+		UndoStack::appendLinePayload( replacedLines, lineIdx, oldText );
+		if ( firstLine == -1 )
+			firstLine = lineIdx;
+		lastLine = lineIdx;
+		lastLineLength = oldText.size();
+		mLines[lineIdx].setText( std::move( text ) );
+		notifyLineChanged( lineIdx );
+	}
+
+	mUndoStack.pushLines( undoStack, replacedLines, { { firstLine, 0 }, { lastLine, 0 } }, time );
+
+	// Lines always end with a new line, the change spans from the start of the first line to the
+	// end of the last one ( without its new line )
+	String changeText;
+	for ( Int64 i = firstLine; i <= lastLine; i++ )
+		changeText += mLines[i].getText();
+	changeText.pop_back();
+	notifyTextChanged( { { { firstLine, 0 }, { lastLine, lastLineLength - 1 } }, changeText } );
+}
+
 TextPosition TextDocument::replaceSelection( const String& replace ) {
 	return replaceSelection( 0, replace );
 }
@@ -2431,7 +2890,7 @@ TextPosition TextDocument::getMatchingBracket( TextPosition sp,
 		if ( byte == openBracket ) {
 			if ( highlighter ) {
 				auto type = highlighter->getTokenTypeAt( sp );
-				if ( type != "comment" && type != "string" )
+				if ( type != SyntaxStyleTypes::Comment && type != SyntaxStyleTypes::Str )
 					depth++;
 			} else {
 				depth++;
@@ -2442,7 +2901,7 @@ TextPosition TextDocument::getMatchingBracket( TextPosition sp,
 		} else if ( byte == closeBracket ) {
 			if ( highlighter ) {
 				auto type = highlighter->getTokenTypeAt( sp );
-				if ( type != "comment" && type != "string" )
+				if ( type != SyntaxStyleTypes::Comment && type != SyntaxStyleTypes::Str )
 					depth--;
 			} else {
 				depth--;
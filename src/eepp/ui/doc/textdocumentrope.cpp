@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <eepp/core/debug.hpp>
+#include <eepp/ui/doc/textdocumentrope.hpp>
+#include <iterator>
+
+namespace EE { namespace UI { namespace Doc {
+
+TextDocumentRope::TextDocumentRope() {}
+
+size_t TextDocumentRope::size() const {
+	return mSize;
+}
+
+bool TextDocumentRope::empty() const {
+	return mSize == 0;
+}
+
+void TextDocumentRope::clear() {
+	mChunks.clear();
+	mIndex.clear();
+	mSize = 0;
+}
+
+TextDocumentLine& TextDocumentRope::operator[]( const size_t& index ) {
+	eeASSERT( index < mSize );
+	size_t local = index;
+	size_t chunk = findChunk( local );
+	return mChunks[chunk][local];
+}
+
+const TextDocumentLine& TextDocumentRope::operator[]( const size_t& index ) const {
+	eeASSERT( index < mSize );
+	size_t local = index;
+	size_t chunk = findChunk( local );
+	return mChunks[chunk][local];
+}
+
+TextDocumentLine& TextDocumentRope::front() {
+	return mChunks.front().front();
+}
+
+const TextDocumentLine& TextDocumentRope::front() const {
+	return mChunks.front().front();
+}
+
+TextDocumentLine& TextDocumentRope::back() {
+	return mChunks.back().back();
+}
+
+const TextDocumentLine& TextDocumentRope::back() const {
+	return mChunks.back().back();
+}
+
+void TextDocumentRope::push_back( TextDocumentLine&& line ) {
+	if ( mChunks.empty() || mChunks.back().size() >= MaxChunkSize )
+		appendChunk();
+	mChunks.back().emplace_back( std::move( line ) );
+	mSize++;
+	mIndex.update( mChunks.size() - 1, 1 );
+}
+
+void TextDocumentRope::push_back( const TextDocumentLine& line ) {
+	push_back( TextDocumentLine( line ) );
+}
+
+void TextDocumentRope::emplace_back( String&& text ) {
+	push_back( TextDocumentLine( std::move( text ) ) );
+}
+
+void TextDocumentRope::emplace_back( const String& text ) {
+	push_back( TextDocumentLine( text ) );
+}
+
+void TextDocumentRope::insert( const size_t& index, TextDocumentLine&& line ) {
+	size_t local = index;
+	size_t chunk = findChunkForInsert( local );
+	auto& lines = mChunks[chunk];
+	lines.insert( lines.begin() + local, std::move( line ) );
+	mSize++;
+	if ( lines.size() > MaxChunkSize ) {
+		splitChunk( chunk );
+	} else {
+		mIndex.update( chunk, 1 );
+	}
+}
+
+void TextDocumentRope::insert( const size_t& index, std::vector<TextDocumentLine>&& newLines ) {
+	if ( newLines.empty() )
+		return;
+	size_t local = index;
+	size_t chunk = findChunkForInsert( local );
+	auto& lines = mChunks[chunk];
+	lines.insert( lines.begin() + local, std::make_move_iterator( newLines.begin() ),
+				  std::make_move_iterator( newLines.end() ) );
+	mSize += newLines.size();
+	if ( lines.size() > MaxChunkSize ) {
+		splitChunk( chunk );
+	} else {
+		mIndex.update( chunk, newLines.size() );
+	}
+}
+
+void TextDocumentRope::erase( const size_t& index ) {
+	erase( index, index + 1 );
+}
+
+void TextDocumentRope::erase( const size_t& first, const size_t& last ) {
+	eeASSERT( last <= mSize );
+	if ( first >= last || first >= mSize )
+		return;
+	size_t local = first;
+	size_t chunk = findChunk( local );
+	size_t pending = eemin( last, mSize ) - first;
+
+	// Fast path, the range is contained in a single chunk that will not be emptied.
+	if ( pending < mChunks[chunk].size() && local + pending <= mChunks[chunk].size() ) {
+		auto& lines = mChunks[chunk];
+		lines.erase( lines.begin() + local, lines.begin() + local + pending );
+		mSize -= pending;
+		mIndex.update( chunk, -static_cast<Int64>( pending ) );
+		return;
+	}
+
+	while ( pending && chunk < mChunks.size() ) {
+		auto& lines = mChunks[chunk];
+		size_t count = eemin( pending, lines.size() - local );
+		lines.erase( lines.begin() + local, lines.begin() + local + count );
+		pending -= count;
+		mSize -= count;
+		local = 0;
+		chunk++;
+	}
+
+	mChunks.erase( std::remove_if( mChunks.begin(), mChunks.end(),
+								   []( const std::vector<TextDocumentLine>& lines ) {
+									   return lines.empty();
+								   } ),
+				   mChunks.end() );
+	rebuildIndex();
+}
+
+void TextDocumentRope::shrinkToFit() {
+	for ( auto& chunk : mChunks )
+		chunk.shrink_to_fit();
+	mChunks.shrink_to_fit();
+}
+
+size_t TextDocumentRope::chunksCount() const {
+	return mChunks.size();
+}
+
+size_t TextDocumentRope::findChunk( size_t& index ) const {
+	return mIndex.find( index );
+}
+
+size_t TextDocumentRope::findChunkForInsert( size_t& index ) {
+	if ( index >= mSize ) {
+		if ( mChunks.empty() || mChunks.back().size() >= MaxChunkSize )
+			appendChunk();
+		index = mChunks.back().size();
+		return mChunks.size() - 1;
+	}
+	return findChunk( index );
+}
+
+void TextDocumentRope::appendChunk() {
+	mChunks.emplace_back();
+	mChunks.back().reserve( MaxChunkSize );
+	mIndex.append();
+}
+
+void TextDocumentRope::rebuildIndex() {
+	mIndex.rebuild( mChunks.size(), [this]( const size_t& chunk ) {
+		return ChunkIndex<>::Sizes{ mChunks[chunk].size() };
+	} );
+}
+
+void TextDocumentRope::splitChunk( const size_t& chunk ) {
+	const size_t half = MaxChunkSize / 2;
+	std::vector<std::vector<TextDocumentLine>> pieces;
+	{
+		auto& lines = mChunks[chunk];
+		for ( size_t pos = half; pos < lines.size(); pos += half ) {
+			size_t end = eemin( pos + half, lines.size() );
+			pieces.emplace_back( std::make_move_iterator( lines.begin() + pos ),
+								 std::make_move_iterator( lines.begin() + end ) );
+		}
+		lines.erase( lines.begin() + half, lines.end() );
+	}
+	mChunks.insert( mChunks.begin() + chunk + 1, std::make_move_iterator( pieces.begin() ),
+					std::make_move_iterator( pieces.end() ) );
+	rebuildIndex();
+}
+
+}}} // namespace EE::UI::Doc
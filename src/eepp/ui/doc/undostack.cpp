@@ -1,81 +1,93 @@
+#include <cstring>
 #include <eepp/core/core.hpp>
 #include <eepp/ui/doc/textdocument.hpp>
 #include <eepp/ui/doc/undostack.hpp>
+#include <iterator>
 
 using namespace EE::System;
 
 namespace EE { namespace UI { namespace Doc {
 
-TextUndoCommand::TextUndoCommand( const Uint64& id, const TextUndoCommandType& type,
-								  const Time& timestamp ) :
-	mId( id ), mType( type ), mTimestamp( timestamp ) {}
+static_assert( std::is_trivially_copyable<TextRange>::value,
+			   "TextRange must be trivially copyable to be stored in the journal" );
 
-TextUndoCommand::~TextUndoCommand() {}
-
-const Uint64& TextUndoCommand::getId() const {
-	return mId;
+bool UndoStackContainer::empty() const {
+	return mCommands.empty();
 }
 
-const TextUndoCommandType& TextUndoCommand::getType() const {
-	return mType;
+size_t UndoStackContainer::size() const {
+	return mCommands.size();
 }
 
-const Time& TextUndoCommand::getTimestamp() const {
-	return mTimestamp;
+void UndoStackContainer::clear() {
+	mCommands.clear();
+	mJournal.clear();
+	mJournalHead = 0;
+	mMemoryUsage = 0;
 }
 
-TextUndoCommandInsert::TextUndoCommandInsert( const Uint64& id, const size_t& cursorIdx,
-											  const String& text, const TextPosition& position,
-											  const Time& timestamp ) :
-	TextUndoCommand( id, TextUndoCommandType::Insert, timestamp ),
-	mText( text ),
-	mPosition( position ),
-	mCursorIdx( cursorIdx ) {}
-
-const String& TextUndoCommandInsert::getText() const {
-	return mText;
+const UndoStackContainer::Command& UndoStackContainer::back() const {
+	return mCommands.back();
 }
 
-const TextPosition& TextUndoCommandInsert::getPosition() const {
-	return mPosition;
+const char* UndoStackContainer::backPayload() const {
+	const Command& cmd = mCommands.back();
+	if ( cmd.payloadSize == 0 )
+		return nullptr;
+	const std::string& chunk = mJournal.back();
+	return chunk.data() + chunk.size() - cmd.payloadSize;
 }
 
-size_t TextUndoCommandInsert::getCursorIdx() const {
-	return mCursorIdx;
-}
-
-TextUndoCommandRemove::TextUndoCommandRemove( const Uint64& id, const size_t& cursorIdx,
-											  const TextRange& range, const Time& timestamp ) :
-	TextUndoCommand( id, TextUndoCommandType::Remove, timestamp ),
-	mRange( range ),
-	mCursorIdx( cursorIdx ) {}
-
-const TextRange& TextUndoCommandRemove::getRange() const {
-	return mRange;
+void UndoStackContainer::push( const Command& cmd, const char* payload ) {
+	if ( cmd.payloadSize ) {
+		// A payload never spans two chunks, so it's always at the end of the last chunk while
+		// its command is the last one
+		if ( mJournal.empty() ||
+			 mJournal.back().size() + cmd.payloadSize > mJournal.back().capacity() ) {
+			mJournal.emplace_back();
+			mJournal.back().reserve( eemax<size_t>( JournalChunkSize, cmd.payloadSize ) );
+		}
+		mJournal.back().append( payload, cmd.payloadSize );
+	}
+	mCommands.push_back( cmd );
+	mMemoryUsage += sizeof( Command ) + cmd.payloadSize;
 }
 
-size_t TextUndoCommandRemove::getCursorIdx() const {
-	return mCursorIdx;
+void UndoStackContainer::popBack() {
+	const Command& cmd = mCommands.back();
+	mMemoryUsage -= sizeof( Command ) + cmd.payloadSize;
+	if ( cmd.payloadSize ) {
+		std::string& chunk = mJournal.back();
+		chunk.resize( chunk.size() - cmd.payloadSize );
+		if ( chunk.size() == ( mJournal.size() == 1 ? mJournalHead : 0 ) ) {
+			mJournal.pop_back();
+			if ( mJournal.empty() )
+				mJournalHead = 0;
+		}
+	}
+	mCommands.pop_back();
 }
 
-TextUndoCommandSelection::TextUndoCommandSelection( const Uint64& id, const size_t& cursorIdx,
-													const TextRanges& selection,
-													const Time& timestamp ) :
-	TextUndoCommand( id, TextUndoCommandType::Selection, timestamp ),
-	mSelection( selection ),
-	mCursorIdx( cursorIdx ) {}
-
-const TextRanges& TextUndoCommandSelection::getSelection() const {
-	return mSelection;
+void UndoStackContainer::popFront() {
+	const Command& cmd = mCommands.front();
+	mMemoryUsage -= sizeof( Command ) + cmd.payloadSize;
+	if ( cmd.payloadSize ) {
+		mJournalHead += cmd.payloadSize;
+		if ( mJournalHead == mJournal.front().size() ) {
+			mJournal.pop_front();
+			mJournalHead = 0;
+		}
+	}
+	mCommands.pop_front();
 }
 
-size_t TextUndoCommandSelection::getCursorIdx() const {
-	return mCursorIdx;
+size_t UndoStackContainer::getMemoryUsage() const {
+	return mMemoryUsage;
 }
 
-UndoStack::UndoStack( TextDocument* owner, const Uint32& maxStackSize ) :
+UndoStack::UndoStack( TextDocument* owner, const size_t& maxMemorySize ) :
 	mDoc( owner ),
-	mMaxStackSize( maxStackSize ),
+	mMaxMemorySize( maxMemorySize ),
 	mChangeIdCounter( 0 ),
 	mMergeTimeout( Milliseconds( 300.f ) ) {}
 
@@ -89,80 +101,132 @@ void UndoStack::clear() {
 }
 
 void UndoStack::clearUndoStack() {
-	for ( TextUndoCommand* cmd : mUndoStack ) {
-		eeDelete( cmd );
-	}
 	mUndoStack.clear();
 }
 
 void UndoStack::clearRedoStack() {
-	for ( TextUndoCommand* cmd : mRedoStack ) {
-		eeDelete( cmd );
-	}
 	mRedoStack.clear();
 }
 
-void UndoStack::pushUndo( UndoStackContainer& undoStack, TextUndoCommand* cmd ) {
-	undoStack.push_back( cmd );
-	while ( undoStack.size() > mMaxStackSize ) {
-		eeDelete( undoStack.front() );
-		undoStack.pop_front();
+void UndoStack::pushUndo( UndoStackContainer& undoStack, UndoStackContainer::Command& cmd,
+						  const char* payload ) {
+	cmd.id = ++mChangeIdCounter;
+	undoStack.push( cmd, payload );
+	while ( undoStack.size() > 1 &&
+			mUndoStack.getMemoryUsage() + mRedoStack.getMemoryUsage() > mMaxMemorySize ) {
+		undoStack.popFront();
 	}
 }
 
 void UndoStack::pushInsert( UndoStackContainer& undoStack, const String& string,
 							const size_t& cursorIdx, const TextPosition& position,
 							const Time& time ) {
-	pushUndo( undoStack, eeNew( TextUndoCommandInsert,
-								( ++mChangeIdCounter, cursorIdx, string, position, time ) ) );
+	// The text is stored as UTF-8, it's usually a fourth of its UTF-32 size
+	mPayloadBuffer.clear();
+	Utf32::toUtf8( string.begin(), string.end(), std::back_inserter( mPayloadBuffer ) );
+	UndoStackContainer::Command cmd;
+	cmd.type = TextUndoCommandType::Insert;
+	cmd.timestamp = time;
+	cmd.cursorIdx = cursorIdx;
+	cmd.range = { position, position };
+	cmd.payloadSize = mPayloadBuffer.size();
+	pushUndo( undoStack, cmd, mPayloadBuffer.data() );
 }
 
 void UndoStack::pushRemove( UndoStackContainer& undoStack, const size_t& cursorIdx,
 							const TextRange& range, const Time& time ) {
-	pushUndo( undoStack,
-			  eeNew( TextUndoCommandRemove, ( ++mChangeIdCounter, cursorIdx, range, time ) ) );
+	UndoStackContainer::Command cmd;
+	cmd.type = TextUndoCommandType::Remove;
+	cmd.timestamp = time;
+	cmd.cursorIdx = cursorIdx;
+	cmd.range = range;
+	pushUndo( undoStack, cmd, nullptr );
 }
 
 void UndoStack::pushSelection( UndoStackContainer& undoStack, const size_t& cursorIdx,
 							   const TextRanges& selection, const Time& time ) {
-	pushUndo( undoStack, eeNew( TextUndoCommandSelection,
-								( ++mChangeIdCounter, cursorIdx, selection, time ) ) );
+	UndoStackContainer::Command cmd;
+	cmd.type = TextUndoCommandType::Selection;
+	cmd.timestamp = time;
+	cmd.cursorIdx = cursorIdx;
+	cmd.sorted = selection.isSorted();
+	cmd.payloadSize = selection.size() * sizeof( TextRange );
+	pushUndo( undoStack, cmd, reinterpret_cast<const char*>( selection.data() ) );
+}
+
+void UndoStack::pushLines( UndoStackContainer& undoStack, const std::string& payload,
+						   const TextRange& range, const Time& time ) {
+	UndoStackContainer::Command cmd;
+	cmd.type = TextUndoCommandType::Lines;
+	cmd.timestamp = time;
+	cmd.range = range;
+	cmd.payloadSize = payload.size();
+	pushUndo( undoStack, cmd, payload.data() );
+}
+
+void UndoStack::appendLinePayload( std::string& payload, const Int64& line, const String& text ) {
+	// Every line is stored as its index, the size of its text and its text in UTF-8
+	size_t pos = payload.size();
+	payload.resize( pos + sizeof( Int64 ) + sizeof( Uint32 ) );
+	memcpy( &payload[pos], &line, sizeof( Int64 ) );
+	size_t textPos = payload.size();
+	Utf32::toUtf8( text.begin(), text.end(), std::back_inserter( payload ) );
+	Uint32 textSize = payload.size() - textPos;
+	memcpy( &payload[pos + sizeof( Int64 )], &textSize, sizeof( Uint32 ) );
+}
+
+const char* UndoStack::readLinePayload( const char* payload, Int64& line, String& text ) {
+	Uint32 textSize;
+	memcpy( &line, payload, sizeof( Int64 ) );
+	memcpy( &textSize, payload + sizeof( Int64 ), sizeof( Uint32 ) );
+	payload += sizeof( Int64 ) + sizeof( Uint32 );
+	text = String::fromUtf8( payload, payload + textSize );
+	return payload + textSize;
 }
 
 void UndoStack::popUndo( UndoStackContainer& undoStack, UndoStackContainer& redoStack ) {
-	if ( undoStack.empty() )
-		return;
-
-	TextUndoCommand* cmd = undoStack.back();
-	Time lastTimestamp = cmd->getTimestamp();
-	undoStack.pop_back();
-
-	switch ( cmd->getType() ) {
-		case TextUndoCommandType::Insert: {
-			TextUndoCommandInsert* insert = static_cast<TextUndoCommandInsert*>( cmd );
-			mDoc->insert( insert->getCursorIdx(), insert->getPosition(), insert->getText(),
-						  redoStack, cmd->getTimestamp(), true );
-			break;
-		}
-		case TextUndoCommandType::Remove: {
-			TextUndoCommandRemove* remove = static_cast<TextUndoCommandRemove*>( cmd );
-			mDoc->remove( remove->getCursorIdx(), remove->getRange(), redoStack,
-						  cmd->getTimestamp(), true );
-			break;
-		}
-		case TextUndoCommandType::Selection: {
-			TextUndoCommandSelection* selection = static_cast<TextUndoCommandSelection*>( cmd );
-			mDoc->resetSelection( selection->getSelection() );
-			break;
+	// Commands close in time are applied together, a batched edit can record thousands of them
+	while ( !undoStack.empty() ) {
+		// The command is copied out of the container, it's popped before being applied
+		UndoStackContainer::Command cmd = undoStack.back();
+		const char* payload = undoStack.backPayload();
+
+		switch ( cmd.type ) {
+			case TextUndoCommandType::Insert: {
+				String text( String::fromUtf8( payload, payload + cmd.payloadSize ) );
+				undoStack.popBack();
+				mDoc->insert( cmd.cursorIdx, cmd.range.start(), text, redoStack, cmd.timestamp,
+							  true );
+				break;
+			}
+			case TextUndoCommandType::Remove: {
+				undoStack.popBack();
+				mDoc->remove( cmd.cursorIdx, cmd.range, redoStack, cmd.timestamp, true );
+				break;
+			}
+			case TextUndoCommandType::Selection: {
+				TextRanges selection;
+				selection.resize( cmd.payloadSize / sizeof( TextRange ) );
+				if ( cmd.payloadSize )
+					memcpy( static_cast<void*>( selection.data() ), payload, cmd.payloadSize );
+				if ( cmd.sorted )
+					selection.setSorted();
+				undoStack.popBack();
+				mDoc->resetSelection( selection );
+				break;
+			}
+			case TextUndoCommandType::Lines: {
+				std::string lines( payload, cmd.payloadSize );
+				undoStack.popBack();
+				mDoc->replaceLines( lines, redoStack, cmd.timestamp );
+				break;
+			}
 		}
-	}
-
-	eeSAFE_DELETE( cmd );
 
-	if ( !undoStack.empty() &&
-		 eeabs( ( lastTimestamp - undoStack.back()->getTimestamp() ).asMilliseconds() ) <
-			 mMergeTimeout.asMilliseconds() ) {
-		popUndo( undoStack, redoStack );
+		if ( undoStack.empty() ||
+			 eeabs( ( cmd.timestamp - undoStack.back().timestamp ).asMilliseconds() ) >=
+				 mMergeTimeout.asMilliseconds() )
+			break;
 	}
 }
 
@@ -182,8 +246,31 @@ bool UndoStack::hasRedo() const {
 	return !mRedoStack.empty();
 }
 
-const Uint32& UndoStack::getMaxStackSize() const {
-	return mMaxStackSize;
+const size_t& UndoStack::getMaxMemorySize() const {
+	return mMaxMemorySize;
+}
+
+void UndoStack::setMaxMemorySize( const size_t& maxMemorySize ) {
+	mMaxMemorySize = maxMemorySize;
+}
+
+void UndoStack::beginTransaction( const Time& time ) {
+	if ( mTransactionDepth++ == 0 )
+		mTransactionTime = time;
+}
+
+void UndoStack::endTransaction() {
+	eeASSERT( mTransactionDepth > 0 );
+	if ( mTransactionDepth > 0 )
+		mTransactionDepth--;
+}
+
+bool UndoStack::isInTransaction() const {
+	return mTransactionDepth > 0;
+}
+
+Time UndoStack::getTransactionTime( const Time& time ) const {
+	return mTransactionDepth ? mTransactionTime : time;
 }
 
 const Time& UndoStack::getMergeTimeout() const {
@@ -197,7 +284,7 @@ void UndoStack::setMergeTimeout( const Time& mergeTimeout ) {
 Uint64 UndoStack::getCurrentChangeId() const {
 	if ( mUndoStack.empty() )
 		return 0;
-	return mUndoStack.back()->getId();
+	return mUndoStack.back().id;
 }
 
 UndoStackContainer& UndoStack::getUndoStackContainer() {
@@ -0,0 +1,304 @@
+#include <algorithm>
+#include <eepp/core/debug.hpp>
+#include <eepp/ui/doc/visuallineindex.hpp>
+#include <iterator>
+
+namespace EE { namespace UI { namespace Doc {
+
+VisualLineIndex::VisualLineIndex() {}
+
+void VisualLineIndex::reset( const size_t& count ) {
+	clear();
+	for ( size_t pos = 0; pos < count; pos += MaxChunkSize ) {
+		mChunks.emplace_back();
+		Chunk& chunk = mChunks.back();
+		chunk.lines.resize( eemin( MaxChunkSize, count - pos ) );
+		chunk.rows = chunk.unmeasured = chunk.lines.size();
+	}
+	mLinesCount = mRowsCount = mUnmeasuredCount = count;
+	rebuildIndex();
+}
+
+void VisualLineIndex::clear() {
+	mChunks.clear();
+	mIndex.clear();
+	mLinesCount = 0;
+	mRowsCount = 0;
+	mUnmeasuredCount = 0;
+	mWidths.clear();
+}
+
+size_t VisualLineIndex::linesCount() const {
+	return mLinesCount;
+}
+
+size_t VisualLineIndex::rowsCount() const {
+	return mRowsCount;
+}
+
+size_t VisualLineIndex::unmeasuredCount() const {
+	return mUnmeasuredCount;
+}
+
+size_t VisualLineIndex::findUnmeasured( const size_t& index ) const {
+	if ( mUnmeasuredCount == 0 || index >= mLinesCount )
+		return mLinesCount;
+
+	size_t local = index;
+	size_t chunk = findChunk( local );
+	size_t lineIndex = index - local;
+
+	// Chunks without unmeasured lines are skipped.
+	for ( ; chunk < mChunks.size(); chunk++ ) {
+		const Chunk& cur = mChunks[chunk];
+		if ( cur.unmeasured ) {
+			for ( size_t i = local; i < cur.lines.size(); i++ ) {
+				if ( !cur.lines[i].measured )
+					return lineIndex + i;
+			}
+		}
+		lineIndex += cur.lines.size();
+		local = 0;
+	}
+
+	return mLinesCount;
+}
+
+void VisualLineIndex::invalidate() {
+	for ( auto& chunk : mChunks ) {
+		for ( auto& line : chunk.lines )
+			line.measured = false;
+		chunk.unmeasured = chunk.lines.size();
+	}
+	mUnmeasuredCount = mLinesCount;
+}
+
+void VisualLineIndex::insert( const size_t& index, const size_t& count ) {
+	if ( count == 0 )
+		return;
+
+	if ( mChunks.empty() ) {
+		reset( count );
+		return;
+	}
+
+	size_t local = index;
+	size_t chunk;
+	if ( index >= mLinesCount ) {
+		chunk = mChunks.size() - 1;
+		local = mChunks[chunk].lines.size();
+	} else {
+		chunk = findChunk( local );
+	}
+
+	Chunk& target = mChunks[chunk];
+	target.lines.insert( target.lines.begin() + local, count, Line() );
+	target.rows += count;
+	target.unmeasured += count;
+	target.rowsOffsetDirty = true;
+	mLinesCount += count;
+	mRowsCount += count;
+	mUnmeasuredCount += count;
+
+	if ( target.lines.size() > MaxChunkSize ) {
+		splitChunk( chunk );
+	} else {
+		updateIndex( chunk, count, count );
+	}
+}
+
+void VisualLineIndex::erase( const size_t& first, const size_t& last ) {
+	eeASSERT( last <= mLinesCount );
+	if ( first >= last || first >= mLinesCount )
+		return;
+
+	size_t local = first;
+	size_t chunk = findChunk( local );
+	size_t pending = eemin( last, mLinesCount ) - first;
+	bool emptied = false;
+	size_t firstChunk = chunk;
+	Int64 linesDelta = 0;
+	Int64 rowsDelta = 0;
+
+	while ( pending && chunk < mChunks.size() ) {
+		Chunk& cur = mChunks[chunk];
+		size_t count = eemin( pending, cur.lines.size() - local );
+		size_t rows = 0;
+		size_t unmeasured = 0;
+		for ( size_t i = local; i < local + count; i++ ) {
+			rows += cur.lines[i].rows();
+			if ( !cur.lines[i].measured )
+				unmeasured++;
+			removeWidth( cur.lines[i].width );
+		}
+		cur.lines.erase( cur.lines.begin() + local, cur.lines.begin() + local + count );
+		cur.rows -= rows;
+		cur.unmeasured -= unmeasured;
+		cur.rowsOffsetDirty = true;
+		emptied = emptied || cur.lines.empty();
+		pending -= count;
+		mLinesCount -= count;
+		mRowsCount -= rows;
+		mUnmeasuredCount -= unmeasured;
+		linesDelta -= count;
+		rowsDelta -= rows;
+		local = 0;
+		chunk++;
+	}
+
+	if ( !emptied && chunk == firstChunk + 1 ) {
+		updateIndex( firstChunk, linesDelta, rowsDelta );
+		return;
+	}
+
+	mChunks.erase( std::remove_if( mChunks.begin(), mChunks.end(),
+								   []( const Chunk& chunk ) { return chunk.lines.empty(); } ),
+				   mChunks.end() );
+	rebuildIndex();
+}
+
+void VisualLineIndex::setLine( const size_t& index, Line&& line ) {
+	eeASSERT( index < mLinesCount );
+	size_t local = index;
+	size_t chunk = findChunk( local );
+	Chunk& cur = mChunks[chunk];
+	Line& old = cur.lines[local];
+	Int64 rowsDelta = static_cast<Int64>( line.rows() ) - static_cast<Int64>( old.rows() );
+
+	if ( old.width != line.width ) {
+		removeWidth( old.width );
+		addWidth( line.width );
+	}
+
+	if ( !old.measured ) {
+		cur.unmeasured--;
+		mUnmeasuredCount--;
+	}
+
+	old = std::move( line );
+	old.measured = true;
+
+	if ( rowsDelta != 0 ) {
+		cur.rows += rowsDelta;
+		cur.rowsOffsetDirty = true;
+		mRowsCount += rowsDelta;
+		updateIndex( chunk, 0, rowsDelta );
+	}
+}
+
+const VisualLineIndex::Line& VisualLineIndex::getLine( const size_t& index ) const {
+	eeASSERT( index < mLinesCount );
+	size_t local = index;
+	size_t chunk = findChunk( local );
+	return mChunks[chunk].lines[local];
+}
+
+size_t VisualLineIndex::getLineFirstRow( const size_t& index ) const {
+	if ( index >= mLinesCount )
+		return mRowsCount;
+	size_t local = index;
+	size_t chunk = findChunk( local );
+	updateRowsOffset( mChunks[chunk] );
+	return mIndex.sizeBefore( chunk, IndexRows ) + mChunks[chunk].rowsOffset[local];
+}
+
+size_t VisualLineIndex::getLineFromRow( size_t row, size_t* rowInLine ) const {
+	if ( mLinesCount == 0 ) {
+		if ( rowInLine )
+			*rowInLine = 0;
+		return 0;
+	}
+
+	if ( row >= mRowsCount ) {
+		if ( rowInLine )
+			*rowInLine = mChunks.back().lines.back().rows() - 1;
+		return mLinesCount - 1;
+	}
+
+	size_t localRow = row;
+	size_t chunk = mIndex.find( localRow, IndexRows );
+	const Chunk& cur = mChunks[chunk];
+	updateRowsOffset( cur );
+	auto it = std::upper_bound( cur.rowsOffset.begin(), cur.rowsOffset.end(), localRow );
+	size_t local = std::distance( cur.rowsOffset.begin(), it ) - 1;
+	if ( rowInLine )
+		*rowInLine = localRow - cur.rowsOffset[local];
+
+	return mIndex.sizeBefore( chunk, IndexLines ) + local;
+}
+
+Float VisualLineIndex::getLongestLineWidth() const {
+	return mWidths.empty() ? 0.f : mWidths.rbegin()->first;
+}
+
+size_t VisualLineIndex::findChunk( size_t& index ) const {
+	return mIndex.find( index, IndexLines );
+}
+
+void VisualLineIndex::updateRowsOffset( const Chunk& chunk ) const {
+	if ( !chunk.rowsOffsetDirty )
+		return;
+	chunk.rowsOffset.resize( chunk.lines.size() );
+	size_t rows = 0;
+	for ( size_t i = 0; i < chunk.lines.size(); i++ ) {
+		chunk.rowsOffset[i] = rows;
+		rows += chunk.lines[i].rows();
+	}
+	chunk.rowsOffsetDirty = false;
+}
+
+void VisualLineIndex::updateIndex( const size_t& chunk, const Int64& linesDelta,
+								   const Int64& rowsDelta ) {
+	if ( linesDelta != 0 )
+		mIndex.update( chunk, linesDelta, IndexLines );
+	if ( rowsDelta != 0 )
+		mIndex.update( chunk, rowsDelta, IndexRows );
+}
+
+void VisualLineIndex::rebuildIndex() {
+	mIndex.rebuild( mChunks.size(), [this]( const size_t& chunk ) {
+		return ChunkIndex<2>::Sizes{ mChunks[chunk].lines.size(), mChunks[chunk].rows };
+	} );
+}
+
+void VisualLineIndex::splitChunk( const size_t& chunk ) {
+	const size_t half = MaxChunkSize / 2;
+	std::vector<Chunk> pieces;
+	{
+		Chunk& cur = mChunks[chunk];
+		for ( size_t pos = half; pos < cur.lines.size(); pos += half ) {
+			size_t end = eemin( pos + half, cur.lines.size() );
+			pieces.emplace_back();
+			Chunk& piece = pieces.back();
+			piece.lines.assign( std::make_move_iterator( cur.lines.begin() + pos ),
+								std::make_move_iterator( cur.lines.begin() + end ) );
+			for ( const auto& line : piece.lines ) {
+				piece.rows += line.rows();
+				if ( !line.measured )
+					piece.unmeasured++;
+			}
+			cur.rows -= piece.rows;
+			cur.unmeasured -= piece.unmeasured;
+		}
+		cur.lines.erase( cur.lines.begin() + half, cur.lines.end() );
+		cur.rowsOffsetDirty = true;
+	}
+	mChunks.insert( mChunks.begin() + chunk + 1, std::make_move_iterator( pieces.begin() ),
+					std::make_move_iterator( pieces.end() ) );
+	rebuildIndex();
+}
+
+void VisualLineIndex::addWidth( const Float& width ) {
+	if ( width > 0 )
+		mWidths[width]++;
+}
+
+void VisualLineIndex::removeWidth( const Float& width ) {
+	if ( width <= 0 )
+		return;
+	auto it = mWidths.find( width );
+	if ( it != mWidths.end() && --it->second == 0 )
+		mWidths.erase( it );
+}
+
+}}} // namespace EE::UI::Doc
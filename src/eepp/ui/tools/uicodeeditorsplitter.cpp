@@ -9,6 +9,9 @@ using namespace EE::System;
 
 namespace EE { namespace UI { namespace Tools {
 
+// Files bigger than this are loaded incrementally, displaying the first lines as soon as possible.
+static const Uint64 INCREMENTAL_LOAD_MIN_FILE_SIZE = 16 * EE_1MB;
+
 const std::map<KeyBindings::Shortcut, std::string> UICodeEditorSplitter::getDefaultKeybindings() {
 	auto keybindings = UICodeEditor::getDefaultKeybindings();
 	auto localKeybindings = getLocalDefaultKeybindings();
@@ -359,12 +362,16 @@ void UICodeEditorSplitter::loadAsyncFileFromPath(
 					onLoaded( codeEditor, path );
 			} );
 	} else {
-		codeEditor->loadAsyncFromFile(
-			path, pool, [&, codeEditor, path, onLoaded]( std::shared_ptr<TextDocument>, bool ) {
-				mClient->onDocumentLoaded( codeEditor, path );
-				if ( onLoaded )
-					onLoaded( codeEditor, path );
-			} );
+		auto onDocLoaded = [&, codeEditor, path, onLoaded]( std::shared_ptr<TextDocument>, bool ) {
+			mClient->onDocumentLoaded( codeEditor, path );
+			if ( onLoaded )
+				onLoaded( codeEditor, path );
+		};
+		if ( FileSystem::fileSize( path ) >= INCREMENTAL_LOAD_MIN_FILE_SIZE ) {
+			codeEditor->loadAsyncIncrementalFromFile( path, pool, onDocLoaded );
+		} else {
+			codeEditor->loadAsyncFromFile( path, pool, onDocLoaded );
+		}
 	}
 #else
 	loadFileFromPath( path, codeEditor );
@@ -177,6 +177,9 @@ UICodeEditor::~UICodeEditor() {
 	while ( mHighlightWordProcessing )
 		Sys::sleep( Milliseconds( 1 ) );
 
+	if ( mIncrementalLoading )
+		mDoc->detachIncrementalLoadCallback();
+
 	if ( mDoc.use_count() == 1 ) {
 		DocEvent event( this, mDoc.get(), Event::OnDocumentClosed );
 		sendEvent( &event );
@@ -209,19 +212,24 @@ void UICodeEditor::draw() {
 	if ( mFont == NULL )
 		return;
 
-	if ( mDisplayLoaderIfDocumentLoading && mDoc->isLoading() ) {
+	// Documents loaded incrementally are displayed as soon as their first lines are available.
+	bool isLoading = mDoc->isLoading() && !mDoc->isLoadingIncrementally();
+
+	if ( mDisplayLoaderIfDocumentLoading && isLoading ) {
 		UILoader* loader = getLoader();
 		loader->setParent( this );
 		loader->setVisible( true );
 		loader->setEnabled( false );
 		loader->setPixelsSize( getPixelsSize() );
-	} else if ( mLoader != nullptr && !mDoc->isLoading() && mLoader->isVisible() ) {
+	} else if ( mLoader != nullptr && !isLoading && mLoader->isVisible() ) {
 		mLoader->setVisible( false );
 	}
 
-	if ( mDoc->isLoading() )
+	if ( isLoading )
 		return;
 
+	updateVisualLines();
+
 	if ( mDirtyEditor )
 		updateEditor();
 
@@ -251,11 +259,11 @@ void UICodeEditor::draw() {
 
 	if ( !mLocked && mHighlightCurrentLine ) {
 		for ( const auto& cursor : mDoc->getSelections() ) {
+			Float lineTop = getLineYOffset( cursor.start().line() );
 			primitives.setColor( Color( mCurrentLineBackgroundColor ).blendAlpha( mAlpha ) );
-			primitives.drawRectangle(
-				Rectf( Vector2f( startScroll.x + mScroll.x,
-								 startScroll.y + cursor.start().line() * lineHeight ),
-					   Sizef( mSize.getWidth(), lineHeight ) ) );
+			primitives.drawRectangle( Rectf(
+				Vector2f( startScroll.x + mScroll.x, startScroll.y + lineTop ),
+				Sizef( mSize.getWidth(), getLineYOffset( cursor.start().line() + 1 ) - lineTop ) ) );
 		}
 	}
 
@@ -308,8 +316,7 @@ void UICodeEditor::draw() {
 	for ( unsigned long i = lineRange.first; i <= lineRange.second; i++ ) {
 		Lock l( mDoc->getHighlighter()->getLinesMutex() );
 
-		Vector2f curScroll(
-			{ startScroll.x, static_cast<float>( startScroll.y + lineHeight * (double)i ) } );
+		Vector2f curScroll( { startScroll.x, startScroll.y + getLineYOffset( i ) } );
 
 		for ( auto& plugin : mPlugins )
 			plugin->drawBeforeLineText( this, i, curScroll, charSize, lineHeight );
@@ -359,7 +366,7 @@ void UICodeEditor::scheduledUpdate( const Time& ) {
 		if ( mBlinkTime != Time::Zero && mBlinkTimer.getElapsedTime() > mBlinkTime ) {
 			mCursorVisible = !mCursorVisible;
 			mBlinkTimer.restart();
-			invalidateDraw();
+			invalidateCursors();
 		}
 	}
 
@@ -377,11 +384,22 @@ void UICodeEditor::scheduledUpdate( const Time& ) {
 	if ( !mVisible )
 		return;
 
-	if ( mDoc && !mDoc->isLoading() &&
+	if ( mDoc && !mDoc->getHighlighter()->getThreadPool() &&
+		 getUISceneNode()->hasThreadPool() ) {
+		mDoc->getHighlighter()->setThreadPool( getUISceneNode()->getThreadPool() );
+	}
+
+	if ( mDoc && ( !mDoc->isLoading() || mDoc->isLoadingIncrementally() ) &&
 		 mDoc->getHighlighter()->updateDirty( getVisibleLinesCount() ) ) {
 		invalidateDraw();
 	}
 
+	if ( mDoc && !mVisualLinesDirty && mVisualLines.unmeasuredCount() > 0 &&
+		 mVisualLines.linesCount() == mDoc->linesCount() &&
+		 ( !mDoc->isLoading() || mDoc->isLoadingIncrementally() ) ) {
+		measurePendingVisualLines();
+	}
+
 	if ( mDoc && !mDoc->isLoading() && mHorizontalScrollBarEnabled && hasFocus() &&
 		 mLongestLineWidthDirty &&
 		 mLongestLineWidthLastUpdate.getElapsedTime() > mFindLongestLineWidthUpdateFrequency ) {
@@ -407,6 +425,7 @@ void UICodeEditor::updateLongestLineWidth() {
 void UICodeEditor::reset() {
 	mDoc->reset();
 	mDoc->getHighlighter()->reset();
+	invalidateVisualLines();
 	invalidateDraw();
 }
 
@@ -453,6 +472,60 @@ bool UICodeEditor::loadAsyncFromFile(
 	return ret;
 }
 
+bool UICodeEditor::loadAsyncIncrementalFromFile(
+	const std::string& path, std::shared_ptr<ThreadPool> pool,
+	std::function<void( std::shared_ptr<TextDocument>, bool )> onLoaded ) {
+	bool wasLocked = isLocked();
+	if ( !wasLocked )
+		setLocked( true );
+	std::weak_ptr<TextDocument> doc( mDoc );
+	UISceneNode* sceneNode = getUISceneNode();
+	bool ret = mDoc->loadAsyncIncrementalFromFile(
+		path, pool,
+		[this, onLoaded]( TextDocument*, bool success ) {
+			// Called from commitLoadedLines, already running in the main thread. The callback is
+			// detached if the editor stops displaying the document before it's loaded.
+			invalidateEditor();
+			updateLongestLineWidth();
+			invalidateDraw();
+			mIncrementalLoading = false;
+			if ( mUnlockOnIncrementalLoad ) {
+				mUnlockOnIncrementalLoad = false;
+				setLocked( false );
+			}
+			if ( success )
+				onDocumentLoaded();
+			if ( onLoaded )
+				onLoaded( mDoc, success );
+		},
+		[sceneNode, doc]( TextDocument*, Float ) {
+			// The lines are committed even if the editor is gone, its clients are notified by the
+			// document.
+			sceneNode->runOnMainThread( [doc] {
+				if ( auto document = doc.lock() )
+					document->commitLoadedLines();
+			} );
+		} );
+	if ( ret ) {
+		mIncrementalLoading = true;
+		mUnlockOnIncrementalLoad = !wasLocked;
+	} else if ( !wasLocked ) {
+		setLocked( false );
+	}
+	return ret;
+}
+
+void UICodeEditor::detachIncrementalLoad() {
+	if ( !mIncrementalLoading )
+		return;
+	mIncrementalLoading = false;
+	mDoc->detachIncrementalLoadCallback();
+	if ( mUnlockOnIncrementalLoad ) {
+		mUnlockOnIncrementalLoad = false;
+		setLocked( false );
+	}
+}
+
 TextDocument::LoadStatus UICodeEditor::loadFromURL( const std::string& url,
 													const Http::Request::FieldTable& headers ) {
 	auto ret = mDoc->loadFromURL( url, headers );
@@ -538,7 +611,10 @@ void UICodeEditor::onFontStyleChanged() {
 	udpateGlyphWidth();
 }
 
-void UICodeEditor::onDocumentLoaded( TextDocument* ) {}
+void UICodeEditor::onDocumentLoaded( TextDocument* ) {
+	// Can be called from the loading thread, the index is rebuilt from the main thread.
+	invalidateVisualLines();
+}
 
 void UICodeEditor::onDocumentLoaded() {
 	DocEvent event( this, mDoc.get(), Event::OnDocumentLoaded );
@@ -547,6 +623,7 @@ void UICodeEditor::onDocumentLoaded() {
 
 void UICodeEditor::onDocumentChanged() {
 	invalidateLinesCache();
+	invalidateMinimapTiles();
 	if ( mFindReplace )
 		mFindReplace->setDoc( mDoc );
 	DocEvent event( this, mDoc.get(), Event::OnDocumentChanged );
@@ -781,6 +858,7 @@ void UICodeEditor::updateColorScheme() {
 	mMinimapHoverColor = mColorScheme.getEditorColor( "minimap_hover" );
 	mMinimapHighlightColor = mColorScheme.getEditorColor( "minimap_highlight" );
 	mMinimapSelectionColor = mColorScheme.getEditorColor( "minimap_selection" );
+	invalidateMinimapTiles();
 }
 
 void UICodeEditor::setColorScheme( const SyntaxColorScheme& colorScheme ) {
@@ -807,11 +885,13 @@ TextDocument& UICodeEditor::getDocument() {
 
 void UICodeEditor::setDocument( std::shared_ptr<TextDocument> doc ) {
 	if ( mDoc.get() != doc.get() ) {
+		detachIncrementalLoad();
 		mDoc->unregisterClient( this );
 		if ( mDoc.use_count() == 1 )
 			onDocumentClosed( mDoc.get() );
 		mDoc = doc;
 		mDoc->registerClient( this );
+		invalidateVisualLines();
 		invalidateEditor();
 		invalidateDraw();
 		onDocumentChanged();
@@ -919,6 +999,16 @@ TextPosition UICodeEditor::resolveScreenPosition( const Vector2f& position, bool
 	localPos.y -= mPaddingPx.Top;
 	localPos.y -= getPluginsTopSpace();
 	Int64 line = (Int64)eefloor( localPos.y / getLineHeight() );
+	if ( isWordWrapActive() ) {
+		Int64 rowsCount = mVisualLines.rowsCount();
+		if ( !clamp && ( line < 0 || line >= rowsCount ) ) {
+			line = line < 0 ? line : (Int64)mDoc->linesCount() + line - rowsCount;
+			return TextPosition( line, getColFromXOffset( line, localPos.x ) );
+		}
+		size_t rowInLine = 0;
+		line = mVisualLines.getLineFromRow( eeclamp<Int64>( line, 0, rowsCount - 1 ), &rowInLine );
+		return TextPosition( line, getColFromRowXOffset( line, rowInLine, localPos.x ) );
+	}
 	if ( clamp )
 		line = eeclamp<Int64>( line, 0, (Int64)( mDoc->linesCount() - 1 ) );
 	return TextPosition( line, getColFromXOffset( line, localPos.x ) );
@@ -929,8 +1019,8 @@ Rectf UICodeEditor::getScreenPosition( const TextPosition& position ) const {
 	Vector2f screenStart( getScreenStart() );
 	Vector2f start( screenStart.x + getGutterWidth(), screenStart.y );
 	Vector2f startScroll( start - mScroll );
-	return { { startScroll.x + getXOffsetColSanitized( position ),
-			   startScroll.y + lineHeight * position.line() },
+	Vector2f offset( getTextPositionOffset( position ) );
+	return { { startScroll.x + offset.x, startScroll.y + offset.y },
 			 { getGlyphWidth(), lineHeight } };
 }
 
@@ -948,11 +1038,11 @@ Vector2f UICodeEditor::getViewPortLineCount() const {
 
 Sizef UICodeEditor::getMaxScroll() const {
 	Vector2f vplc( getViewPortLineCount() );
-	return Sizef( eemax( 0.f, mLongestLineWidth - getViewportWidth() ),
-				  vplc.y > mDoc->linesCount() - 1
+	size_t visualLinesCount = getVisualLinesCount();
+	return Sizef( mWordWrap ? 0.f : eemax( 0.f, mLongestLineWidth - getViewportWidth() ),
+				  vplc.y > visualLinesCount - 1
 					  ? 0.f
-					  : eefloor( mDoc->linesCount() - getViewPortLineCount().y ) *
-							getLineHeight() );
+					  : eefloor( visualLinesCount - vplc.y ) * getLineHeight() );
 }
 
 UIMenuItem* UICodeEditor::menuAdd( UIPopUpMenu* menu, const std::string& translateKey,
@@ -1379,9 +1469,8 @@ Vector2f UICodeEditor::getRelativeScreenPosition( const TextPosition& pos ) {
 	Float gutterWidth = getGutterWidth();
 	Vector2f start( gutterWidth, getPluginsTopSpace() );
 	Vector2f startScroll( start - mScroll );
-	auto lineHeight = getLineHeight();
-	return { startScroll.x + getXOffsetCol( pos ),
-			 startScroll.y + pos.line() * lineHeight + getLineOffset() };
+	Vector2f offset( getTextPositionOffset( pos ) );
+	return { startScroll.x + offset.x, startScroll.y + offset.y + getLineOffset() };
 }
 
 bool UICodeEditor::getShowLinesRelativePosition() const {
@@ -1392,11 +1481,261 @@ void UICodeEditor::showLinesRelativePosition( bool showLinesRelativePosition ) {
 	mShowLinesRelativePosition = showLinesRelativePosition;
 }
 
-void UICodeEditor::drawCursor( const Vector2f& startScroll, const Float& lineHeight,
+const bool& UICodeEditor::getWordWrap() const {
+	return mWordWrap;
+}
+
+void UICodeEditor::setWordWrap( const bool& wordWrap ) {
+	if ( wordWrap != mWordWrap ) {
+		mWordWrap = wordWrap;
+		setScrollX( 0 );
+		invalidateEditor();
+		invalidateDraw();
+	}
+}
+
+size_t UICodeEditor::getVisualLinesCount() const {
+	return isWordWrapActive() ? mVisualLines.rowsCount() : mDoc->linesCount();
+}
+
+Float UICodeEditor::getLineYOffset( const Int64& line ) const {
+	if ( isWordWrapActive() )
+		return getLineHeight() * mVisualLines.getLineFirstRow( eemax<Int64>( 0, line ) );
+	return getLineHeight() * line;
+}
+
+Vector2f UICodeEditor::getTextPositionOffset( const TextPosition& position ) const {
+	if ( !isWordWrapActive() )
+		return { getXOffsetColSanitized( position ), getLineHeight() * position.line() };
+
+	TextPosition pos( eeclamp<Int64>( position.line(), 0, mDoc->linesCount() - 1 ),
+					  position.column() );
+	const auto& breaks = mVisualLines.getLine( pos.line() ).breaks;
+	size_t rowInLine = std::distance(
+		breaks.begin(), std::upper_bound( breaks.begin(), breaks.end(), pos.column() ) );
+	Float x = rowInLine > 0 ? getColumnsWidth( pos.line(), breaks[rowInLine - 1], pos.column() )
+							: getXOffsetColSanitized( pos );
+	return { x, getLineHeight() * ( mVisualLines.getLineFirstRow( pos.line() ) + rowInLine ) };
+}
+
+UICodeEditor::VisualLinesConfig UICodeEditor::getVisualLinesConfig() const {
+	VisualLinesConfig config;
+	config.font = mFont;
+	config.characterSize = getCharacterSize();
+	config.fontStyle = mFontStyleConfig.Style;
+	config.tabWidth = mTabWidth;
+	if ( mWordWrap )
+		config.wrapWidth = eemax( 0.f, getViewportWidth( true ) - getGlyphWidth() );
+	return config;
+}
+
+void UICodeEditor::updateVisualLines() {
+	if ( NULL == mFont || ( mDoc->isLoading() && !mDoc->isLoadingIncrementally() ) )
+		return;
+
+	VisualLinesConfig config( getVisualLinesConfig() );
+	if ( mVisualLinesDirty || mVisualLines.linesCount() != mDoc->linesCount() ) {
+		mVisualLines.reset( mDoc->linesCount() );
+	} else if ( !( config == mVisualLinesConfig ) ) {
+		// Lines keep their previous rows until they are measured again, so resizing the editor
+		// doesn't move the lines that are not visible yet.
+		mVisualLines.invalidate();
+	} else {
+		return;
+	}
+
+	mVisualLinesConfig = config;
+	mVisualLinesDirty = false;
+	measureVisibleVisualLines();
+	invalidateLongestLineWidth();
+	invalidateEditor( false );
+}
+
+void UICodeEditor::measureVisibleVisualLines() {
+	// Measuring a line can change the visible range, repeat until every visible line is measured.
+	bool measured = true;
+	while ( measured ) {
+		measured = false;
+		auto range = getVisibleLineRange();
+		for ( Uint64 i = range.first; i <= range.second && i < mVisualLines.linesCount(); i++ ) {
+			if ( !mVisualLines.getLine( i ).measured ) {
+				mVisualLines.setLine( i, measureVisualLine( i, mVisualLinesConfig.wrapWidth ) );
+				measured = true;
+			}
+		}
+	}
+}
+
+void UICodeEditor::measurePendingVisualLines() {
+	bool wordWrap = isWordWrapActive();
+	Int64 firstVisibleLine = wordWrap ? getVisibleLineRange().first : 0;
+	Float firstVisibleLineY = wordWrap ? getLineYOffset( firstVisibleLine ) : 0.f;
+	size_t rowsCount = mVisualLines.rowsCount();
+	size_t linesCount = mVisualLines.linesCount();
+	size_t line = mVisualLines.findUnmeasured( 0 );
+
+	for ( size_t i = 0; i < VisualLinesMeasureBatchSize && line < linesCount; i++ ) {
+		mVisualLines.setLine( line, measureVisualLine( line, mVisualLinesConfig.wrapWidth ) );
+		line = mVisualLines.findUnmeasured( line + 1 );
+	}
+
+	if ( rowsCount != mVisualLines.rowsCount() ) {
+		// Keep the first visible line in place when the lines above it got a new rows count.
+		Float offset = getLineYOffset( firstVisibleLine ) - firstVisibleLineY;
+		if ( offset != 0 )
+			setScrollY( mScroll.y + offset );
+		invalidateEditor( false );
+		invalidateDraw();
+	}
+
+	if ( mVisualLines.unmeasuredCount() == 0 )
+		updateLongestLineWidth();
+}
+
+void UICodeEditor::invalidateVisualLines() {
+	mVisualLinesDirty = true;
+}
+
+VisualLineIndex::Line UICodeEditor::measureVisualLine( const Int64& line, const Float& wrapWidth ) {
+	VisualLineIndex::Line visualLine;
+	visualLine.width = getLineWidth( line );
+	if ( wrapWidth <= 0 || visualLine.width <= wrapWidth )
+		return visualLine;
+
+	const String& text = mDoc->line( line ).getText();
+	bool isMonospace = mFont->isMonospace();
+	bool bold = mFontStyleConfig.Style & Text::Bold;
+	unsigned int characterSize = getCharacterSize();
+	Float glyphWidth = getGlyphWidth();
+	Float tabWidth = glyphWidth * mTabWidth;
+	if ( !isMonospace )
+		tabWidth = mFont->getGlyph( ' ', characterSize, bold, mFontStyleConfig.OutlineThickness )
+					   .advance *
+				   mTabWidth;
+	Float x = 0;
+	Float breakableX = 0;
+	Int64 rowStart = 0;
+	Int64 breakable = 0;
+	Int64 len = text.size();
+
+	// Greedy wrap, rows are broken after the last whitespace or in the middle of long words.
+	for ( Int64 i = 0; i < len; i++ ) {
+		String::StringBaseType ch = text[i];
+		if ( ch == '\n' || ch == '\r' )
+			continue;
+
+		Float advance = glyphWidth;
+		if ( ch == '\t' ) {
+			advance = tabWidth;
+		} else if ( !isMonospace ) {
+			advance = mFont->getGlyph( ch, characterSize, bold, mFontStyleConfig.OutlineThickness )
+						  .advance;
+		}
+
+		if ( x + advance > wrapWidth && i > rowStart ) {
+			if ( breakable > rowStart ) {
+				visualLine.breaks.push_back( breakable );
+				x -= breakableX;
+			} else {
+				visualLine.breaks.push_back( i );
+				x = 0;
+			}
+			rowStart = visualLine.breaks.back();
+		}
+
+		x += advance;
+
+		if ( ch == ' ' || ch == '\t' ) {
+			breakable = i + 1;
+			breakableX = x;
+		}
+	}
+
+	return visualLine;
+}
+
+bool UICodeEditor::isWordWrapActive() const {
+	return mWordWrap && !mVisualLinesDirty && mVisualLines.linesCount() == mDoc->linesCount();
+}
+
+Int64 UICodeEditor::getTextPositionRow( const TextPosition& position ) const {
+	if ( !isWordWrapActive() )
+		return position.line();
+	Int64 line = eeclamp<Int64>( position.line(), 0, mDoc->linesCount() - 1 );
+	const auto& breaks = mVisualLines.getLine( line ).breaks;
+	return mVisualLines.getLineFirstRow( line ) +
+		   std::distance( breaks.begin(),
+						  std::upper_bound( breaks.begin(), breaks.end(), position.column() ) );
+}
+
+std::pair<Int64, Int64> UICodeEditor::getLineRowColumns( const Int64& line,
+														 const Int64& rowInLine ) const {
+	const auto& breaks = mVisualLines.getLine( line ).breaks;
+	Int64 start = rowInLine > 0 ? breaks[rowInLine - 1] : 0;
+	Int64 end = rowInLine < (Int64)breaks.size()
+					? breaks[rowInLine]
+					: static_cast<Int64>( mDoc->line( line ).getText().size() );
+	return { start, end };
+}
+
+Int64 UICodeEditor::getColFromRowXOffset( const Int64& line, const Int64& rowInLine,
+										  const Float& x ) const {
+	auto columns = getLineRowColumns( line, rowInLine );
+	if ( x <= 0 )
+		return columns.first;
+	Float rowStart = columns.first > 0 ? getXOffsetCol( { line, columns.first } ) : 0.f;
+	Int64 col = getColFromXOffset( line, rowStart + x );
+	// Every row but the last one ends right before the first column of the next row.
+	bool lastRow = rowInLine == (Int64)mVisualLines.getLine( line ).breaks.size();
+	return eeclamp<Int64>( col, columns.first,
+						   lastRow ? col : eemax( columns.first, columns.second - 1 ) );
+}
+
+Float UICodeEditor::getColumnsWidth( const Int64& line, const Int64& startCol,
+									 const Int64& endCol ) const {
+	if ( mFont && !mFont->isMonospace() )
+		return getXOffsetCol( { line, endCol } ) - getXOffsetCol( { line, startCol } );
+
+	const String& text = mDoc->line( line ).getText();
+	Float glyphWidth = getGlyphWidth();
+	Float x = 0;
+	Int64 maxCol = eemin( (Int64)text.size(), endCol );
+	for ( Int64 i = eemax<Int64>( 0, startCol ); i < maxCol; i++ ) {
+		if ( text[i] == '\t' ) {
+			x += glyphWidth * mTabWidth;
+		} else if ( text[i] != '\n' && text[i] != '\r' ) {
+			x += glyphWidth;
+		}
+	}
+	return x;
+}
+
+void UICodeEditor::invalidateCursors() {
+	// Blinking only changes the cursors, with many cursors the whole editor is redrawn
+	if ( mDoc->getSelections().size() > 16 ) {
+		invalidateDraw();
+		return;
+	}
+
+	Rectf bounds( mScreenPos, mSize );
+	Float lineHeight = getLineHeight();
+	Vector2f screenStart( getScreenStart() );
+	Float startScrollY = screenStart.y + getPluginsTopSpace() - mScroll.y;
+
+	for ( const auto& selection : mDoc->getSelections() ) {
+		Float y = startScrollY + getTextPositionOffset( selection.start() ).y;
+		Rectf row( bounds.Left, y, bounds.Right, y + lineHeight );
+		row.shrink( bounds );
+		if ( row.Bottom > row.Top )
+			invalidateDraw( row );
+	}
+}
+
+void UICodeEditor::drawCursor( const Vector2f& startScroll, const Float&,
 							   const TextPosition& cursor ) {
 	if ( mCursorVisible && !mLocked && isTextSelectionEnabled() ) {
-		Vector2f cursorPos( startScroll.x + getXOffsetCol( cursor ),
-							startScroll.y + cursor.line() * lineHeight + getLineOffset() );
+		Vector2f offset( getTextPositionOffset( cursor ) );
+		Vector2f cursorPos( startScroll.x + offset.x, startScroll.y + offset.y + getLineOffset() );
 		Primitives primitives;
 		primitives.setColor( Color( mCaretColor ).blendAlpha( mAlpha ) );
 		primitives.drawRectangle(
@@ -1416,10 +1755,10 @@ void UICodeEditor::onPaddingChange() {
 
 void UICodeEditor::findLongestLine() {
 	if ( mHorizontalScrollBarEnabled ) {
-		mLongestLineWidth = 0;
-		for ( size_t lineIndex = 0; lineIndex < mDoc->linesCount(); lineIndex++ ) {
-			mLongestLineWidth = eemax( mLongestLineWidth, getLineWidth( lineIndex ) );
-		}
+		// The widths are tracked by the visual lines index, only edited lines are measured again.
+		// Lines pending to be measured are added when they are measured.
+		updateVisualLines();
+		mLongestLineWidth = mVisualLines.getLongestLineWidth();
 	}
 }
 
@@ -1434,7 +1773,7 @@ Float UICodeEditor::getLineWidth( const Int64& lineIndex ) {
 }
 
 void UICodeEditor::updateScrollBar() {
-	int notVisibleLineCount = (int)mDoc->linesCount() - (int)getViewPortLineCount().y;
+	int notVisibleLineCount = (int)getVisualLinesCount() - (int)getViewPortLineCount().y;
 
 	if ( mLongestLineWidthDirty && mFont && mFont->isMonospace() ) {
 		updateLongestLineWidth();
@@ -1445,7 +1784,7 @@ void UICodeEditor::updateScrollBar() {
 
 	mVScrollBar->setPixelsSize( mVScrollBar->getPixelsSize().getWidth(), mSize.getHeight() );
 
-	if ( mHorizontalScrollBarEnabled ) {
+	if ( mHorizontalScrollBarEnabled && !mWordWrap ) {
 		mHScrollBar->setPixelsPosition( 0, mSize.getHeight() -
 											   mHScrollBar->getPixelsSize().getHeight() );
 		mHScrollBar->setPixelsSize( mSize.getWidth() -
@@ -1461,7 +1800,7 @@ void UICodeEditor::updateScrollBar() {
 	}
 
 	mVScrollBar->setPixelsPosition( mSize.getWidth() - mVScrollBar->getPixelsSize().getWidth(), 0 );
-	mVScrollBar->setPageStep( getViewPortLineCount().y / (float)mDoc->linesCount() );
+	mVScrollBar->setPageStep( getViewPortLineCount().y / (float)getVisualLinesCount() );
 	mVScrollBar->setClickStep( 0.2f );
 	mVScrollBar->setEnabled( mVerticalScrollBarEnabled && notVisibleLineCount > 0 );
 	mVScrollBar->setVisible( mVerticalScrollBarEnabled && notVisibleLineCount > 0 );
@@ -1551,7 +1890,26 @@ void UICodeEditor::updateEditor() {
 	mDirtyScroll = false;
 }
 
-void UICodeEditor::onDocumentTextChanged( const DocumentContentChange& ) {
+void UICodeEditor::onDocumentTextChanged( const DocumentContentChange& change ) {
+	if ( !mVisualLinesDirty ) {
+		// Only the lines touched by the change are measured again. A change replaces the lines of
+		// its range with the lines of its text.
+		TextRange range( change.range.normalized() );
+		Int64 line = range.start().line();
+		Int64 removed = range.end().line() - line;
+		Int64 added = std::count( change.text.begin(), change.text.end(), '\n' );
+		Int64 delta = (Int64)mDoc->linesCount() - (Int64)mVisualLines.linesCount();
+		if ( line < 0 || line >= (Int64)mDoc->linesCount() || added - removed != delta ) {
+			invalidateVisualLines();
+		} else {
+			if ( removed > 0 )
+				mVisualLines.erase( line + 1, line + 1 + removed );
+			if ( added > 0 )
+				mVisualLines.insert( line + 1, added );
+			for ( Int64 i = line; i <= line + added; i++ )
+				mVisualLines.setLine( i, measureVisualLine( i, mVisualLinesConfig.wrapWidth ) );
+		}
+	}
 	invalidateDraw();
 	checkMatchingBrackets();
 	sendCommonEvent( Event::OnTextChanged );
@@ -1572,8 +1930,23 @@ void UICodeEditor::onDocumentSelectionChange( const Doc::TextRange& ) {
 	sendCommonEvent( Event::OnSelectionChanged );
 }
 
-void UICodeEditor::onDocumentLineCountChange( const size_t&, const size_t& ) {
+void UICodeEditor::onDocumentLineCountChange( const size_t& lastCount, const size_t& newCount ) {
+	// Text changes already updated the visual lines, lines appended by an incremental load only
+	// notify the new line count.
+	if ( !mVisualLinesDirty && mVisualLines.linesCount() != mDoc->linesCount() ) {
+		if ( mVisualLines.linesCount() == lastCount && newCount > lastCount &&
+			 newCount == mDoc->linesCount() ) {
+			mVisualLines.insert( lastCount, newCount - lastCount );
+			// The first commit replaces the placeholder line.
+			for ( size_t i = lastCount > 0 ? lastCount - 1 : 0; i < newCount; i++ )
+				mVisualLines.setLine( i, measureVisualLine( i, mVisualLinesConfig.wrapWidth ) );
+			invalidateLongestLineWidth();
+		} else {
+			invalidateVisualLines();
+		}
+	}
 	updateScrollBar();
+	invalidateDraw();
 }
 
 void UICodeEditor::onDocumentLineChanged( const Int64& lineNumber ) {
@@ -1611,6 +1984,13 @@ void UICodeEditor::onDocumentDirtyOnFileSystem( TextDocument* doc ) {
 
 std::pair<Uint64, Uint64> UICodeEditor::getVisibleLineRange() const {
 	Float lineHeight = getLineHeight();
+	if ( isWordWrapActive() ) {
+		Float minRow = eemax( 0.f, eefloor( mScroll.y / lineHeight ) );
+		Float maxRow = eemin( mVisualLines.rowsCount() - 1.f,
+							  eefloor( ( mSize.getHeight() + mScroll.y ) / lineHeight ) + 1 );
+		return std::make_pair<Uint64, Uint64>( mVisualLines.getLineFromRow( minRow ),
+											   mVisualLines.getLineFromRow( maxRow ) );
+	}
 	Float minLine = eemax( 0.f, eefloor( mScroll.y / lineHeight ) );
 	Float maxLine = eemin( mDoc->linesCount() - 1.f,
 						   eefloor( ( mSize.getHeight() + mScroll.y ) / lineHeight ) + 1 );
@@ -1640,32 +2020,33 @@ void UICodeEditor::setLineSpacing( const StyleSheetLength& lineSpace ) {
 
 void UICodeEditor::scrollTo( const TextPosition& position, bool centered, bool forceExactPosition,
 							 bool scrollX ) {
-	auto lineRange = getVisibleLineRange();
+	Float lineHeight = getLineHeight();
+	// Visual rows, equal to the document lines if word wrap is disabled.
+	Int64 row = getTextPositionRow( position );
+	Int64 firstRow = eemax<Int64>( 0, eefloor( mScroll.y / lineHeight ) );
+	Int64 lastRow = eemin<Int64>( (Int64)getVisualLinesCount() - 1,
+								  eefloor( ( mSize.getHeight() + mScroll.y ) / lineHeight ) + 1 );
 
 	Int64 minDistance = mHScrollBar->isVisible() ? 3 : 2;
 
-	if ( forceExactPosition || position.line() <= (Int64)lineRange.first ||
-		 position.line() >= (Int64)lineRange.second - minDistance ) {
+	if ( forceExactPosition || row <= firstRow || row >= lastRow - minDistance ) {
 		// Vertical Scroll
-		Float lineHeight = getLineHeight();
-		Float min = eefloor( lineHeight * ( eemax<Float>( 0, position.line() - 1 ) ) );
-		Float max = eefloor( lineHeight * ( position.line() + minDistance ) - mSize.getHeight() );
+		Float min = eefloor( lineHeight * ( eemax<Float>( 0, row - 1 ) ) );
+		Float max = eefloor( lineHeight * ( row + minDistance ) - mSize.getHeight() );
 		Float halfScreenLines = eefloor( mSize.getHeight() / lineHeight * 0.5f );
 
 		if ( forceExactPosition ) {
-			setScrollY(
-				lineHeight *
-				( eemax<Float>( 0, position.line() - 1 - ( centered ? halfScreenLines : 0 ) ) ) );
+			setScrollY( lineHeight *
+						( eemax<Float>( 0, row - 1 - ( centered ? halfScreenLines : 0 ) ) ) );
 		} else if ( min < mScroll.y ) {
 			if ( centered ) {
-				if ( position.line() - 1 - halfScreenLines >= 0 )
-					min = eefloor( lineHeight *
-								   ( eemax<Float>( 0, position.line() - 1 - halfScreenLines ) ) );
+				if ( row - 1 - halfScreenLines >= 0 )
+					min = eefloor( lineHeight * ( eemax<Float>( 0, row - 1 - halfScreenLines ) ) );
 			}
 			setScrollY( min );
 		} else if ( max > mScroll.y ) {
 			if ( centered ) {
-				max = eefloor( lineHeight * ( position.line() + minDistance + halfScreenLines ) -
+				max = eefloor( lineHeight * ( row + minDistance + halfScreenLines ) -
 							   mSize.getHeight() );
 				max = eemin( max, getMaxScroll().y );
 			}
@@ -1676,7 +2057,7 @@ void UICodeEditor::scrollTo( const TextPosition& position, bool centered, bool f
 	// Horizontal Scroll
 	if ( !scrollX )
 		return;
-	Float offsetX = getXOffsetCol( position );
+	Float offsetX = getTextPositionOffset( position ).x;
 	Float glyphSize = getGlyphWidth();
 	Float minVisibility = glyphSize;
 	Float viewPortWidth = getViewportWidth();
@@ -2055,6 +2436,9 @@ bool UICodeEditor::applyProperty( const StyleSheetProperty& attribute ) {
 		case PropertyId::LineSpacing:
 			setLineSpacing( attribute.asStyleSheetLength() );
 			break;
+		case PropertyId::Wordwrap:
+			setWordWrap( attribute.asBool() );
+			break;
 		default:
 			return UIWidget::applyProperty( attribute );
 	}
@@ -2095,6 +2479,8 @@ std::string UICodeEditor::getPropertyString( const PropertyDefinition* propertyD
 			return isTextSelectionEnabled() ? "true" : "false";
 		case PropertyId::LineSpacing:
 			return getLineSpacing().toString();
+		case PropertyId::Wordwrap:
+			return getWordWrap() ? "true" : "false";
 		default:
 			return UIWidget::getPropertyString( propertyDef, propertyIndex );
 	}
@@ -2107,7 +2493,7 @@ std::vector<PropertyId> UICodeEditor::getPropertiesImplemented() const {
 		PropertyId::TextShadowOffset, PropertyId::SelectionColor,  PropertyId::SelectionBackColor,
 		PropertyId::FontFamily,		  PropertyId::FontSize,		   PropertyId::FontStyle,
 		PropertyId::TextStrokeWidth,  PropertyId::TextStrokeColor, PropertyId::TextSelection,
-		PropertyId::LineSpacing };
+		PropertyId::LineSpacing,	  PropertyId::Wordwrap };
 	props.insert( props.end(), local.begin(), local.end() );
 	return props;
 }
@@ -2357,7 +2743,15 @@ TextPosition UICodeEditor::moveToLineOffset( const TextPosition& position, int o
 											 const size_t& cursorIdx ) {
 	auto& xo = mLastXOffset[cursorIdx];
 	if ( xo.position != position )
-		xo.offset = getXOffsetColSanitized( position );
+		xo.offset = getTextPositionOffset( position ).x;
+	if ( isWordWrapActive() ) {
+		size_t rowInLine = 0;
+		Int64 line = mVisualLines.getLineFromRow(
+			eemax<Int64>( 0, getTextPositionRow( position ) + offset ), &rowInLine );
+		xo.position.setLine( line );
+		xo.position.setColumn( getColFromRowXOffset( line, rowInLine, xo.offset ) );
+		return xo.position;
+	}
 	xo.position.setLine( position.line() + offset );
 	xo.position.setColumn( getColFromXOffset( position.line() + offset, xo.offset ) );
 	return xo.position;
@@ -2366,7 +2760,7 @@ TextPosition UICodeEditor::moveToLineOffset( const TextPosition& position, int o
 void UICodeEditor::moveToPreviousLine() {
 	for ( size_t i = 0; i < mDoc->getSelections().size(); ++i ) {
 		TextPosition position = mDoc->getSelections()[i].start();
-		if ( position.line() == 0 ) {
+		if ( getTextPositionRow( position ) == 0 ) {
 			mDoc->setSelection( i, mDoc->startOfDoc(), mDoc->startOfDoc() );
 		} else {
 			mDoc->moveTo( i, moveToLineOffset( position, -1, i ) );
@@ -2378,7 +2772,7 @@ void UICodeEditor::moveToPreviousLine() {
 void UICodeEditor::moveToNextLine() {
 	for ( size_t i = 0; i < mDoc->getSelections().size(); ++i ) {
 		TextPosition position = mDoc->getSelections()[i].start();
-		if ( position.line() == (Int64)mDoc->linesCount() - 1 ) {
+		if ( getTextPositionRow( position ) == (Int64)getVisualLinesCount() - 1 ) {
 			mDoc->setSelection( i, mDoc->endOfDoc(), mDoc->endOfDoc() );
 		} else {
 			mDoc->moveTo( i, moveToLineOffset( position, 1, i ) );
@@ -2390,7 +2784,7 @@ void UICodeEditor::moveToNextLine() {
 void UICodeEditor::selectToPreviousLine() {
 	for ( size_t i = 0; i < mDoc->getSelections().size(); ++i ) {
 		TextPosition position = mDoc->getSelectionIndex( i ).start();
-		if ( position.line() == 0 ) {
+		if ( getTextPositionRow( position ) == 0 ) {
 			mDoc->selectTo( i, mDoc->startOfDoc() );
 		} else {
 			mDoc->selectTo( i, moveToLineOffset( position, -1 ) );
@@ -2401,7 +2795,7 @@ void UICodeEditor::selectToPreviousLine() {
 void UICodeEditor::selectToNextLine() {
 	for ( size_t i = 0; i < mDoc->getSelections().size(); ++i ) {
 		TextPosition position = mDoc->getSelectionIndex( i ).start();
-		if ( position.line() == (Int64)mDoc->linesCount() - 1 ) {
+		if ( getTextPositionRow( position ) == (Int64)getVisualLinesCount() - 1 ) {
 			mDoc->selectTo( i, mDoc->endOfDoc() );
 		} else {
 			mDoc->selectTo( i, moveToLineOffset( position, 1 ) );
@@ -2585,8 +2979,7 @@ void UICodeEditor::drawMatchingBrackets( const Vector2f& startScroll, const Floa
 		primitive.setForceDraw( false );
 		primitive.setColor( Color( mMatchingBracketColor ).blendAlpha( mAlpha ) );
 		auto drawBracket = [&]( const TextPosition& pos ) {
-			primitive.drawRectangle( Rectf( Vector2f( startScroll.x + getXOffsetCol( pos ),
-													  startScroll.y + pos.line() * lineHeight ),
+			primitive.drawRectangle( Rectf( startScroll + getTextPositionOffset( pos ),
 											Sizef( getGlyphWidth(), lineHeight ) ) );
 		};
 		drawBracket( mMatchingBrackets.start() );
@@ -2635,14 +3028,8 @@ void UICodeEditor::drawWordRanges( const TextRanges& ranges, const std::pair<int
 		if ( !range.inSameLine() )
 			continue;
 
-		Rectf selRect;
-		Int64 startCol = range.start().column();
-		Int64 endCol = range.end().column();
-		selRect.Top = startScroll.y + range.start().line() * lineHeight;
-		selRect.Bottom = selRect.Top + lineHeight;
-		selRect.Left = startScroll.x + getXOffsetCol( { range.start().line(), startCol } );
-		selRect.Right = startScroll.x + getXOffsetCol( { range.start().line(), endCol } );
-		primitives.drawRectangle( selRect );
+		drawLineRange( primitives, range.start().line(), range.start().column(),
+					   range.end().column(), startScroll, lineHeight );
 	}
 
 	primitives.setForceDraw( true );
@@ -2675,14 +3062,9 @@ void UICodeEditor::drawWordMatch( const String& text, const std::pair<int, int>&
 					}
 				}
 
-				Rectf selRect;
 				Int64 startCol = pos;
 				Int64 endCol = pos + text.size();
-				selRect.Top = startScroll.y + ln * lineHeight;
-				selRect.Bottom = selRect.Top + lineHeight;
-				selRect.Left = startScroll.x + getXOffsetCol( { ln, startCol } );
-				selRect.Right = startScroll.x + getXOffsetCol( { ln, endCol } );
-				primitives.drawRectangle( selRect );
+				drawLineRange( primitives, ln, startCol, endCol, startScroll, lineHeight );
 				pos = endCol;
 			} else {
 				break;
@@ -2694,6 +3076,11 @@ void UICodeEditor::drawWordMatch( const String& text, const std::pair<int, int>&
 
 void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Float& fontSize,
 								 const Float& lineHeight ) {
+	if ( isWordWrapActive() && !mVisualLines.getLine( line ).breaks.empty() ) {
+		drawWrappedLineText( line, position, fontSize, lineHeight );
+		return;
+	}
+
 	Vector2f originalPosition( position );
 	auto& tokens = mDoc->getHighlighter()->getLine( line );
 	const String& strLine = mDoc->line( line ).getText();
@@ -2856,6 +3243,77 @@ void UICodeEditor::drawLineText( const Int64& line, Vector2f position, const Flo
 	}
 }
 
+void UICodeEditor::drawWrappedLineText( const Int64& line, Vector2f position, const Float& fontSize,
+										const Float& lineHeight ) {
+	const auto& breaks = mVisualLines.getLine( line ).breaks;
+	auto& tokens = mDoc->getHighlighter()->getLine( line );
+	const String& strLine = mDoc->line( line ).getText();
+	bool isMonospace = mFont->isMonospace();
+	Float lineOffset = getLineOffset();
+	Float startX = position.x;
+	Primitives primitives;
+	Text& txt = mLineTextCache;
+
+	// A single line can span thousands of rows, only the visible ones are drawn.
+	Int64 firstRow = eemax<Int64>( 0, eefloor( ( mScreenPos.y - position.y ) / lineHeight ) );
+	Int64 lastRow = eemin<Int64>(
+		breaks.size(), eefloor( ( mScreenPos.y + mSize.getHeight() - position.y ) / lineHeight ) );
+	if ( firstRow > lastRow )
+		return;
+
+	Int64 startCol = getLineRowColumns( line, firstRow ).first;
+	Int64 endCol = getLineRowColumns( line, lastRow ).second;
+	size_t row = firstRow;
+	position.y += lineHeight * firstRow;
+	Int64 pos = 0;
+
+	for ( const auto& token : tokens ) {
+		Int64 tokenStart = pos;
+		Int64 tokenEnd = eemin<Int64>( pos + token.len, strLine.size() );
+		pos += token.len;
+
+		if ( tokenEnd <= startCol )
+			continue;
+		if ( tokenStart >= endCol )
+			break;
+
+		const SyntaxColorScheme::Style& style = mColorScheme.getSyntaxStyle( token.type );
+		txt.setFont( mFont );
+		txt.setFontSize( fontSize );
+		txt.setTabWidth( mTabWidth );
+		txt.setStyleConfig( mFontStyleConfig );
+		txt.setStyle( style.style );
+		txt.setColor( Color( style.color ).blendAlpha( mAlpha ) );
+		if ( isMonospace )
+			txt.setDisableCacheWidth( true );
+
+		Int64 col = eemax( tokenStart, startCol );
+		tokenEnd = eemin( tokenEnd, endCol );
+
+		while ( col < tokenEnd ) {
+			while ( row < breaks.size() && col >= breaks[row] ) {
+				row++;
+				position.x = startX;
+				position.y += lineHeight;
+			}
+
+			Int64 segmentEnd = row < breaks.size() ? eemin( tokenEnd, breaks[row] ) : tokenEnd;
+			String text( strLine.substr( col, segmentEnd - col ) );
+			txt.setString( text );
+			Float textWidth = isMonospace ? getTextWidth( text ) : txt.getTextWidth();
+
+			if ( style.background != Color::Transparent ) {
+				primitives.setColor( Color( style.background ).blendAlpha( mAlpha ) );
+				primitives.drawRectangle( Rectf( position, Sizef( textWidth, lineHeight ) ) );
+			}
+
+			txt.draw( position.x, position.y + lineOffset );
+			position.x += textWidth;
+			col = segmentEnd;
+		}
+	}
+}
+
 void UICodeEditor::drawTextRange( const TextRange& range, const std::pair<int, int>& lineRange,
 								  const Vector2f& startScroll, const Float& lineHeight,
 								  const Color& backgroundColor ) {
@@ -2867,30 +3325,45 @@ void UICodeEditor::drawTextRange( const TextRange& range, const std::pair<int, i
 	int endLine = eemin<int>( lineRange.second, range.end().line() );
 
 	for ( auto ln = startLine; ln <= endLine; ln++ ) {
-		const String& line = mDoc->line( ln ).getText();
-		Rectf selRect;
-		selRect.Top = startScroll.y + ln * lineHeight;
-		selRect.Bottom = selRect.Top + lineHeight;
-		if ( range.start().line() == ln ) {
-			selRect.Left = startScroll.x + getXOffsetCol( { ln, range.start().column() } );
-			if ( range.end().line() == ln ) {
-				selRect.Right = startScroll.x + getXOffsetCol( { ln, range.end().column() } );
-			} else {
-				selRect.Right =
-					startScroll.x + getXOffsetCol( { ln, static_cast<Int64>( line.length() ) } );
-			}
-		} else if ( range.end().line() == ln ) {
-			selRect.Left = startScroll.x + getXOffsetCol( { ln, 0 } );
-			selRect.Right = startScroll.x + getXOffsetCol( { ln, range.end().column() } );
-		} else {
-			selRect.Left = startScroll.x + getXOffsetCol( { ln, 0 } );
-			selRect.Right =
-				startScroll.x + getXOffsetCol( { ln, static_cast<Int64>( line.length() ) } );
-		}
+		Int64 lineLength = static_cast<Int64>( mDoc->line( ln ).getText().length() );
+		Int64 startCol = range.start().line() == ln ? range.start().column() : 0;
+		Int64 endCol = range.end().line() == ln ? range.end().column() : lineLength;
+		drawLineRange( primitives, ln, startCol, endCol, startScroll, lineHeight );
+	}
+	primitives.setForceDraw( true );
+}
+
+void UICodeEditor::drawLineRange( Primitives& primitives, const Int64& line, const Int64& startCol,
+								  const Int64& endCol, const Vector2f& startScroll,
+								  const Float& lineHeight ) {
+	Rectf selRect;
+	selRect.Top = startScroll.y + getLineYOffset( line );
+	selRect.Bottom = selRect.Top + lineHeight;
 
+	if ( !isWordWrapActive() || mVisualLines.getLine( line ).breaks.empty() ) {
+		selRect.Left = startScroll.x + getXOffsetCol( { line, startCol } );
+		selRect.Right = startScroll.x + getXOffsetCol( { line, endCol } );
 		primitives.drawRectangle( selRect );
+		return;
+	}
+
+	const auto& breaks = mVisualLines.getLine( line ).breaks;
+	Float screenBottom = mScreenPos.y + mSize.getHeight();
+
+	for ( size_t row = 0; row <= breaks.size() && selRect.Top < screenBottom; row++ ) {
+		auto columns = getLineRowColumns( line, row );
+		bool lastRow = row == breaks.size();
+		if ( startCol < ( lastRow ? endCol + 1 : columns.second ) && endCol >= columns.first &&
+			 selRect.Bottom >= mScreenPos.y ) {
+			Int64 start = eemax( startCol, columns.first );
+			Int64 end = lastRow ? endCol : eemin( endCol, columns.second );
+			selRect.Left = startScroll.x + getColumnsWidth( line, columns.first, start );
+			selRect.Right = selRect.Left + getColumnsWidth( line, start, end );
+			primitives.drawRectangle( selRect );
+		}
+		selRect.Top += lineHeight;
+		selRect.Bottom += lineHeight;
 	}
-	primitives.setForceDraw( true );
 }
 
 void UICodeEditor::drawLineNumbers( const std::pair<int, int>& lineRange,
@@ -2917,19 +3390,18 @@ void UICodeEditor::drawLineNumbers( const std::pair<int, int>& lineRange,
 						   ? mLineNumberActiveFontColor
 						   : mLineNumberFontColor );
 		line.draw( screenStart.x + mLineNumberPaddingLeft,
-				   startScroll.y + lineHeight * (double)i + lineOffset );
+				   startScroll.y + getLineYOffset( i ) + lineOffset );
 	}
 }
 
 void UICodeEditor::drawColorPreview( const Vector2f& startScroll, const Float& lineHeight ) {
 	Primitives primitives;
 	primitives.setColor( mPreviewColor );
-	Float startX = getXOffsetCol( mPreviewColorRange.start() );
-	Float endX = getXOffsetCol( mPreviewColorRange.end() );
-	primitives.drawRectangle( Rectf(
-		Vector2f( startScroll.x + mScroll.x + startX,
-				  startScroll.y + mPreviewColorRange.start().line() * lineHeight + lineHeight ),
-		Sizef( endX - startX, lineHeight * 2 ) ) );
+	Vector2f startOffset( getTextPositionOffset( mPreviewColorRange.start() ) );
+	Float endX = getTextPositionOffset( mPreviewColorRange.end() ).x;
+	primitives.drawRectangle( Rectf( Vector2f( startScroll.x + mScroll.x + startOffset.x,
+											   startScroll.y + startOffset.y + lineHeight ),
+									 Sizef( endX - startOffset.x, lineHeight * 2 ) ) );
 }
 
 void UICodeEditor::drawWhitespaces( const std::pair<int, int>& lineRange,
@@ -2946,10 +3418,22 @@ void UICodeEditor::drawWhitespaces( const std::pair<int, int>& lineRange,
 	cpoint->setDrawMode( GlyphDrawable::DrawMode::Text );
 	adv->setColor( color );
 	cpoint->setColor( color );
+	bool wordWrap = isWordWrapActive();
 	for ( int index = lineRange.first; index <= lineRange.second; index++ ) {
-		Vector2f position( { startScroll.x, startScroll.y + lineHeight * index } );
+		Vector2f position( { startScroll.x, startScroll.y + getLineYOffset( index ) } );
 		const auto& text = mDoc->line( index ).getText();
+		const std::vector<Int64>* breaks =
+			wordWrap ? &mVisualLines.getLine( index ).breaks : nullptr;
+		size_t nextBreak = 0;
 		for ( size_t i = 0; i < text.size(); i++ ) {
+			if ( breaks && nextBreak < breaks->size() &&
+				 ( (Int64)i == ( *breaks )[nextBreak] || position.y + lineHeight < mScreenPos.y ) ) {
+				// Jump to the next visual row, the rows above the screen are skipped.
+				i = ( *breaks )[nextBreak++];
+				position = { startScroll.x, position.y + lineHeight };
+				if ( position.y > mScreenPos.y + mSize.getHeight() )
+					break;
+			}
 			if ( position.x + mScroll.x + ( text[i] == '\t' ? tabWidth : glyphW ) >= mScreenPos.x &&
 				 position.x <= mScreenPos.x + mScroll.x + mSize.getWidth() ) {
 				if ( ' ' == text[i] ) {
@@ -2962,7 +3446,9 @@ void UICodeEditor::drawWhitespaces( const std::pair<int, int>& lineRange,
 					position.x += glyphW;
 				}
 			} else if ( position.x > mScreenPos.x + mSize.getWidth() ) {
-				break;
+				if ( !breaks || nextBreak >= breaks->size() )
+					break;
+				i = ( *breaks )[nextBreak] - 1;
 			} else {
 				position.x += glyphW;
 			}
@@ -3004,7 +3490,7 @@ void UICodeEditor::drawIndentationGuides( const std::pair<int, int>& lineRange,
 						 ? getTabWidth()
 						 : mDoc->getIndentWidth();
 	for ( int index = lineRange.first; index <= lineRange.second; index++ ) {
-		Vector2f position( { startScroll.x, startScroll.y + lineHeight * index } );
+		Vector2f position( { startScroll.x, startScroll.y + getLineYOffset( index ) } );
 		int spaces = getLineIndentGuideSpaces( *mDoc.get(), index, indentSize );
 		for ( int i = 0; i < spaces; i += indentSize )
 			p.drawRectangle( Rectf( { position.x + spaceW * i, position.y }, { w, lineHeight } ) );
@@ -3021,9 +3507,17 @@ void UICodeEditor::drawLineEndings( const std::pair<int, int>& lineRange,
 		nl = mFont->getGlyphDrawable( 172 /* '¬'*/, fontSize );
 	nl->setDrawMode( GlyphDrawable::DrawMode::Text );
 	nl->setColor( color );
+	bool wordWrap = isWordWrapActive();
 	for ( int index = lineRange.first; index <= lineRange.second; index++ ) {
-		Vector2f position( { startScroll.x + getLineWidth( index ) - getGlyphWidth(),
-							 startScroll.y + lineHeight * index } );
+		Vector2f position;
+		if ( wordWrap ) {
+			position = startScroll +
+					   getTextPositionOffset(
+						   { index, (Int64)mDoc->line( index ).getText().size() - 1 } );
+		} else {
+			position = { startScroll.x + getLineWidth( index ) - getGlyphWidth(),
+						 startScroll.y + lineHeight * index };
+		}
 		nl->draw( Vector2f( position.x, position.y ) );
 	}
 }
@@ -3276,30 +3770,30 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 
 	Float gutterWidth = PixelDensity::dpToPx( mMinimapConfig.gutterWidth );
 	Float lineY = rect.Top;
-	Color color = mColorScheme.getSyntaxStyle( "normal" ).color;
-	color.a *= 0.5f;
-	Float batchWidth = 0;
-	Float batchStart = rect.Left;
+	Float lineStart = rect.Left + gutterWidth;
 	Float minimapCutoffX = rect.Left + rect.getWidth();
-	std::string batchSyntaxType = "normal";
 	Float widthScale = charSpacing / getGlyphWidth();
-	auto flushBatch = [&]( const std::string& type ) {
-		Color oldColor = color;
-		color = mColorScheme.getSyntaxStyle( batchSyntaxType ).color;
-		if ( mMinimapConfig.syntaxHighlight && color != Color::Transparent ) {
-			color.a *= 0.5f;
-		} else {
-			color = oldColor;
-		}
 
-		if ( batchWidth > 0 ) {
-			primitives.setColor( color.blendAlpha( mAlpha ) );
-			primitives.drawRectangle( { { batchStart, lineY }, { batchWidth, charHeight } } );
-		}
+	MinimapTilesConfig tilesConfig{ charSpacing, rect.getWidth(), gutterWidth,
+									mMinimapConfig.tabWidth, mMinimapConfig.syntaxHighlight };
+	if ( tilesConfig != mMinimapTilesConfig ) {
+		mMinimapTiles.clear();
+		mMinimapTilesConfig = tilesConfig;
+	}
 
-		batchSyntaxType = type;
-		batchStart += batchWidth;
-		batchWidth = 0;
+	const MinimapTile* tile = nullptr;
+	Int64 tileIndex = -1;
+	auto drawLineText = [&]( const Int64& index ) {
+		if ( index / MinimapTileLines != tileIndex ) {
+			tileIndex = index / MinimapTileLines;
+			tile = &getMinimapTile( tileIndex );
+		}
+		size_t local = index - tileIndex * MinimapTileLines;
+		for ( size_t i = tile->lineRects[local]; i < tile->lineRects[local + 1]; i++ ) {
+			const MinimapRect& run = tile->rects[i];
+			primitives.setColor( Color( run.color ).blendAlpha( mAlpha ) );
+			primitives.drawRectangle( { { rect.Left + run.x, lineY }, { run.width, charHeight } } );
+		}
 	};
 
 	int endidx = minimapStartLine + maxMinmapLines;
@@ -3320,8 +3814,8 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 				Int64 endCol = pos + text.size();
 				selRect.Top = lineY;
 				selRect.Bottom = lineY + charHeight;
-				selRect.Left = batchStart + getXOffsetCol( { ln, startCol } ) * widthScale;
-				selRect.Right = batchStart + getXOffsetCol( { ln, endCol } ) * widthScale;
+				selRect.Left = lineStart + getXOffsetCol( { ln, startCol } ) * widthScale;
+				selRect.Right = lineStart + getXOffsetCol( { ln, endCol } ) * widthScale;
 				if ( selRect.Left < minimapCutoffX )
 					primitives.drawRectangle( selRect );
 				pos = endCol;
@@ -3411,10 +3905,6 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 
 	if ( mMinimapConfig.syntaxHighlight ) {
 		for ( int index = minimapStartLine; index <= endidx; index++ ) {
-			batchSyntaxType = "normal";
-			batchStart = rect.Left + gutterWidth;
-			batchWidth = 0;
-
 			if ( mHighlightWord.isEmpty() && !selectionString.empty() )
 				drawWordMatch( selectionString, index );
 
@@ -3423,40 +3913,7 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 												   { rect.getWidth(), charHeight }, charSpacing,
 												   gutterWidth );
 
-			const auto& tokens = mDoc->getHighlighter()->getLine( index );
-			const auto& text = mDoc->line( index ).getText();
-			size_t txtPos = 0;
-
-			for ( const auto& token : tokens ) {
-				if ( batchSyntaxType != token.type ) {
-					flushBatch( batchSyntaxType );
-					batchSyntaxType = token.type;
-				}
-
-				size_t pos = txtPos;
-				size_t end = pos + token.len <= text.size() ? txtPos + token.len : text.size();
-
-				while ( pos < end ) {
-					String::StringBaseType ch = text[pos];
-					if ( ch == ' ' || ch == '\n' ) {
-						flushBatch( token.type );
-						batchStart += charSpacing;
-					} else if ( ch == '\t' ) {
-						flushBatch( token.type );
-						batchStart += charSpacing * mMinimapConfig.tabWidth;
-					} else if ( batchStart + batchWidth > minimapCutoffX ) {
-						flushBatch( token.type );
-						break;
-					} else {
-						batchWidth += charSpacing;
-					}
-					pos++;
-				};
-
-				txtPos += token.len;
-			}
-
-			flushBatch( "normal" );
+			drawLineText( index );
 
 			for ( auto* plugin : mPlugins )
 				plugin->minimapDrawAfterLineText( this, index, { rect.Left, lineY },
@@ -3480,34 +3937,26 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 		}
 	} else {
 		for ( int index = minimapStartLine; index <= endidx; index++ ) {
-			batchSyntaxType = "normal";
-			batchStart = rect.Left + gutterWidth;
-			batchWidth = 0;
-
 			if ( mHighlightWord.isEmpty() && !selectionString.empty() )
 				drawWordMatch( selectionString, index );
 
-			const String& text( mDoc->line( index ).getText() );
-			for ( size_t i = 0; i < text.size(); ++i ) {
-				String::StringBaseType ch = text[i];
-				if ( ch == ' ' || ch == '\n' ) {
-					flushBatch( "normal" );
-					batchStart += charSpacing;
-				} else if ( ch == '\t' ) {
-					flushBatch( "normal" );
-					batchStart += charSpacing * mMinimapConfig.tabWidth;
-				} else if ( batchStart + batchWidth > minimapCutoffX ) {
-					flushBatch( "normal" );
-					break;
-				} else {
-					batchWidth += charSpacing;
-				}
-			}
-			flushBatch( "normal" );
+			drawLineText( index );
 			lineY = lineY + lineSpacing;
 		}
 	}
 
+	if ( mMinimapTiles.size() > MinimapMaxTiles ) {
+		Int64 firstTile = minimapStartLine / MinimapTileLines;
+		Int64 lastTile = endidx / MinimapTileLines;
+		for ( auto it = mMinimapTiles.begin(); it != mMinimapTiles.end(); ) {
+			if ( it->first < firstTile || it->first > lastTile ) {
+				it = mMinimapTiles.erase( it );
+			} else {
+				++it;
+			}
+		}
+	}
+
 	for ( size_t i = 0; i < mDoc->getSelections().size(); ++i ) {
 		Float selectionY =
 			rect.Top +
@@ -3518,6 +3967,127 @@ void UICodeEditor::drawMinimap( const Vector2f& start,
 	primitives.setForceDraw( true );
 }
 
+const UICodeEditor::MinimapTile& UICodeEditor::getMinimapTile( const Int64& tileIndex ) {
+	Int64 firstLine = tileIndex * MinimapTileLines;
+	Int64 lastLine = eemin<Int64>( firstLine + MinimapTileLines, mDoc->linesCount() ) - 1;
+	MinimapTile& tile = mMinimapTiles[tileIndex];
+	bool valid = static_cast<Int64>( tile.hashes.size() ) == lastLine - firstLine + 1;
+
+	for ( Int64 index = firstLine; valid && index <= lastLine; index++ ) {
+		size_t local = index - firstLine;
+		valid = tile.hashes[local] == mDoc->line( index ).getHash() &&
+				( !mMinimapTilesConfig.syntaxHighlight ||
+				  tile.signatures[local] == mDoc->getHighlighter()->getLineSignature( index ) );
+	}
+
+	if ( !valid )
+		buildMinimapTile( tile, firstLine, lastLine );
+
+	return tile;
+}
+
+void UICodeEditor::buildMinimapTile( MinimapTile& tile, const Int64& firstLine,
+									 const Int64& lastLine ) {
+	const MinimapTilesConfig& config = mMinimapTilesConfig;
+	Color color = mColorScheme.getSyntaxStyle( SyntaxStyleTypes::Normal ).color;
+	color.a *= 0.5f;
+	Float batchWidth = 0;
+	Float batchStart = 0;
+	SyntaxStyleType batchSyntaxType = SyntaxStyleTypes::Normal;
+	auto flushBatch = [&]( const SyntaxStyleType& type ) {
+		Color oldColor = color;
+		color = mColorScheme.getSyntaxStyle( batchSyntaxType ).color;
+		if ( config.syntaxHighlight && color != Color::Transparent ) {
+			color.a *= 0.5f;
+		} else {
+			color = oldColor;
+		}
+
+		if ( batchWidth > 0 )
+			tile.rects.push_back( { batchStart, batchWidth, color } );
+
+		batchSyntaxType = type;
+		batchStart += batchWidth;
+		batchWidth = 0;
+	};
+
+	tile.hashes.clear();
+	tile.signatures.clear();
+	tile.lineRects.clear();
+	tile.rects.clear();
+
+	for ( Int64 index = firstLine; index <= lastLine; index++ ) {
+		batchSyntaxType = SyntaxStyleTypes::Normal;
+		batchStart = config.gutterWidth;
+		batchWidth = 0;
+		tile.lineRects.push_back( tile.rects.size() );
+
+		const String& text = mDoc->line( index ).getText();
+
+		if ( config.syntaxHighlight ) {
+			const auto& tokens = mDoc->getHighlighter()->getLine( index );
+			size_t txtPos = 0;
+
+			for ( const auto& token : tokens ) {
+				if ( batchSyntaxType != token.type ) {
+					flushBatch( batchSyntaxType );
+					batchSyntaxType = token.type;
+				}
+
+				size_t pos = txtPos;
+				size_t end = pos + token.len <= text.size() ? txtPos + token.len : text.size();
+
+				while ( pos < end ) {
+					String::StringBaseType ch = text[pos];
+					if ( ch == ' ' || ch == '\n' ) {
+						flushBatch( token.type );
+						batchStart += config.charSpacing;
+					} else if ( ch == '\t' ) {
+						flushBatch( token.type );
+						batchStart += config.charSpacing * config.tabWidth;
+					} else if ( batchStart + batchWidth > config.width ) {
+						flushBatch( token.type );
+						break;
+					} else {
+						batchWidth += config.charSpacing;
+					}
+					pos++;
+				};
+
+				txtPos += token.len;
+			}
+		} else {
+			for ( size_t i = 0; i < text.size(); ++i ) {
+				String::StringBaseType ch = text[i];
+				if ( ch == ' ' || ch == '\n' ) {
+					flushBatch( SyntaxStyleTypes::Normal );
+					batchStart += config.charSpacing;
+				} else if ( ch == '\t' ) {
+					flushBatch( SyntaxStyleTypes::Normal );
+					batchStart += config.charSpacing * config.tabWidth;
+				} else if ( batchStart + batchWidth > config.width ) {
+					flushBatch( SyntaxStyleTypes::Normal );
+					break;
+				} else {
+					batchWidth += config.charSpacing;
+				}
+			}
+		}
+
+		flushBatch( SyntaxStyleTypes::Normal );
+
+		tile.hashes.push_back( mDoc->line( index ).getHash() );
+		tile.signatures.push_back(
+			config.syntaxHighlight ? mDoc->getHighlighter()->getLineSignature( index ) : 0 );
+	}
+
+	tile.lineRects.push_back( tile.rects.size() );
+}
+
+void UICodeEditor::invalidateMinimapTiles() {
+	mMinimapTiles.clear();
+}
+
 Vector2f UICodeEditor::getScreenStart() const {
 	return Vector2f( eefloor( mScreenPos.x + mPaddingPx.Left ),
 					 eefloor( mScreenPos.y + mPaddingPx.Top ) );
@@ -16,6 +16,7 @@ UIGridLayout::UIGridLayout() :
 	mRowWeight( 0.25f ),
 	mRowHeight( 0 ) {
 	mFlags |= UI_OWNS_CHILDS_POSITION;
+	mLayoutCacheEnabled = true;
 }
 
 Uint32 UIGridLayout::getType() const {
@@ -32,6 +33,7 @@ Sizei UIGridLayout::getBoxMargin() const {
 
 UIGridLayout* UIGridLayout::setBoxMargin( const Sizei& span ) {
 	mBoxMargin = span;
+	tryUpdateLayout();
 	invalidateDraw();
 	return this;
 }
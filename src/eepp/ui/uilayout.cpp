@@ -82,19 +82,51 @@ bool UILayout::isGravityOwner() const {
 }
 
 void UILayout::setGravityOwner( bool gravityOwner ) {
-	mGravityOwner = gravityOwner;
+	if ( gravityOwner != mGravityOwner ) {
+		mGravityOwner = gravityOwner;
+		tryUpdateLayout();
+	}
 }
 
 void UILayout::tryUpdateLayout() {
+	mLayoutCacheValid = false;
+
 	if ( mUISceneNode->isUpdatingLayouts() ) {
+		mUISceneNode->mLayoutStats.layouts++;
 		updateLayout();
 	} else if ( !mDirtyLayout ) {
 		setLayoutDirty();
 	}
 }
 
+UILayout::LayoutConstraints UILayout::getLayoutConstraints() const {
+	LayoutConstraints constraints;
+	constraints.size = getPixelsSize();
+	constraints.padding = mPaddingPx;
+	constraints.sceneSize = mUISceneNode->getPixelsSize();
+
+	if ( NULL != mParentNode ) {
+		constraints.parentSize = mParentNode->getPixelsSize();
+
+		if ( mParentNode->isWidget() )
+			constraints.parentPadding = mParentNode->asType<UIWidget>()->getPixelsPadding();
+	}
+
+	return constraints;
+}
+
 void UILayout::updateLayoutTree() {
-	updateLayout();
+	mLayoutPass = mUISceneNode->mLayoutPass;
+
+	if ( mLayoutCacheEnabled && mLayoutCacheValid && !mDirtyLayout &&
+		 mLayoutConstraints == getLayoutConstraints() ) {
+		mUISceneNode->mLayoutStats.cachedLayouts++;
+	} else {
+		mUISceneNode->mLayoutStats.layouts++;
+		updateLayout();
+		mLayoutConstraints = getLayoutConstraints();
+		mLayoutCacheValid = true;
+	}
 
 	for ( auto layout : mLayouts ) {
 		layout->updateLayoutTree();
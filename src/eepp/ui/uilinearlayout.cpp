@@ -24,12 +24,14 @@ UILinearLayout* UILinearLayout::NewHorizontal() {
 UILinearLayout::UILinearLayout() :
 	UILayout( "linearlayout" ), mOrientation( UIOrientation::Vertical ) {
 	mFlags |= UI_OWNS_CHILDS_POSITION;
+	mLayoutCacheEnabled = true;
 	setClipType( ClipType::ContentBox );
 }
 
 UILinearLayout::UILinearLayout( const std::string& tag, const UIOrientation& orientation ) :
 	UILayout( tag ), mOrientation( orientation ) {
 	mFlags |= UI_OWNS_CHILDS_POSITION;
+	mLayoutCacheEnabled = true;
 	setClipType( ClipType::ContentBox );
 }
 
@@ -46,7 +48,10 @@ UIOrientation UILinearLayout::getOrientation() const {
 }
 
 UILinearLayout* UILinearLayout::setOrientation( const UIOrientation& orientation ) {
-	mOrientation = orientation;
+	if ( orientation != mOrientation ) {
+		mOrientation = orientation;
+		tryUpdateLayout();
+	}
 	return this;
 }
 
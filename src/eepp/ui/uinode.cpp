@@ -1014,6 +1014,8 @@ void UINode::nodeDraw() {
 		if ( mNodeFlags & NODE_FLAG_POLYGON_DIRTY )
 			updateWorldPolygon();
 
+		updateDrawBoundsForDraw();
+
 		matrixSet();
 
 		smartClipStart( ClipType::BorderBox );
@@ -9,10 +9,12 @@ UIRelativeLayout* UIRelativeLayout::New() {
 
 UIRelativeLayout::UIRelativeLayout() : UILayout( "relativelayout" ) {
 	mFlags |= UI_OWNS_CHILDS_POSITION;
+	mLayoutCacheEnabled = true;
 }
 
 UIRelativeLayout::UIRelativeLayout( const std::string& tagName ) : UILayout( tagName ) {
 	mFlags |= UI_OWNS_CHILDS_POSITION;
+	mLayoutCacheEnabled = true;
 }
 
 Uint32 UIRelativeLayout::getType() const {
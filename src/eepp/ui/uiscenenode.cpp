@@ -574,6 +574,8 @@ void UISceneNode::update( const Time& elapsed ) {
 
 	SceneManager::instance()->setCurrentUISceneNode( this );
 
+	mLayoutStats = LayoutStats();
+
 	updateDirtyStyles();
 	updateDirtyStyleStates();
 	updateDirtyLayouts();
@@ -626,6 +628,11 @@ void UISceneNode::onWidgetDelete( Node* node ) {
 
 		if ( node->isLayout() ) {
 			mDirtyLayouts.erase( node->asType<UILayout>() );
+
+			for ( auto& queued : mLayoutQueue ) {
+				if ( queued.second == node )
+					queued.second = nullptr;
+			}
 		}
 
 		mDirtyStyle.erase( widget );
@@ -773,15 +780,45 @@ void UISceneNode::updateDirtyLayouts() {
 		Clock clock;
 		mUpdatingLayouts = true;
 
-		for ( UILayout* layout : mDirtyLayouts ) {
-			layout->updateLayoutTree();
+		// Layouts are updated top-down, a dirty layout already updated by the tree update of an
+		// ancestor is skipped. Layouts invalidated while updating are processed in a new pass.
+		for ( Uint32 pass = 0; pass < MaxLayoutPasses && !mDirtyLayouts.empty(); pass++ ) {
+			mLayoutPass++;
+			mLayoutQueue.clear();
+
+			for ( UILayout* layout : mDirtyLayouts ) {
+				size_t depth = 0;
+				for ( Node* node = layout->getParent(); NULL != node; node = node->getParent() )
+					depth++;
+				mLayoutQueue.emplace_back( depth, layout );
+			}
+
+			mDirtyLayouts.clear();
+
+			std::sort( mLayoutQueue.begin(), mLayoutQueue.end(),
+					   []( const std::pair<size_t, UILayout*>& lhs,
+						   const std::pair<size_t, UILayout*>& rhs ) {
+						   return lhs.first < rhs.first;
+					   } );
+
+			for ( size_t i = 0; i < mLayoutQueue.size(); i++ ) {
+				UILayout* layout = mLayoutQueue[i].second;
+
+				if ( NULL == layout || layout->mLayoutPass == mLayoutPass )
+					continue;
+
+				mLayoutStats.roots++;
+				layout->updateLayoutTree();
+			}
 		}
 
-		mDirtyLayouts.clear();
+		mLayoutQueue.clear();
 		mUpdatingLayouts = false;
 
 		if ( mVerbose )
-			Log::info( "Layout tree updated in %.2f ms", clock.getElapsedTime().asMilliseconds() );
+			Log::info( "Layout tree updated in %.2f ms ( %u layouts updated, %u cached )",
+					   clock.getElapsedTime().asMilliseconds(), mLayoutStats.layouts,
+					   mLayoutStats.cachedLayouts );
 	}
 }
 
@@ -817,6 +854,10 @@ const bool& UISceneNode::isUpdatingLayouts() const {
 	return mUpdatingLayouts;
 }
 
+const UISceneNode::LayoutStats& UISceneNode::getLayoutStats() const {
+	return mLayoutStats;
+}
+
 UIIconThemeManager* UISceneNode::getUIIconThemeManager() const {
 	return mUIIconThemeManager;
 }
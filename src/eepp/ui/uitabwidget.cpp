@@ -202,7 +202,8 @@ bool UITabWidget::isDrawInvalidator() const {
 }
 
 void UITabWidget::invalidate( Node* invalidator ) {
-	// Only invalidate if the invalidator is actually visible in the current active tab.
+	// Only invalidate if the invalidator is actually visible in the current active tab. The
+	// invalidator is forwarded so the scene only damages the area it covers.
 	if ( NULL != invalidator ) {
 		if ( invalidator == mTabScroll || mTabScroll->inParentTreeOf( invalidator ) ) {
 			if ( NULL != mNodeDrawInvalidator ) {
@@ -212,17 +213,17 @@ void UITabWidget::invalidate( Node* invalidator ) {
 			}
 		} else if ( invalidator == mNodeContainer || invalidator == mTabBar ||
 					mTabBar->inParentTreeOf( invalidator ) ) {
-			mNodeDrawInvalidator->invalidate( mNodeContainer );
+			mNodeDrawInvalidator->invalidate( invalidator );
 		} else if ( invalidator->getParent() == mNodeContainer ) {
 			if ( invalidator->isVisible() )
-				mNodeDrawInvalidator->invalidate( mNodeContainer );
+				mNodeDrawInvalidator->invalidate( invalidator );
 		} else {
 			Node* container = invalidator->getParent();
 			while ( container->getParent() != NULL && container->getParent() != mNodeContainer ) {
 				container = container->getParent();
 			}
 			if ( container->getParent() == mNodeContainer && container->isVisible() ) {
-				mNodeDrawInvalidator->invalidate( mNodeContainer );
+				mNodeDrawInvalidator->invalidate( invalidator );
 			}
 		}
 	} else if ( NULL != mNodeDrawInvalidator ) {
@@ -232,6 +233,22 @@ void UITabWidget::invalidate( Node* invalidator ) {
 	}
 }
 
+void UITabWidget::invalidateArea( Node* invalidator, const Rectf& area ) {
+	// Only the content of the tabs forwards the area, anything else is invalidated as usual.
+	if ( NULL == invalidator || NULL == mNodeDrawInvalidator ||
+		 !mNodeContainer->inParentTreeOf( invalidator ) ) {
+		invalidate( invalidator );
+		return;
+	}
+
+	Node* container = invalidator;
+	while ( container->getParent() != mNodeContainer )
+		container = container->getParent();
+
+	if ( container->isVisible() )
+		mNodeDrawInvalidator->invalidateArea( invalidator, area );
+}
+
 bool UITabWidget::applyProperty( const StyleSheetProperty& attribute ) {
 	if ( !checkPropertyDefinition( attribute ) )
 		return false;
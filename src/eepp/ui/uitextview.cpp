@@ -405,6 +405,40 @@ void UITextView::onSizeChange() {
 	UINode::onSizeChange();
 }
 
+void UITextView::updateDrawBounds() {
+	UIWidget::updateDrawBounds();
+
+	// Unclipped text can overflow the box, and its shadow and outline are drawn around the glyphs
+	if ( isClipped() || !mTextCache->getTextWidth() )
+		return;
+
+	Rectf textBounds( Vector2f( (Float)mScreenPosi.x + (int)mRealAlignOffset.x +
+									(int)mPaddingPx.Left,
+								mFontLineCenter + (Float)mScreenPosi.y + (int)mRealAlignOffset.y +
+									(int)mPaddingPx.Top ),
+					  Sizef( mTextCache->getTextWidth(), mTextCache->getTextHeight() ) );
+
+	if ( mTextCache->getStyle() & Text::Shadow ) {
+		const Vector2f& offset = mTextCache->getShadowOffset();
+		textBounds.Left += eemin( 0.f, offset.x );
+		textBounds.Top += eemin( 0.f, offset.y );
+		textBounds.Right += eemax( 0.f, offset.x );
+		textBounds.Bottom += eemax( 0.f, offset.y );
+	}
+
+	Float outline = mTextCache->getOutlineThickness();
+
+	if ( outline > 0 ) {
+		textBounds.Left -= outline;
+		textBounds.Top -= outline;
+		textBounds.Right += outline;
+		textBounds.Bottom += outline;
+	}
+
+	if ( !mDrawBounds.contains( textBounds ) )
+		expandDrawBounds( textBounds );
+}
+
 void UITextView::onTextChanged() {
 	sendCommonEvent( Event::OnTextChanged );
 	invalidateDraw();
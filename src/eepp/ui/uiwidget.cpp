@@ -489,6 +489,30 @@ void UIWidget::onSizeChange() {
 
 void UIWidget::onAutoSize() {}
 
+void UIWidget::updateDrawBounds() {
+	UINode::updateDrawBounds();
+
+	// Outside and outline borders are drawn around the box
+	if ( NULL != mBorder ) {
+		Rectf borderDiff( mBorder->getBorderBoxDiff() );
+
+		if ( borderDiff != Rectf() ) {
+			expandDrawBounds( Rectf( mScreenPos.x + borderDiff.Left, mScreenPos.y + borderDiff.Top,
+									 mScreenPos.x + mSize.getWidth() + borderDiff.Right,
+									 mScreenPos.y + mSize.getHeight() + borderDiff.Bottom ) );
+		}
+	}
+}
+
+void UIWidget::expandDrawBounds( const Rectf& rect ) {
+	if ( mNodeFlags & ( NODE_FLAG_ROTATED | NODE_FLAG_SCALED ) ) {
+		if ( NULL != mSceneNode )
+			mDrawBounds.expand( mSceneNode->getWorldBounds() );
+	} else {
+		mDrawBounds.expand( rect );
+	}
+}
+
 void UIWidget::onWidgetCreated() {}
 
 void UIWidget::notifyLayoutAttrChange() {
@@ -900,11 +924,25 @@ void UIWidget::reloadStyle( const bool& reloadChilds, const bool& disableAnimati
 	createStyle();
 
 	if ( NULL != mStyle ) {
+		// The subtree root sets up the ancestors filter, every widget pushes itself to the filter
+		// while its children are styled.
+		CSS::StyleSheetSelectorFilter& filter =
+			getUISceneNode()->getStyleSheet().getSelectorFilter();
+		bool ownsFilter = NULL != getFirstChild() && reloadChilds && filter.isEmpty();
+
+		if ( ownsFilter )
+			filter.setupParentStack( getStyleSheetParentElement() );
+
 		mStyle->load();
 
 		if ( NULL != getFirstChild() && reloadChilds ) {
+			bool pushParent = ownsFilter || ( !filter.isEmpty() &&
+											  filter.getParent() == getStyleSheetParentElement() );
 			Node* child = getFirstChild();
 
+			if ( pushParent )
+				filter.pushParent( this );
+
 			while ( NULL != child ) {
 				if ( child->isWidget() )
 					child->asType<UIWidget>()->reloadStyle( reloadChilds, disableAnimations,
@@ -913,10 +951,16 @@ void UIWidget::reloadStyle( const bool& reloadChilds, const bool& disableAnimati
 
 				child = child->getNextNode();
 			}
+
+			if ( pushParent )
+				filter.popParent();
 		}
 
 		if ( reportStateChange )
 			reportStyleStateChange( disableAnimations, forceReApplyProperties );
+
+		if ( ownsFilter )
+			filter.clear();
 	}
 }
 
@@ -354,6 +354,17 @@ void UIWindow::drawHighlightInvalidation() {
 	}
 }
 
+void UIWindow::updateDrawBounds() {
+	UIWidget::updateDrawBounds();
+
+	if ( mStyleConfig.WinFlags & UI_WIN_SHADOW ) {
+		Float SSize = PixelDensity::dpToPx( 16.f );
+		mDrawBounds.Left -= SSize;
+		mDrawBounds.Right += SSize;
+		mDrawBounds.Bottom += SSize * 2;
+	}
+}
+
 void UIWindow::drawShadow() {
 	if ( mStyleConfig.WinFlags & UI_WIN_SHADOW ) {
 		UIWidget::matrixSet();
@@ -1251,6 +1262,8 @@ void UIWindow::nodeDraw() {
 		if ( mNodeFlags & NODE_FLAG_POLYGON_DIRTY )
 			updateWorldPolygon();
 
+		updateDrawBoundsForDraw();
+
 		preDraw();
 
 		drawShadow();
@@ -35,6 +35,7 @@ void InputSDL::update() {
 	}
 	while ( SDL_PollEvent( &SDLEvent ) )
 		sendEvent( SDLEvent );
+	processInjectedEvents();
 	InputEvent endProcessingEvent;
 	endProcessingEvent.Type = InputEvent::EventsSent;
 	processEvent( &endProcessingEvent );
@@ -0,0 +1,66 @@
+#include <eepp/window/backend/SDL2/windowheadlesssdl2.hpp>
+
+#ifdef EE_BACKEND_SDL2
+
+namespace EE { namespace Window { namespace Backend { namespace SDL2 {
+
+static ContextSettings headlessContext( ContextSettings context ) {
+	// Nothing is presented, waiting for the vertical sync only slows down the frames
+	context.VSync = false;
+	return context;
+}
+
+WindowHeadlessSDL::WindowHeadlessSDL( WindowSettings Settings, ContextSettings Context ) :
+	WindowSDL( Settings, headlessContext( Context ) ) {
+	setFixedTimeStep( Microseconds( DefaultTimeStepMicroseconds ) );
+}
+
+WindowHeadlessSDL::~WindowHeadlessSDL() {}
+
+bool WindowHeadlessSDL::isActive() {
+	return mWindow.Created;
+}
+
+bool WindowHeadlessSDL::isVisible() {
+	return mWindow.Created;
+}
+
+bool WindowHeadlessSDL::hasFocus() {
+	return mWindow.Created;
+}
+
+bool WindowHeadlessSDL::hasInputFocus() {
+	return mWindow.Created;
+}
+
+bool WindowHeadlessSDL::hasMouseFocus() {
+	return mWindow.Created;
+}
+
+void WindowHeadlessSDL::toggleFullscreen() {}
+
+void WindowHeadlessSDL::minimize() {}
+
+void WindowHeadlessSDL::maximize() {}
+
+bool WindowHeadlessSDL::isMaximized() {
+	return false;
+}
+
+void WindowHeadlessSDL::hide() {}
+
+void WindowHeadlessSDL::raise() {}
+
+void WindowHeadlessSDL::show() {}
+
+void WindowHeadlessSDL::setPosition( int Left, int Top ) {
+	mHeadlessPos = Vector2i( Left, Top );
+}
+
+Vector2i WindowHeadlessSDL::getPosition() {
+	return mHeadlessPos;
+}
+
+}}}} // namespace EE::Window::Backend::SDL2
+
+#endif
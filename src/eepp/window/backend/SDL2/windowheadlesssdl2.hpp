@@ -0,0 +1,60 @@
+#ifndef EE_WINDOWCWINDOWHEADLESSSDL2_HPP
+#define EE_WINDOWCWINDOWHEADLESSSDL2_HPP
+
+#include <eepp/window/backend/SDL2/windowsdl2.hpp>
+
+#ifdef EE_BACKEND_SDL2
+
+namespace EE { namespace Window { namespace Backend { namespace SDL2 {
+
+/** @brief A window that is never presented to the user.
+ * It renders into an offscreen GL context ( or a hidden window if the offscreen driver is not
+ * available ), always reports itself as visible and focused so the UI behaves as in an interactive
+ * session, and advances its clock in fixed steps. Input can be simulated with
+ * Input::injectEvent. */
+class EE_API WindowHeadlessSDL : public WindowSDL {
+  public:
+	/** The default fixed frame time, 60 frames per second. */
+	static constexpr Int64 DefaultTimeStepMicroseconds = 16667;
+
+	WindowHeadlessSDL( WindowSettings Settings, ContextSettings Context );
+
+	virtual ~WindowHeadlessSDL();
+
+	bool isActive();
+
+	bool isVisible();
+
+	bool hasFocus();
+
+	bool hasInputFocus();
+
+	bool hasMouseFocus();
+
+	void toggleFullscreen();
+
+	void minimize();
+
+	void maximize();
+
+	bool isMaximized();
+
+	void hide();
+
+	void raise();
+
+	void show();
+
+	void setPosition( int Left, int Top );
+
+	Vector2i getPosition();
+
+  protected:
+	Vector2i mHeadlessPos;
+};
+
+}}}} // namespace EE::Window::Backend::SDL2
+
+#endif
+
+#endif
@@ -180,6 +180,26 @@ void hideOSK() {
 
 namespace EE { namespace Window { namespace Backend { namespace SDL2 {
 
+/** Selects the video driver used by the next SDL_Init call, NULL restores the default selection.
+ * The process environment is left as the user set it. */
+static void setVideoDriver( const char* driver ) {
+#if SDL_VERSION_ATLEAST( 2, 0, 22 )
+	SDL_SetHint( SDL_HINT_VIDEODRIVER, driver );
+#else
+	// Older SDL versions only read the driver from the environment, it's only set during the
+	// initialization ( and only when the user did not set it ).
+	if ( NULL != driver ) {
+		SDL_setenv( "SDL_VIDEODRIVER", driver, 1 );
+	} else {
+#if EE_PLATFORM == EE_PLATFORM_WIN
+		_putenv_s( "SDL_VIDEODRIVER", "" );
+#else
+		unsetenv( "SDL_VIDEODRIVER" );
+#endif
+	}
+#endif
+}
+
 WindowSDL::WindowSDL( WindowSettings Settings, ContextSettings Context ) :
 	Window( Settings, Context, eeNew( ClipboardSDL, ( this ) ), eeNew( InputSDL, ( this ) ),
 			eeNew( CursorManagerSDL, ( this ) ) ),
@@ -227,7 +247,28 @@ bool WindowSDL::create( WindowSettings Settings, ContextSettings Context ) {
 	mWindow.WindowConfig = Settings;
 	mWindow.ContextConfig = Context;
 
-	if ( SDL_Init( SDL_INIT_VIDEO ) != 0 ) {
+	bool headless = mWindow.WindowConfig.Backend == WindowBackend::Headless;
+	bool forceDriver = headless && NULL == SDL_getenv( "SDL_VIDEODRIVER" );
+
+	// The offscreen driver provides a GL context without a display, the user can still pick
+	// another driver with SDL_VIDEODRIVER.
+	if ( forceDriver )
+		setVideoDriver( "offscreen" );
+
+	int initRes = SDL_Init( SDL_INIT_VIDEO );
+
+	if ( forceDriver ) {
+		setVideoDriver( NULL );
+
+		if ( initRes != 0 ) {
+			Log::warning(
+				"Offscreen video driver not available (%s), using a hidden window instead",
+				SDL_GetError() );
+			initRes = SDL_Init( SDL_INIT_VIDEO );
+		}
+	}
+
+	if ( initRes != 0 ) {
 		Log::error( "Unable to initialize SDL: %s", SDL_GetError() );
 
 		logFailureInit( "WindowSDL", getVersion() );
@@ -249,7 +290,8 @@ bool WindowSDL::create( WindowSettings Settings, ContextSettings Context ) {
 		mWindow.WindowConfig.Height = mWindow.DesktopResolution.getHeight();
 	}
 
-	mWindow.Flags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN | SDL_WINDOW_ALLOW_HIGHDPI;
+	mWindow.Flags = SDL_WINDOW_OPENGL | ( headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN ) |
+					SDL_WINDOW_ALLOW_HIGHDPI;
 
 	if ( mWindow.WindowConfig.Style & WindowStyle::Resize ) {
 		mWindow.Flags |= SDL_WINDOW_RESIZABLE;
@@ -263,7 +305,7 @@ bool WindowSDL::create( WindowSettings Settings, ContextSettings Context ) {
 
 	Uint32 tmpFlags = mWindow.Flags;
 
-	if ( mWindow.WindowConfig.Style & WindowStyle::Fullscreen ) {
+	if ( ( mWindow.WindowConfig.Style & WindowStyle::Fullscreen ) && !headless ) {
 		tmpFlags |= SDL_WINDOW_FULLSCREEN;
 	}
 
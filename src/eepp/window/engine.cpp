@@ -21,6 +21,7 @@
 #include <eepp/window/backend.hpp>
 #include <eepp/window/backend/SDL2/backendsdl2.hpp>
 #include <eepp/window/backend/SDL2/platformhelpersdl2.hpp>
+#include <eepp/window/backend/SDL2/windowheadlesssdl2.hpp>
 #include <eepp/window/engine.hpp>
 
 #if EE_PLATFORM == EE_PLATFORM_ANDROID
@@ -140,6 +141,19 @@ EE::Window::Window* Engine::createSDL2Window( const WindowSettings& Settings,
 #endif
 }
 
+EE::Window::Window* Engine::createHeadlessWindow( const WindowSettings& Settings,
+												  const ContextSettings& Context ) {
+#if defined( EE_SDL_VERSION_2 )
+	if ( NULL == mBackend ) {
+		mBackend = createSDL2Backend( Settings );
+	}
+
+	return eeNew( Backend::SDL2::WindowHeadlessSDL, ( Settings, Context ) );
+#else
+	return NULL;
+#endif
+}
+
 EE::Window::Window* Engine::createDefaultWindow( const WindowSettings& Settings,
 												 const ContextSettings& Context ) {
 #if DEFAULT_BACKEND == BACKEND_SDL2
@@ -159,6 +173,9 @@ EE::Window::Window* Engine::createWindow( WindowSettings Settings, ContextSettin
 	}
 
 	switch ( Settings.Backend ) {
+		case WindowBackend::Headless:
+			window = createHeadlessWindow( Settings, Context );
+			break;
 		case WindowBackend::Default:
 		default:
 			window = createDefaultWindow( Settings, Context );
@@ -289,6 +306,8 @@ WindowSettings Engine::createWindowSettings( IniFile* ini, std::string iniKeyNam
 
 	if ( "sdl2" == backend )
 		winBackend = WindowBackend::SDL2;
+	else if ( "headless" == backend )
+		winBackend = WindowBackend::Headless;
 
 	Uint32 Style = WindowStyle::Titlebar;
 
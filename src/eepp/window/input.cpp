@@ -1,3 +1,4 @@
+#include <eepp/system/lock.hpp>
 #include <eepp/window/engine.hpp>
 #include <eepp/window/input.hpp>
 
@@ -53,6 +54,26 @@ void Input::sendEvent( InputEvent* Event ) {
 	}
 }
 
+void Input::injectEvent( const InputEvent& event ) {
+	Lock l( mInjectedEventsMutex );
+	mInjectedEvents.push_back( event );
+}
+
+void Input::processInjectedEvents() {
+	std::vector<InputEvent> events;
+
+	{
+		Lock l( mInjectedEventsMutex );
+		if ( mInjectedEvents.empty() )
+			return;
+		events.swap( mInjectedEvents );
+	}
+
+	for ( auto& event : events ) {
+		processEvent( &event );
+	}
+}
+
 void Input::processEvent( InputEvent* Event ) {
 	switch ( Event->Type ) {
 		case InputEvent::Window: {
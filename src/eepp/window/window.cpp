@@ -327,6 +327,17 @@ void Window::updateElapsedTime() {
 	}
 
 	mFrameData.ElapsedTime = mFrameData.FrameElapsed->getElapsedTimeAndReset();
+
+	if ( mFrameData.FixedTimeStep != Time::Zero )
+		mFrameData.ElapsedTime = mFrameData.FixedTimeStep;
+}
+
+void Window::setFixedTimeStep( const Time& timeStep ) {
+	mFrameData.FixedTimeStep = timeStep;
+}
+
+const Time& Window::getFixedTimeStep() const {
+	return mFrameData.FixedTimeStep;
 }
 
 const Time& Window::getSleepTimePerSecond() const {
@@ -0,0 +1,710 @@
+#include <algorithm>
+#include <args/args.hxx>
+#include <cmath>
+#include <eepp/ee.hpp>
+#include <eepp/system/iostreammemory.hpp>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <random>
+
+using json = nlohmann::json;
+
+/* Microbenchmarks for the hot paths of the library.
+ * Every benchmark runs its function until the minimum time and iterations are reached, and reports
+ * the per iteration statistics. Results can be saved as JSON to compare them between releases:
+ * eepp-benchmark --output results.json
+ */
+
+static volatile Uint64 sSink = 0;
+
+template <typename T> static void doNotOptimize( const T& value ) {
+	sSink = sSink + static_cast<Uint64>( value );
+}
+
+class BenchmarkRunner {
+  public:
+	BenchmarkRunner( const std::string& filter, const Time& minTime, const Uint64& minIterations ) :
+		mFilter( filter ), mMinTime( minTime ), mMinIterations( minIterations ) {}
+
+	bool isEnabled( const std::string& group, const std::string& name = "" ) const {
+		if ( mFilter.empty() )
+			return true;
+		if ( !name.empty() )
+			return String::contains( group + "/" + name, mFilter );
+		// A group is enabled if any of its benchmarks could match the filter
+		size_t slash = mFilter.find_first_of( '/' );
+		if ( slash == std::string::npos )
+			return true;
+		return String::endsWith( group, mFilter.substr( 0, slash ) );
+	}
+
+	/** Runs func until the minimum time and iterations are reached. setup is called before every
+	 * iteration and is not measured. bytes is the amount of data processed per iteration, used to
+	 * report the throughput. */
+	void run( const std::string& group, const std::string& name,
+			  const std::function<void()>& func, const Uint64& bytes = 0,
+			  const std::function<void()>& setup = nullptr ) {
+		if ( !isEnabled( group, name ) )
+			return;
+
+		Result result;
+		result.group = group;
+		result.name = name;
+		result.bytes = bytes;
+
+		// Warm up the caches
+		if ( setup )
+			setup();
+		func();
+
+		// The setup time is not counted
+		double measured = 0;
+		double minTime = mMinTime.asMicroseconds();
+		while ( ( result.samples.size() < mMinIterations || measured < minTime ) &&
+				result.samples.size() < MaxIterations ) {
+			if ( setup )
+				setup();
+
+			Clock clock;
+			func();
+			result.samples.push_back( clock.getElapsedTime().asMicroseconds() );
+			measured += result.samples.back();
+		}
+
+		print( result );
+		mResults.emplace_back( std::move( result ) );
+	}
+
+	void skip( const std::string& group, const std::string& reason ) {
+		if ( !isEnabled( group ) )
+			return;
+		std::cout << group << ": skipped ( " << reason << " )" << std::endl;
+		mSkipped.push_back( { { "group", group }, { "reason", reason } } );
+	}
+
+	json toJson() const {
+		json j;
+		j["version"] = Version::getVersionName();
+		j["platform"] = Sys::getPlatform();
+		j["os"] = Sys::getOSName();
+		j["cpu_count"] = Sys::getCPUCount();
+		j["date"] = Sys::getDateTimeStr();
+		j["min_time_ms"] = mMinTime.asMilliseconds();
+		j["results"] = json::array();
+		for ( const auto& result : mResults ) {
+			Stats stats( result.samples );
+			json r;
+			r["group"] = result.group;
+			r["name"] = result.name;
+			r["iterations"] = result.samples.size();
+			r["mean_us"] = stats.mean;
+			r["median_us"] = stats.median;
+			r["min_us"] = stats.min;
+			r["max_us"] = stats.max;
+			r["stddev_us"] = stats.stddev;
+			if ( result.bytes ) {
+				r["bytes_per_iteration"] = result.bytes;
+				r["throughput_mb_s"] = throughput( result.bytes, stats.median );
+			}
+			j["results"].push_back( r );
+		}
+		j["skipped"] = mSkipped;
+		return j;
+	}
+
+  protected:
+	static constexpr size_t MaxIterations = 100000;
+
+	struct Result {
+		std::string group;
+		std::string name;
+		Uint64 bytes{ 0 };
+		std::vector<double> samples;
+	};
+
+	struct Stats {
+		double mean{ 0 };
+		double median{ 0 };
+		double min{ 0 };
+		double max{ 0 };
+		double stddev{ 0 };
+
+		Stats( std::vector<double> samples ) {
+			if ( samples.empty() )
+				return;
+			std::sort( samples.begin(), samples.end() );
+			double sum = 0;
+			for ( const auto& sample : samples )
+				sum += sample;
+			mean = sum / samples.size();
+			size_t mid = samples.size() / 2;
+			median = samples.size() % 2 ? samples[mid] : ( samples[mid - 1] + samples[mid] ) / 2;
+			min = samples.front();
+			max = samples.back();
+			double variance = 0;
+			for ( const auto& sample : samples )
+				variance += ( sample - mean ) * ( sample - mean );
+			stddev = std::sqrt( variance / samples.size() );
+		}
+	};
+
+	std::string mFilter;
+	Time mMinTime;
+	Uint64 mMinIterations;
+	std::vector<Result> mResults;
+	json mSkipped = json::array();
+
+	static double throughput( const Uint64& bytes, const double& microseconds ) {
+		return microseconds > 0 ? ( bytes / ( 1024.0 * 1024.0 ) ) / ( microseconds / 1000000.0 )
+								: 0;
+	}
+
+	void print( const Result& result ) const {
+		Stats stats( result.samples );
+		std::string line( String::format( "%-48s %8zu it  median %12.2f us  mean %12.2f us  "
+										  "stddev %10.2f us",
+										  ( result.group + "/" + result.name ).c_str(),
+										  result.samples.size(), stats.median, stats.mean,
+										  stats.stddev ) );
+		if ( result.bytes )
+			line += String::format( "  %10.2f MB/s", throughput( result.bytes, stats.median ) );
+		std::cout << line << std::endl;
+	}
+};
+
+static const char* sSourceLines[] = {
+	"#include <eepp/system/filesystem.hpp>",
+	"/* Multi-line comment with some unicode: áéíóú ñandú 日本語 */",
+	"namespace EE { namespace System {",
+	"static const char* kName = \"benchmark \\\"quoted\\\" string\";",
+	"int FileSystem::fileSize( const std::string& filepath ) { // comment",
+	"\tfor ( size_t i = 0; i < 0x1F + 42; ++i ) { value += i * 3.14159f; }",
+	"\tif ( NULL != mHandle && mSize > 1024 ) return mSize - offset;",
+	"\tstd::vector<std::string> lines = String::split( text, '\\n', true );",
+	"}}} // namespace EE::System",
+	"",
+};
+
+static std::string makeSourceText( size_t linesCount ) {
+	std::string text;
+	size_t count = eeARRAY_SIZE( sSourceLines );
+	for ( size_t i = 0; i < linesCount; ++i ) {
+		text += sSourceLines[i % count];
+		text += '\n';
+	}
+	return text;
+}
+
+static std::vector<std::string> makeFilePaths( size_t count ) {
+	static const char* dirs[] = { "src/eepp/ui/",	  "src/eepp/system/", "include/eepp/ui/doc/",
+								  "src/tools/ecode/", "src/thirdparty/",  "bin/assets/ui/" };
+	static const char* names[] = { "uicodeeditor", "textdocument", "filesystem", "stylesheet",
+								   "projectsearch", "syntaxtokenizer", "luapattern", "widget" };
+	static const char* exts[] = { ".cpp", ".hpp", ".css", ".json", ".lua" };
+	std::mt19937 rng( 1234 );
+	std::vector<std::string> paths;
+	paths.reserve( count );
+	for ( size_t i = 0; i < count; ++i ) {
+		paths.push_back( std::string( dirs[rng() % eeARRAY_SIZE( dirs )] ) +
+						 names[rng() % eeARRAY_SIZE( names )] + String::toString( i ) +
+						 exts[rng() % eeARRAY_SIZE( exts )] );
+	}
+	return paths;
+}
+
+static void benchmarkString( BenchmarkRunner& runner ) {
+	const std::string group( "String" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string utf8( makeSourceText( 50000 ) );
+	String utf32( String::fromUtf8( utf8 ) );
+
+	runner.run(
+		group, "fromUtf8", [&] { doNotOptimize( String::fromUtf8( utf8 ).size() ); },
+		utf8.size() );
+
+	runner.run(
+		group, "toUtf8", [&] { doNotOptimize( utf32.toUtf8().size() ); }, utf8.size() );
+
+	runner.run(
+		group, "BMH::find",
+		[&] {
+			Int64 pos = 0;
+			Uint64 found = 0;
+			while ( ( pos = String::BMH::find( utf8, "String::split", pos ) ) != -1 ) {
+				++found;
+				++pos;
+			}
+			doNotOptimize( found );
+		},
+		utf8.size() );
+
+	std::vector<std::string> paths( makeFilePaths( 50000 ) );
+	runner.run( group, "fuzzyMatch", [&] {
+		Int64 score = 0;
+		for ( const auto& path : paths )
+			score += String::fuzzyMatch( path, "uicodeedcpp" );
+		doNotOptimize( score );
+	} );
+}
+
+static void benchmarkLuaPattern( BenchmarkRunner& runner ) {
+	const std::string group( "LuaPattern" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string text( makeSourceText( 20000 ) );
+
+	auto findAll = [&text]( const LuaPattern& pattern ) {
+		int start = 0, end = 0, offset = 0;
+		Uint64 found = 0;
+		while ( offset < (int)text.size() && pattern.find( text, start, end, offset ) ) {
+			++found;
+			offset = eemax( end, start + 1 );
+		}
+		doNotOptimize( found );
+	};
+
+	LuaPattern identifier( "[%a_][%w_]*" );
+	runner.run( group, "find identifiers", [&] { findAll( identifier ); }, text.size() );
+
+	LuaPattern number( "0x[%da-fA-F]+" );
+	runner.run( group, "find hex numbers", [&] { findAll( number ); }, text.size() );
+
+	LuaPattern string( "\"[^\"]*\"" );
+	runner.run( group, "find strings", [&] { findAll( string ); }, text.size() );
+}
+
+/** Checks that the first characters prefilter of the compiled syntax patterns never changes a
+ * match: every pattern of every bundled syntax definition is run at every position of a sample
+ * text with and without the prefilter.
+ * @return The number of mismatches found. */
+static size_t verifySyntaxPatternsPrefilter( BenchmarkRunner& runner ) {
+	const std::string group( "LuaPattern" );
+	if ( !runner.isEnabled( group, "prefilter" ) )
+		return 0;
+
+	std::vector<std::string> lines( String::split( makeSourceText( eeARRAY_SIZE( sSourceLines ) ),
+												   '\n', true ) );
+	// Markup, escapes, numbers and every printable ASCII character, to reach most of the patterns
+	lines.push_back( "<a href='#'>&amp; <!-- c --></a> # Title **bold** `code` [link](url) $x" );
+	lines.push_back(
+		"@decorator def f(x=1e-3, *args): return x ** 2 -- comment ;; %d \\t \\u00e1" );
+	std::string ascii;
+	for ( char c = ' '; c < 127; ++c )
+		ascii += c;
+	lines.push_back( ascii );
+	for ( auto& line : lines )
+		line += '\n';
+
+	LuaPattern::Range filtered[32];
+	LuaPattern::Range unfiltered[32];
+	size_t patterns = 0;
+	size_t mismatches = 0;
+
+	for ( const auto& definition : SyntaxDefinitionManager::instance()->getDefinitions() ) {
+		for ( const auto& pattern : definition.getPatterns() ) {
+			for ( const auto& matcher : pattern.matchers ) {
+				++patterns;
+				for ( const auto& line : lines ) {
+					for ( int i = 0; i < (int)line.size(); ++i ) {
+						size_t count =
+							matcher.getMatches( line.c_str(), i, filtered, line.size() );
+						size_t expected = matcher.getMatchesUnfiltered( line.c_str(), i,
+																		unfiltered, line.size() );
+						bool same = count == expected;
+						for ( size_t m = 0; same && m < count; ++m )
+							same = filtered[m].start == unfiltered[m].start &&
+								   filtered[m].end == unfiltered[m].end;
+						if ( !same ) {
+							if ( ++mismatches <= 10 ) {
+								std::cerr << group << "/prefilter: " << definition.getLanguageName()
+										  << " pattern \"" << matcher.getPatern()
+										  << "\" differs at " << i << " of: " << line;
+							}
+							break;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	std::cout << group << "/prefilter: " << patterns << " patterns verified, " << mismatches
+			  << " mismatches" << std::endl;
+	return mismatches;
+}
+
+static void benchmarkSyntaxTokenizer( BenchmarkRunner& runner ) {
+	const std::string group( "SyntaxTokenizer" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string text( makeSourceText( 5000 ) );
+	std::vector<std::string> lines( String::split( text, '\n', true ) );
+	for ( auto& line : lines )
+		line += '\n';
+
+	auto tokenize = [&lines]( const SyntaxDefinition& syntax ) {
+		Uint32 state = SYNTAX_TOKENIZER_STATE_NONE;
+		Uint64 tokens = 0;
+		for ( const auto& line : lines ) {
+			auto res = SyntaxTokenizer::tokenize( syntax, line, state );
+			state = res.second;
+			tokens += res.first.size();
+		}
+		doNotOptimize( tokens );
+	};
+
+	for ( const auto& language :
+		  { "C++", "Lua", "Python", "JavaScript", "CSS", "XML", "JSON", "Markdown" } ) {
+		const auto& syntax = SyntaxDefinitionManager::instance()->getByLanguageName( language );
+		if ( syntax.getLanguageName() != language )
+			continue;
+		runner.run( group, language, [&] { tokenize( syntax ); }, text.size() );
+	}
+
+	std::vector<std::string> languages( SyntaxDefinitionManager::instance()->getLanguageNames() );
+	std::vector<std::string> shortLines( lines.begin(),
+										 lines.begin() + eemin<size_t>( 100, lines.size() ) );
+	runner.run( group, "all languages", [&] {
+		Uint64 tokens = 0;
+		for ( const auto& language : languages ) {
+			const auto& syntax = SyntaxDefinitionManager::instance()->getByLanguageName( language );
+			Uint32 state = SYNTAX_TOKENIZER_STATE_NONE;
+			for ( const auto& line : shortLines ) {
+				auto res = SyntaxTokenizer::tokenize( syntax, line, state );
+				state = res.second;
+				tokens += res.first.size();
+			}
+		}
+		doNotOptimize( tokens );
+	} );
+}
+
+static void benchmarkTextDocument( BenchmarkRunner& runner ) {
+	const std::string group( "TextDocument" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string text( makeSourceText( 100000 ) );
+	TextDocument doc;
+	auto reload = [&] { doc.loadFromMemory( (const Uint8*)text.data(), text.size() ); };
+
+	runner.run( group, "load", reload, text.size() );
+
+	std::mt19937 rng( 1234 );
+	runner.run(
+		group, "insert",
+		[&] {
+			for ( size_t i = 0; i < 1000; ++i ) {
+				Int64 line = rng() % doc.linesCount();
+				Int64 column = rng() % doc.line( line ).size();
+				doc.insert( 0, { line, column }, "inserted text" );
+			}
+		},
+		0, reload );
+
+	runner.run(
+		group, "remove",
+		[&] {
+			for ( size_t i = 0; i < 1000; ++i ) {
+				Int64 line = rng() % ( doc.linesCount() - 1 );
+				doc.remove( 0, { { line, 0 }, { line + 1, 0 } } );
+			}
+		},
+		0, reload );
+
+	reload();
+	runner.run(
+		group, "find",
+		[&] {
+			TextPosition from( 0, 0 );
+			TextRange found;
+			Uint64 count = 0;
+			while ( ( found = doc.find( "String::split", from ) ).isValid() ) {
+				from = found.end();
+				++count;
+			}
+			doNotOptimize( count );
+		},
+		text.size() );
+
+	runner.run(
+		group, "findAll", [&] { doNotOptimize( doc.findAll( "mHandle" ).size() ); },
+		text.size() );
+
+	runner.run(
+		group, "replaceAll", [&] { doNotOptimize( doc.replaceAll( "mHandle", "mFileHandle" ) ); },
+		text.size(), reload );
+}
+
+static void benchmarkCompression( BenchmarkRunner& runner ) {
+	const std::string group( "Compression" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string text( makeSourceText( 100000 ) );
+	const Uint8* src = (const Uint8*)text.data();
+
+	for ( const auto& mode : { Compression::MODE_DEFLATE, Compression::MODE_GZIP } ) {
+		std::string modeName( mode == Compression::MODE_DEFLATE ? "deflate" : "gzip" );
+		std::vector<Uint8> compressed( Compression::getMaxCompressedBufferSize( text.size(), mode ) );
+		std::vector<Uint8> decompressed( text.size() );
+		Uint64 compressedSize = 0;
+
+		runner.run(
+			group, "compress " + modeName,
+			[&] {
+				IOStreamMemory dst( (char*)compressed.data(), compressed.size() );
+				IOStreamMemory in( (const char*)src, text.size() );
+				Compression::compress( dst, in, mode );
+				compressedSize = dst.tell();
+				doNotOptimize( compressedSize );
+			},
+			text.size() );
+
+		runner.run(
+			group, "decompress " + modeName,
+			[&] {
+				doNotOptimize( Compression::decompress( decompressed.data(), decompressed.size(),
+														compressed.data(), compressedSize,
+														mode ) );
+			},
+			text.size() );
+	}
+}
+
+static void benchmarkPack( BenchmarkRunner& runner, const std::string& group, Pack* pack,
+						   const std::string& path ) {
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string text( makeSourceText( 2000 ) );
+	std::vector<std::string> files;
+
+	FileSystem::fileRemove( path );
+	if ( !pack->create( path ) ) {
+		runner.skip( group, "can't create " + path );
+		return;
+	}
+	for ( size_t i = 0; i < 64; ++i ) {
+		files.push_back( "files/file" + String::toString( i ) + ".cpp" );
+		pack->addFile( (const Uint8*)text.data(), text.size(), files.back() );
+	}
+	pack->close();
+
+	if ( !pack->open( path ) ) {
+		runner.skip( group, "can't open " + path );
+		FileSystem::fileRemove( path );
+		return;
+	}
+
+	runner.run(
+		group, "extractFileToMemory",
+		[&] {
+			ScopedBuffer buffer;
+			Uint64 total = 0;
+			for ( const auto& file : files ) {
+				pack->extractFileToMemory( file, buffer );
+				total += buffer.length();
+			}
+			doNotOptimize( total );
+		},
+		text.size() * files.size() );
+
+	pack->close();
+	FileSystem::fileRemove( path );
+}
+
+static void benchmarkTexturePacker( BenchmarkRunner& runner ) {
+	const std::string group( "TexturePacker" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::mt19937 rng( 1234 );
+	std::vector<std::unique_ptr<Image>> images;
+	for ( size_t i = 0; i < 500; ++i ) {
+		images.emplace_back( std::make_unique<Image>( 8 + rng() % 120, 8 + rng() % 120, 4,
+													  Color::Transparent, false ) );
+	}
+
+	runner.run( group, "packTextures", [&] {
+		TexturePacker packer( 4096, 4096, 1, false, false, 2, Texture::Filter::Linear, true );
+		for ( size_t i = 0; i < images.size(); ++i )
+			packer.addImage( images[i].get(), String::toString( i ) );
+		doNotOptimize( packer.packTextures() );
+	} );
+}
+
+static void benchmarkText( BenchmarkRunner& runner, FontTrueType* font ) {
+	const std::string group( "Text" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	String paragraph( String::fromUtf8( makeSourceText( 200 ) ) );
+	Text text;
+	text.setFont( font );
+	text.setFontSize( 14 );
+
+	runner.run( group, "layout", [&] {
+		text.setString( paragraph );
+		doNotOptimize( text.getLocalBounds().getWidth() );
+	} );
+
+	std::vector<String> lines( paragraph.split( '\n' ) );
+	runner.run( group, "getTextWidth", [&] {
+		Float width = 0;
+		for ( const auto& line : lines )
+			width += Text::getTextWidth( font, 14, line, Text::Regular );
+		doNotOptimize( width );
+	} );
+}
+
+static void benchmarkStyleSheet( BenchmarkRunner& runner, UISceneNode* sceneNode ) {
+	const std::string group( "StyleSheet" );
+	if ( !runner.isEnabled( group ) )
+		return;
+
+	std::string layout( "<vbox id='root' lw='mp' lh='mp'>" );
+	for ( size_t i = 0; i < 100; ++i ) {
+		layout += String::format( "<hbox class='row row%zu'>"
+								  "<TextView text='label' class='label' />"
+								  "<PushButton text='button' id='button%zu' />"
+								  "<TextInput class='input' />"
+								  "<CheckBox text='check' />"
+								  "</hbox>",
+								  i % 4, i );
+	}
+	layout += "</vbox>";
+	sceneNode->loadLayoutFromString( layout );
+
+	std::vector<UIWidget*> widgets;
+	std::function<void( Node* )> collect = [&]( Node* node ) {
+		if ( node->isWidget() )
+			widgets.push_back( node->asType<UIWidget>() );
+		Node* child = node->getFirstChild();
+		while ( child ) {
+			collect( child );
+			child = child->getNextNode();
+		}
+	};
+	collect( sceneNode );
+
+	const CSS::StyleSheet& styleSheet = sceneNode->getStyleSheet();
+	runner.run( group, "getElementStyles", [&] {
+		Uint64 count = 0;
+		for ( auto* widget : widgets ) {
+			auto definition = styleSheet.getElementStyles( widget );
+			count += definition ? definition->getStyles().size() : 0;
+		}
+		doNotOptimize( count );
+	} );
+
+	runner.run( group, "reloadStyle", [&] { sceneNode->reloadStyle( true ); } );
+}
+
+EE_MAIN_FUNC int main( int argc, char* argv[] ) {
+	args::ArgumentParser parser( "eepp microbenchmarks" );
+	args::HelpFlag help( parser, "help", "Display this help menu", { 'h', "help" } );
+	args::ValueFlag<std::string> output( parser, "output", "Save the results as JSON to this path.",
+										 { 'o', "output" } );
+	args::ValueFlag<std::string> filter(
+		parser, "filter", "Only run the benchmarks whose \"group/name\" contains the filter.",
+		{ 'f', "filter" } );
+	args::ValueFlag<Uint32> minTime( parser, "min-time",
+									 "Minimum time in milliseconds spent on each benchmark.",
+									 { 't', "min-time" }, 500 );
+	args::ValueFlag<Uint32> minIterations(
+		parser, "min-iterations", "Minimum iterations of each benchmark.", { 'i', "min-iterations" },
+		5 );
+	args::Flag noWindow( parser, "no-window",
+						 "Skip the benchmarks that need a GL context ( Text, StyleSheet ).",
+						 { "no-window" } );
+
+	try {
+		parser.ParseCLI( argc, argv );
+	} catch ( const args::Help& ) {
+		std::cout << parser;
+		return EXIT_SUCCESS;
+	} catch ( const args::ParseError& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << parser;
+		return EXIT_FAILURE;
+	} catch ( args::ValidationError& e ) {
+		std::cerr << e.what() << std::endl;
+		std::cerr << parser;
+		return EXIT_FAILURE;
+	}
+
+	Log::instance()->setLogLevelThreshold( LogLevel::Warning );
+	FileSystem::changeWorkingDirectory( Sys::getProcessPath() );
+
+	BenchmarkRunner runner( filter.Get(), Milliseconds( minTime.Get() ), minIterations.Get() );
+
+	benchmarkString( runner );
+	benchmarkLuaPattern( runner );
+	size_t prefilterMismatches = verifySyntaxPatternsPrefilter( runner );
+	benchmarkSyntaxTokenizer( runner );
+	benchmarkTextDocument( runner );
+	benchmarkCompression( runner );
+	{
+		Pak pak;
+		benchmarkPack( runner, "Pak", &pak, Sys::getTempPath() + "eepp-benchmark.pak" );
+	}
+	{
+		Zip zip;
+		benchmarkPack( runner, "Zip", &zip, Sys::getTempPath() + "eepp-benchmark.zip" );
+	}
+	benchmarkTexturePacker( runner );
+
+	bool needsWindow = runner.isEnabled( "Text" ) || runner.isEnabled( "StyleSheet" );
+	EE::Window::Window* win = nullptr;
+
+	if ( needsWindow && !noWindow.Get() ) {
+		win = Engine::instance()->createWindow(
+			WindowSettings( 1280, 720, "eepp - Benchmark", WindowStyle::Default,
+							WindowBackend::Headless ),
+			ContextSettings( false ) );
+	}
+
+	if ( win && win->isOpen() ) {
+		FontTrueType* font =
+			FontTrueType::New( "NotoSans-Regular", "assets/fonts/NotoSans-Regular.ttf" );
+
+		if ( font->loaded() ) {
+			benchmarkText( runner, font );
+
+			UISceneNode* sceneNode = UISceneNode::New();
+			SceneManager::instance()->add( sceneNode );
+			UITheme* theme = UITheme::load( "breeze", "breeze", "", font, "assets/ui/breeze.css" );
+			sceneNode->setStyleSheet( theme->getStyleSheet() );
+			sceneNode->getUIThemeManager()
+				->setDefaultTheme( theme )
+				->setDefaultFont( font )
+				->add( theme );
+			benchmarkStyleSheet( runner, sceneNode );
+		} else {
+			runner.skip( "Text", "font assets not found" );
+			runner.skip( "StyleSheet", "font assets not found" );
+		}
+	} else if ( needsWindow ) {
+		runner.skip( "Text", "no GL context" );
+		runner.skip( "StyleSheet", "no GL context" );
+	}
+
+	int res = prefilterMismatches ? EXIT_FAILURE : EXIT_SUCCESS;
+
+	if ( !output.Get().empty() ) {
+		if ( !FileSystem::fileWrite( output.Get(), runner.toJson().dump( 2 ) ) ) {
+			std::cerr << "Couldn't write the results to: " << output.Get() << std::endl;
+			res = EXIT_FAILURE;
+		}
+	}
+
+	Engine::destroySingleton();
+	MemoryManager::showResults();
+
+	return res;
+}
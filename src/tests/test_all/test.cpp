@@ -607,6 +607,7 @@ void EETest::createUI() {
 
 	mSceneNode->enableDrawInvalidation();
 	mSceneNode->enableFrameBuffer();
+	mSceneNode->enableDrawDamageRegions();
 	mSceneNode->setVerbose( true );
 
 	if ( mDebugUI ) {
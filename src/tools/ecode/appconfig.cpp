@@ -79,6 +79,7 @@ void AppConfig::load( const std::string& confPath, std::string& keybindingsPath,
 	editor.showWhiteSpaces = ini.getValueB( "editor", "show_white_spaces", true );
 	editor.showLineEndings = ini.getValueB( "editor", "show_line_endings", false );
 	editor.showIndentationGuides = ini.getValueB( "editor", "show_indentation_guides", false );
+	editor.wordWrap = ini.getValueB( "editor", "word_wrap", false );
 	editor.highlightMatchingBracket =
 		ini.getValueB( "editor", "highlight_matching_brackets", true );
 	editor.highlightCurrentLine = ini.getValueB( "editor", "highlight_current_line", true );
@@ -97,6 +98,7 @@ void AppConfig::load( const std::string& confPath, std::string& keybindingsPath,
 	ui.colorScheme = ini.getValue( "ui", "ui_color_scheme", "dark" ) == "light"
 						 ? ColorSchemePreference::Light
 						 : ColorSchemePreference::Dark;
+	ui.partialRedraw = ini.getValueB( "ui", "partial_redraw", true );
 	doc.trimTrailingWhitespaces = ini.getValueB( "document", "trim_trailing_whitespaces", false );
 	doc.forceNewLineAtEndOfFile =
 		ini.getValueB( "document", "force_new_line_at_end_of_file", false );
@@ -153,6 +155,7 @@ void AppConfig::load( const std::string& confPath, std::string& keybindingsPath,
 	workspace.restoreLastSession = ini.getValueB( "workspace", "restore_last_session", false );
 	workspace.checkForUpdatesAtStartup =
 		ini.getValueB( "workspace", "check_for_updates_at_startup", false );
+	workspace.projectSearchIndex = ini.getValueB( "workspace", "project_search_index", false );
 
 	std::map<std::string, bool> pluginsEnabled;
 	const auto& creators = pluginManager->getDefinitions();
@@ -204,6 +207,7 @@ void AppConfig::save( const std::vector<std::string>& recentFiles,
 	ini.setValueB( "editor", "show_white_spaces", editor.showWhiteSpaces );
 	ini.setValueB( "editor", "show_indentation_guides", editor.showIndentationGuides );
 	ini.setValueB( "editor", "show_line_endings", editor.showLineEndings );
+	ini.setValueB( "editor", "word_wrap", editor.wordWrap );
 	ini.setValueB( "editor", "highlight_matching_brackets", editor.highlightMatchingBracket );
 	ini.setValueB( "editor", "highlight_current_line", editor.highlightCurrentLine );
 	ini.setValueB( "editor", "vertical_scrollbar", editor.verticalScrollbar );
@@ -220,6 +224,7 @@ void AppConfig::save( const std::vector<std::string>& recentFiles,
 	ini.setValue( "ui", "fallback_font", ui.fallbackFont );
 	ini.setValue( "ui", "ui_color_scheme",
 				  ui.colorScheme == ColorSchemePreference::Light ? "light" : "dark" );
+	ini.setValueB( "ui", "partial_redraw", ui.partialRedraw );
 	ini.setValueB( "document", "trim_trailing_whitespaces", doc.trimTrailingWhitespaces );
 	ini.setValueB( "document", "force_new_line_at_end_of_file", doc.forceNewLineAtEndOfFile );
 	ini.setValueB( "document", "auto_detect_indent_type", doc.autoDetectIndentType );
@@ -268,6 +273,7 @@ void AppConfig::save( const std::vector<std::string>& recentFiles,
 	ini.setValueB( "workspace", "restore_last_session", workspace.restoreLastSession );
 	ini.setValueB( "workspace", "check_for_updates_at_startup",
 				   workspace.checkForUpdatesAtStartup );
+	ini.setValueB( "workspace", "project_search_index", workspace.projectSearchIndex );
 
 	const auto& pluginsEnabled = pluginManager->getPluginsEnabled();
 	for ( const auto& plugin : pluginsEnabled )
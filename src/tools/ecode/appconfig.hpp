@@ -36,6 +36,8 @@ struct UIConfig {
 	std::string fallbackFont;
 	ColorSchemePreference colorScheme{ ColorSchemePreference::Dark };
 	std::string theme;
+	/** Keeps the last frame and only redraws the areas that changed. */
+	bool partialRedraw{ true };
 };
 
 struct WindowStateConfig {
@@ -56,6 +58,7 @@ struct CodeEditorConfig {
 	bool showWhiteSpaces{ true };
 	bool showLineEndings{ false };
 	bool showIndentationGuides{ false };
+	bool wordWrap{ false };
 	bool highlightMatchingBracket{ true };
 	bool verticalScrollbar{ true };
 	bool horizontalScrollbar{ true };
@@ -143,6 +146,7 @@ struct TerminalConfig {
 struct WorkspaceConfig {
 	bool restoreLastSession{ false };
 	bool checkForUpdatesAtStartup{ false };
+	bool projectSearchIndex{ false };
 };
 
 class AppConfig {
@@ -510,6 +510,10 @@ ProjectDirectoryTree* App::getDirTree() const {
 	return mDirTree ? mDirTree.get() : nullptr;
 }
 
+ProjectSearchIndex* App::getProjectSearchIndex() const {
+	return mProjectSearchIndex ? mProjectSearchIndex.get() : nullptr;
+}
+
 std::shared_ptr<ThreadPool> App::getThreadPool() const {
 	return mThreadPool;
 }
@@ -632,6 +636,8 @@ App::App( const size_t& jobs, const std::vector<std::string>& args ) :
 		ThreadPool::createShared( jobs > 0 ? jobs : eemax<int>( 2, Sys::getCPUCount() ) ) ) {}
 
 App::~App() {
+	closeProjectSearchIndex();
+	mThreadPool->wait( mProjectSearchIndexSaves );
 	mThreadPool.reset();
 	if ( mFileWatcher ) {
 		Lock l( mWatchesLock );
@@ -1769,6 +1775,7 @@ void App::closeEditors() {
 	}
 
 	mCurrentProject = "";
+	closeProjectSearchIndex();
 	mDirTree = nullptr;
 	if ( mFileSystemListener )
 		mFileSystemListener->setDirTree( mDirTree );
@@ -1976,6 +1983,7 @@ void App::onCodeEditorCreated( UICodeEditor* editor, TextDocument& doc ) {
 	editor->setShowWhitespaces( config.showWhiteSpaces );
 	editor->setShowLineEndings( config.showLineEndings );
 	editor->setShowIndentationGuides( config.showIndentationGuides );
+	editor->setWordWrap( config.wordWrap );
 	editor->setHighlightMatchingBracket( config.highlightMatchingBracket );
 	editor->setVerticalScrollBarEnabled( config.verticalScrollbar );
 	editor->setHorizontalScrollBarEnabled( config.horizontalScrollbar );
@@ -2215,6 +2223,56 @@ void App::removeFolderWatches() {
 	}
 }
 
+void App::loadProjectSearchIndex( ProjectDirectoryTree& dirTree ) {
+	closeProjectSearchIndex();
+	if ( !mConfig.workspace.projectSearchIndex || !mFileSystemListener )
+		return;
+
+	std::string projectsPath( mConfigPath + "projects" + FileSystem::getOSSlash() );
+	if ( !FileSystem::fileExists( projectsPath ) )
+		FileSystem::makeDir( projectsPath );
+	MD5::Result hash = MD5::fromString( dirTree.getPath() );
+	auto index = ProjectSearchIndex::New( projectsPath + hash.toHexString() + ".idx", mThreadPool );
+	std::weak_ptr<ProjectDirectoryTree> weakDirTree( mDirTree );
+	mProjectSearchIndex = index;
+	mProjectSearchIndexListenerId = mFileSystemListener->addListener(
+		[index, weakDirTree]( const FileEvent& event, const FileInfo& file ) {
+			switch ( event.type ) {
+				case FileSystemEventType::Moved: {
+					index->fileRemoved( FileSystem::isRelativePath( event.oldFilename )
+											? event.directory + event.oldFilename
+											: event.oldFilename );
+					[[fallthrough]];
+				}
+				case FileSystemEventType::Add:
+				case FileSystemEventType::Modified: {
+					auto dirTree = weakDirTree.lock();
+					if ( file.isRegularFile() && dirTree &&
+						 dirTree->isFileInTree( file.getFilepath() ) )
+						index->fileChanged( file.getFilepath() );
+					break;
+				}
+				case FileSystemEventType::Delete:
+					index->fileRemoved( file.getFilepath() );
+					break;
+			}
+		} );
+	index->build( dirTree.getFiles() );
+}
+
+void App::closeProjectSearchIndex() {
+	if ( !mProjectSearchIndex )
+		return;
+	if ( mFileSystemListener )
+		mFileSystemListener->removeListener( mProjectSearchIndexListenerId );
+	mProjectSearchIndex->cancel();
+	// Compacting and writing a big index takes a while, it's saved in background and only waited
+	// for when the application is closed
+	std::shared_ptr<ProjectSearchIndex> index( std::move( mProjectSearchIndex ) );
+	mThreadPool->run( [index] { index->save(); }, mProjectSearchIndexSaves,
+					  ThreadPool::Priority::Background );
+}
+
 void App::loadDirTree( const std::string& path ) {
 	Clock* clock = eeNew( Clock, () );
 	mDirTreeReady = false;
@@ -2227,6 +2285,8 @@ void App::loadDirTree( const std::string& path ) {
 			eeDelete( clock );
 			mDirTreeReady = true;
 			mUISceneNode->runOnMainThread( [&] {
+				if ( mDirTree )
+					loadProjectSearchIndex( *mDirTree );
 				mUniversalLocator->updateFilesTable();
 				if ( mSplitter->curEditorExistsAndFocused() )
 					syncProjectTreeWithEditor( mSplitter->getCurEditor() );
@@ -2947,6 +3007,13 @@ void App::init( const LogLevel& logLevel, std::string file, const Float& pidelDe
 
 		mUISceneNode = UISceneNode::New();
 		mUISceneNode->setThreadPool( mThreadPool );
+		if ( mConfig.ui.partialRedraw ) {
+			// The scene keeps its last frame and only redraws the damaged regions, a blinking
+			// cursor only redraws its row.
+			mUISceneNode->enableDrawInvalidation();
+			mUISceneNode->enableFrameBuffer();
+			mUISceneNode->enableDrawDamageRegions();
+		}
 		mUIColorScheme = mConfig.ui.colorScheme;
 		if ( !colorScheme.empty() ) {
 			mUIColorScheme =
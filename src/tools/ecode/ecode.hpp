@@ -9,6 +9,7 @@
 #include "notificationcenter.hpp"
 #include "plugins/pluginmanager.hpp"
 #include "projectdirectorytree.hpp"
+#include "projectsearchindex.hpp"
 #include "terminalmanager.hpp"
 #include "universallocator.hpp"
 #include <eepp/ee.hpp>
@@ -72,6 +73,9 @@ class App : public UICodeEditorSplitter::Client {
 
 	ProjectDirectoryTree* getDirTree() const;
 
+	/** @return The trigram index of the current project, nullptr if it's disabled. */
+	ProjectSearchIndex* getProjectSearchIndex() const;
+
 	std::shared_ptr<ThreadPool> getThreadPool() const;
 
 	void loadFileFromPath( const std::string& path, bool inNewTab = true,
@@ -384,6 +388,10 @@ class App : public UICodeEditorSplitter::Client {
 	Float mDisplayDPI{ 96 };
 	std::shared_ptr<ThreadPool> mThreadPool;
 	std::shared_ptr<ProjectDirectoryTree> mDirTree;
+	std::shared_ptr<ProjectSearchIndex> mProjectSearchIndex;
+	Uint64 mProjectSearchIndexListenerId{ 0 };
+	/** Indexes of the closed projects that are being saved. */
+	ThreadPool::WaitGroup mProjectSearchIndexSaves;
 	UITreeView* mProjectTreeView{ nullptr };
 	UILinearLayout* mProjectViewEmptyCont{ nullptr };
 	std::shared_ptr<FileSystemModel> mFileSystemModel;
@@ -429,6 +437,10 @@ class App : public UICodeEditorSplitter::Client {
 
 	void loadDirTree( const std::string& path );
 
+	void loadProjectSearchIndex( ProjectDirectoryTree& dirTree );
+
+	void closeProjectSearchIndex();
+
 	void showSidePanel( bool show );
 
 	void onFileDropped( String file );
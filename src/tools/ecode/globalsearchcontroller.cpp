@@ -479,29 +479,55 @@ void GlobalSearchController::doGlobalSearch( String text, bool caseSensitive, bo
 		if ( escapeSequence )
 			text.unescape();
 		std::string search( text.toUtf8() );
+		Uint64 searchId = ++mGlobalSearchId;
+		// Results are appended to the model while the search is running, so the first matches
+		// are visible as soon as they are found.
+		auto model = ProjectSearch::asModel( {} );
+		// The trigram index can only narrow plain text searches.
+		std::vector<std::string> files;
+		ProjectSearchIndex* index = mApp->getProjectSearchIndex();
+		if ( luaPattern || !index ||
+			 !index->filter( mApp->getDirTree()->getFiles(), search, files ) )
+			files = mApp->getDirTree()->getFiles();
 		ProjectSearch::find(
-			mApp->getDirTree()->getFiles(), search,
+			files, search,
 #if EE_PLATFORM != EE_PLATFORM_EMSCRIPTEN || defined( __EMSCRIPTEN_PTHREADS__ )
 			mApp->getThreadPool(),
 #endif
-			[&, clock, search, loader, searchReplace,
-			 searchAgain]( const ProjectSearch::Result& res ) {
+			[&, clock, search, loader, searchReplace, searchAgain, searchId,
+			 model]( const ProjectSearch::Result& ) {
 				Log::info( "Global search for \"%s\" took %.2fms", search.c_str(),
 						   clock->getElapsedTime().asMilliseconds() );
 				eeDelete( clock );
-				mUISceneNode->runOnMainThread( [&, loader, res, search, searchReplace, searchAgain,
-												escapeSequence] {
-					auto model = ProjectSearch::asModel( res );
+				mUISceneNode->runOnMainThread( [&, loader, model, search, searchReplace,
+												searchAgain, escapeSequence, searchId] {
 					updateGlobalSearchHistory( model, search, searchReplace, searchAgain,
 											   escapeSequence );
-					updateGlobalSearchBarResults( search, model, searchReplace, escapeSequence );
+					if ( searchId == mGlobalSearchId )
+						updateGlobalSearchBarResults( search, model, searchReplace,
+													  escapeSequence );
 					loader->setVisible( false );
 					loader->close();
 				} );
 			},
 			caseSensitive, wholeWord,
 			luaPattern ? TextDocument::FindReplaceType::LuaPattern
-					   : TextDocument::FindReplaceType::Normal );
+					   : TextDocument::FindReplaceType::Normal,
+			[&, search, searchId, model]( const ProjectSearch::Result& res ) {
+				mUISceneNode->runOnMainThread( [&, res, search, searchId, model] {
+					model->appendResult( res );
+					if ( searchId != mGlobalSearchId )
+						return;
+					if ( mGlobalSearchTree->getModel() != model.get() ) {
+						mGlobalSearchTree->setSearchStr( search );
+						mGlobalSearchTree->setModel( model );
+					}
+					if ( model->getResult().size() < 50 )
+						mGlobalSearchTree->expandAll();
+					mGlobalSearchLayout->findByClass<UITextView>( "search_total" )
+						->setText( String::format( "%zu matches found.", model->resultCount() ) );
+				} );
+			} );
 	}
 }
 
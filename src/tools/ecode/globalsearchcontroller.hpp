@@ -76,6 +76,7 @@ class GlobalSearchController {
 	UITextInput* mGlobalSearchInput{ nullptr };
 	UIDropDownList* mGlobalSearchHistoryList{ nullptr };
 	Uint32 mGlobalSearchHistoryOnItemSelectedCb{ 0 };
+	Uint64 mGlobalSearchId{ 0 };
 	std::deque<std::pair<std::string, std::shared_ptr<ProjectSearch::ResultModel>>>
 		mGlobalSearchHistory;
 
@@ -142,6 +142,21 @@ bool gitignore_glob_match( const std::string& text, const std::string& glob,
 	return j >= m;
 }
 
+static bool gitignore_is_literal( const std::string& glob, size_t start = 0,
+								 size_t end = std::string::npos ) {
+	end = eemin( end, glob.size() );
+	for ( size_t i = start; i < end; i++ ) {
+		switch ( glob[i] ) {
+			case '*':
+			case '?':
+			case '[':
+			case '\\':
+				return false;
+		}
+	}
+	return true;
+}
+
 IgnoreMatcher::IgnoreMatcher( const std::string& rootPath ) : mPath( rootPath ) {
 	FileSystem::dirAddSlashAtEnd( mPath );
 }
@@ -189,34 +204,123 @@ bool GitIgnoreMatcher::parse() {
 	}
 	if ( FileSystem::fileExists( mPath + ".git" ) )
 		mPatterns.emplace_back( std::make_pair( "/.git", false ) ); // Also ignore the .git folder
+	compile();
 	return !mPatterns.empty();
 }
 
-bool GitIgnoreMatcher::match( const std::string& value ) const {
-	if ( mPatterns.empty() )
-		return false;
-	bool match = false;
+void GitIgnoreMatcher::compile() {
 	for ( size_t i = 0; i < mPatterns.size(); i++ ) {
-		auto& pattern = mPatterns[i];
-		match = gitignore_glob_match( value, pattern.first );
-		if ( pattern.second )
-			match = !match;
-		if ( match && !pattern.second ) {
-			if ( i + 1 < mPatterns.size() && mPatterns[i + 1].second ) {
-				for ( size_t n = i + 1; n < mPatterns.size(); n++ ) {
-					// Check if there's a positive negate after the match
-					if ( mPatterns[n].second ) {
-						if ( gitignore_glob_match( value, mPatterns[n].first ) )
-							return false;
-					} else {
-						break;
-					}
-				}
+		const auto& pattern = mPatterns[i];
+		const std::string& glob = pattern.first;
+		if ( pattern.second || glob.empty() )
+			continue;
+
+		if ( glob.find( '/' ) == std::string::npos ) {
+			// Patterns without a slash are matched against the basename
+			if ( gitignore_is_literal( glob ) ) {
+				mLiteralNames.emplace( glob, i );
+			} else if ( glob.size() > 1 && glob[0] == '*' && gitignore_is_literal( glob, 1 ) ) {
+				if ( mSuffixes.emplace( glob.substr( 1 ), i ).second &&
+					 std::find( mSuffixLengths.begin(), mSuffixLengths.end(), glob.size() - 1 ) ==
+						 mSuffixLengths.end() )
+					mSuffixLengths.push_back( glob.size() - 1 );
+			} else {
+				mGenericPatterns.push_back( i );
 			}
-			return true;
+			continue;
+		}
+
+		bool anchored = glob.size() > 1 && glob[0] == '/';
+		size_t start = anchored ? 1 : 0;
+		size_t end = glob.find( '/', start );
+		if ( end == std::string::npos )
+			end = glob.size();
+		std::string dir( glob.substr( start, end - start ) );
+		if ( !dir.empty() && dir != "." && gitignore_is_literal( dir ) ) {
+			if ( anchored ) {
+				mAnchoredPrefixes[dir].push_back( i );
+			} else {
+				mPrefixes[dir].push_back( i );
+			}
+		} else {
+			mGenericPatterns.push_back( i );
 		}
 	}
-	return false;
+}
+
+size_t GitIgnoreMatcher::findFirstMatch( const std::string& value ) const {
+	size_t best = std::string::npos;
+	size_t sep = value.rfind( PATHSEP );
+	std::string basename( sep != std::string::npos ? value.substr( sep + 1 ) : value );
+
+	if ( !mLiteralNames.empty() ) {
+		auto it = mLiteralNames.find( basename );
+		if ( it != mLiteralNames.end() )
+			best = it->second;
+	}
+
+	for ( const auto& length : mSuffixLengths ) {
+		if ( basename.size() < length )
+			continue;
+		auto it = mSuffixes.find( basename.substr( basename.size() - length ) );
+		if ( it != mSuffixes.end() && it->second < best )
+			best = it->second;
+	}
+
+	const auto findInBucket = [&]( const std::unordered_map<std::string, std::vector<size_t>>& map,
+								   size_t from ) {
+		size_t end = value.find( PATHSEP, from );
+		auto it = map.find( value.substr(
+			from, end == std::string::npos ? std::string::npos : end - from ) );
+		if ( it == map.end() )
+			return;
+		for ( const auto& index : it->second ) {
+			if ( index >= best )
+				break;
+			if ( gitignore_glob_match( value, mPatterns[index].first ) ) {
+				best = index;
+				break;
+			}
+		}
+	};
+
+	if ( !mPrefixes.empty() )
+		findInBucket( mPrefixes, 0 );
+
+	if ( !mAnchoredPrefixes.empty() ) {
+		// anchored patterns ignore the leading ./ pairs and / of the path
+		size_t from = 0;
+		while ( from + 1 < value.size() && value[from] == '.' && value[from + 1] == PATHSEP )
+			from += 2;
+		if ( from < value.size() && value[from] == PATHSEP )
+			from++;
+		findInBucket( mAnchoredPrefixes, from );
+	}
+
+	for ( const auto& index : mGenericPatterns ) {
+		if ( index >= best )
+			break;
+		if ( gitignore_glob_match( value, mPatterns[index].first ) ) {
+			best = index;
+			break;
+		}
+	}
+
+	return best;
+}
+
+bool GitIgnoreMatcher::match( const std::string& value ) const {
+	if ( mPatterns.empty() )
+		return false;
+	size_t index = findFirstMatch( value );
+	if ( index == std::string::npos )
+		return false;
+	// Check if there's a positive negate after the match
+	for ( size_t n = index + 1; n < mPatterns.size() && mPatterns[n].second; n++ ) {
+		if ( gitignore_glob_match( value, mPatterns[n].first ) )
+			return false;
+	}
+	return true;
 }
 
 std::string GitIgnoreMatcher::findRepositoryRootPath() const {
@@ -238,8 +342,8 @@ IgnoreMatcherManager::IgnoreMatcherManager( IgnoreMatcherManager&& ignoreMatcher
 IgnoreMatcherManager::IgnoreMatcherManager( std::string rootPath ) {
 	FileSystem::dirAddSlashAtEnd( rootPath );
 	mRootPath = rootPath;
-	GitIgnoreMatcher git( rootPath );
-	if ( git.canMatch() )
+	// Avoid parsing the ignore file twice, the matcher parses it when constructed
+	if ( FileSystem::fileExists( rootPath + ".gitignore" ) )
 		mMatchers.emplace_back( eeNew( GitIgnoreMatcher, ( rootPath ) ) );
 }
 
@@ -4,6 +4,7 @@
 #include <eepp/system/filesystem.hpp>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace EE;
@@ -53,8 +54,23 @@ class GitIgnoreMatcher : public IgnoreMatcher {
 	std::string mIgnoreFileName;
 	std::string mIgnoreFilePath;
 	std::vector<std::pair<std::string, bool>> mPatterns;
+	/** The positive patterns are compiled into buckets so only the patterns that can match a path
+	 * are evaluated. Literal basenames and literal "*suffix" patterns store the first pattern index
+	 * and don't need to be evaluated at all. */
+	std::unordered_map<std::string, size_t> mLiteralNames;
+	std::unordered_map<std::string, size_t> mSuffixes;
+	std::vector<size_t> mSuffixLengths;
+	/** Patterns with a path whose first directory is a literal, indexed by that directory. */
+	std::unordered_map<std::string, std::vector<size_t>> mAnchoredPrefixes;
+	std::unordered_map<std::string, std::vector<size_t>> mPrefixes;
+	/** Patterns that must be always evaluated. */
+	std::vector<size_t> mGenericPatterns;
 
 	bool parse() override;
+
+	void compile();
+
+	size_t findFirstMatch( const std::string& value ) const;
 };
 
 class IgnoreMatcherManager {
@@ -37,24 +37,42 @@ static json getURIAndPositionJSON( UICodeEditor* editor ) {
 	return data;
 }
 
+// Documents with fewer dirty lines than this are scanned immediately, otherwise the scan runs in
+// background.
+static constexpr size_t SYNC_SCAN_MAX_LINES = 512;
+
 static AutoCompletePlugin::SymbolsList
-fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& symbolsVec,
-				   const std::string& match, const size_t& max ) {
+fuzzyMatchSymbols( const AutoCompletePlugin::SymbolsList& suggestions,
+				   const AutoCompletePlugin::SymbolsSet* symbols, const std::string& match,
+				   const size_t& max ) {
 	AutoCompletePlugin::SymbolsList matches;
 	matches.reserve( max );
 	int score;
-	for ( const auto& symbols : symbolsVec ) {
+	for ( const auto& suggestion : suggestions ) {
+		if ( ( score = String::fuzzyMatch( suggestion.text, match ) ) > 0 ) {
+			if ( std::find( matches.begin(), matches.end(), suggestion ) == matches.end() ) {
+				suggestion.setScore( score );
+				matches.push_back( suggestion );
+			}
+		}
+	}
+
+	if ( symbols && matches.size() <= max ) {
+		size_t suggestionsCount = matches.size();
 		for ( const auto& symbol : *symbols ) {
-			if ( ( score = String::fuzzyMatch( symbol.text, match ) ) > 0 ) {
-				if ( std::find( matches.begin(), matches.end(), symbol ) == matches.end() ) {
-					symbol.setScore( score );
-					matches.push_back( symbol );
+			// A symbol found only once that is the text being written is the text itself
+			if ( symbol.second == 1 && symbol.first == match )
+				continue;
+			if ( ( score = String::fuzzyMatch( symbol.first, match ) ) > 0 ) {
+				if ( std::none_of( matches.begin(), matches.begin() + suggestionsCount,
+								   [&symbol]( const AutoCompletePlugin::Suggestion& suggestion ) {
+									   return suggestion.text == symbol.first;
+								   } ) ) {
+					matches.emplace_back( symbol.first );
+					matches.back().setScore( score );
 				}
 			}
 		}
-
-		if ( matches.size() > max )
-			break;
 	}
 
 	std::sort( matches.begin(), matches.end(),
@@ -66,6 +84,41 @@ fuzzyMatchSymbols( const std::vector<const AutoCompletePlugin::SymbolsList*>& sy
 	return matches;
 }
 
+static std::vector<std::string> getLineSymbols( LuaPattern& pattern, const String& line ) {
+	std::vector<std::string> symbols;
+	std::string string( line.toUtf8() );
+	for ( auto& match : pattern.gmatch( string ) ) {
+		std::string matchStr( match[0] );
+		if ( matchStr.size() < 3 )
+			continue;
+		if ( std::find( symbols.begin(), symbols.end(), matchStr ) == symbols.end() )
+			symbols.emplace_back( std::move( matchStr ) );
+	}
+	return symbols;
+}
+
+AutoCompletePlugin::DocumentClient::DocumentClient( AutoCompletePlugin* plugin,
+													TextDocument* doc ) :
+	mPlugin( plugin ), mDoc( doc ) {}
+
+void AutoCompletePlugin::DocumentClient::onDocumentTextChanged(
+	const DocumentContentChange& change ) {
+	mPlugin->onDocumentTextChanged( mDoc, change );
+}
+
+void AutoCompletePlugin::DocumentClient::onDocumentLoaded( TextDocument* ) {
+	mPlugin->invalidateDocCache( mDoc );
+}
+
+void AutoCompletePlugin::DocumentClient::onDocumentReloaded( TextDocument* ) {
+	mPlugin->invalidateDocCache( mDoc );
+}
+
+void AutoCompletePlugin::DocumentClient::onDocumentClosed( TextDocument* ) {
+	// Only received if the document is destroyed before the editors notified the close
+	mPlugin->onDocumentDestroyed( mDoc );
+}
+
 UICodeEditorPlugin* AutoCompletePlugin::New( PluginManager* pluginManager ) {
 	return eeNew( AutoCompletePlugin, ( pluginManager ) );
 }
@@ -92,6 +145,8 @@ AutoCompletePlugin::~AutoCompletePlugin() {
 			editor.first->removeEventListener( listener );
 		editor.first->unregisterPlugin( this );
 	}
+	for ( const auto& cache : mDocCache )
+		cache.first->unregisterClient( cache.second.client.get() );
 }
 
 void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
@@ -109,7 +164,7 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 			const DocEvent* docEvent = static_cast<const DocEvent*>( event );
 			TextDocument* doc = docEvent->getDoc();
 			mDocs.erase( doc );
-			mDocCache.erase( doc );
+			removeDocCache( doc );
 			mDirty = true;
 		} ) );
 
@@ -119,7 +174,8 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 			TextDocument* newDoc = editor->getDocumentRef().get();
 			Lock l( mDocMutex );
 			mDocs.erase( oldDoc );
-			mDocCache.erase( oldDoc );
+			removeDocCache( oldDoc );
+			mDocs.insert( newDoc );
 			mEditorDocs[editor] = newDoc;
 			mDirty = true;
 		} ) );
@@ -137,20 +193,11 @@ void AutoCompletePlugin::onRegister( UICodeEditor* editor ) {
 		Event::OnDocumentUndoRedo, [&]( const Event* ) { resetSignatureHelp(); } ) );
 
 	listeners.push_back(
-		editor->addEventListener( Event::OnDocumentSyntaxDefinitionChange, [&]( const Event* ev ) {
-			const DocSyntaxDefEvent* event = static_cast<const DocSyntaxDefEvent*>( ev );
-			std::string oldLang = event->getOldLang();
-			std::string newLang = event->getNewLang();
-#if AUTO_COMPLETE_THREADED
-			mThreadPool->run( [&, oldLang, newLang] {
-				updateLangCache( oldLang );
-				updateLangCache( newLang );
-			} );
-#else
-			updateLangCache( oldLang );
-			updateLangCache( newLang );
-#endif
-		} ) );
+		editor->addEventListener(
+			Event::OnDocumentSyntaxDefinitionChange, [&, editor]( const Event* ev ) {
+				const DocSyntaxDefEvent* event = static_cast<const DocSyntaxDefEvent*>( ev );
+				setDocLanguage( editor->getDocumentRef().get(), event->getNewLang() );
+			} ) );
 
 	mEditors.insert( { editor, listeners } );
 	mDocs.insert( editor->getDocumentRef().get() );
@@ -176,7 +223,7 @@ void AutoCompletePlugin::onUnregister( UICodeEditor* editor ) {
 		if ( ceditor.second == doc )
 			return;
 	mDocs.erase( doc );
-	mDocCache.erase( doc );
+	removeDocCache( doc );
 	mDirty = true;
 }
 
@@ -384,64 +431,241 @@ bool AutoCompletePlugin::onTextInput( UICodeEditor* editor, const TextInputEvent
 	return false;
 }
 
-void AutoCompletePlugin::updateDocCache( TextDocument* doc ) {
+void AutoCompletePlugin::addDocCache( TextDocument* doc ) {
+	Lock l( mDocMutex );
+	if ( mDocCache.find( doc ) != mDocCache.end() )
+		return;
+	auto& cache = mDocCache[doc];
+	cache.lang = doc->getSyntaxDefinition().getLanguageName();
+	cache.client = std::make_unique<DocumentClient>( this, doc );
+	doc->registerClient( cache.client.get() );
+	invalidateDocCache( doc );
+}
+
+void AutoCompletePlugin::removeDocCache( TextDocument* doc, bool unregisterClient ) {
+	Lock l( mDocMutex );
+	auto it = mDocCache.find( doc );
+	if ( it == mDocCache.end() )
+		return;
 	{
-		Lock lu( mDocsUpdatingMutex );
-		mDocsUpdating[doc] = true;
+		Lock l2( mLangSymbolsMutex );
+		auto& set = mLangCache[it->second.lang];
+		for ( auto& line : it->second.lines )
+			releaseLineSymbols( set, line );
 	}
-	Clock clock;
-	std::unordered_map<TextDocument*, DocCache>::iterator docCache;
+	if ( unregisterClient ) {
+		doc->unregisterClient( it->second.client.get() );
+	} else {
+		mClosedClients.emplace_back( std::move( it->second.client ) );
+	}
+	mDocCache.erase( it );
+}
+
+void AutoCompletePlugin::invalidateDocCache( TextDocument* doc ) {
+	Lock l( mDocMutex );
+	auto it = mDocCache.find( doc );
+	if ( it == mDocCache.end() )
+		return;
+	auto& cache = it->second;
 	{
-		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
-		if ( docCache == mDocCache.end() || mShuttingDown )
-			return;
+		Lock l2( mLangSymbolsMutex );
+		auto& set = mLangCache[cache.lang];
+		for ( auto& line : cache.lines )
+			releaseLineSymbols( set, line );
+	}
+	cache.lines.clear();
+	cache.lines.resize( doc->linesCount() );
+	for ( auto& line : cache.lines )
+		line.id = ++mLineId;
+	cache.dirtyCount = cache.lines.size();
+	cache.version++;
+	mDirty = true;
+}
+
+void AutoCompletePlugin::onDocumentTextChanged( TextDocument* doc,
+												const DocumentContentChange& change ) {
+	Lock l( mDocMutex );
+	auto it = mDocCache.find( doc );
+	if ( it == mDocCache.end() )
+		return;
+	auto& cache = it->second;
+	auto& lines = cache.lines;
+	TextRange range( change.range.normalized() );
+	size_t lineIdx = range.start().line();
+	if ( lineIdx >= lines.size() )
+		return;
+	cache.version++;
+
+	// A change replaces the lines of its range with the lines of its text: the lines after the
+	// first line of the range are removed ( they were merged into it ) and the new lines of the
+	// text are inserted after it
+	size_t first = eemin( lineIdx + 1, lines.size() );
+	size_t last = eemin<size_t>( first + range.end().line() - range.start().line(), lines.size() );
+	if ( first < last ) {
+		Lock l2( mLangSymbolsMutex );
+		auto& set = mLangCache[cache.lang];
+		for ( size_t i = first; i < last; i++ ) {
+			if ( lines[i].dirty )
+				cache.dirtyCount--;
+			releaseLineSymbols( set, lines[i] );
+		}
+		lines.erase( lines.begin() + first, lines.begin() + last );
 	}
 
-	auto changeId = doc->getCurrentChangeId();
-	auto symbols = getDocumentSymbols( doc );
+	size_t count = std::count( change.text.begin(), change.text.end(), '\n' );
+	if ( count ) {
+		std::vector<LineSymbols> newLines( count );
+		for ( auto& line : newLines )
+			line.id = ++mLineId;
+		lines.insert( lines.begin() + lineIdx + 1, std::make_move_iterator( newLines.begin() ),
+					  std::make_move_iterator( newLines.end() ) );
+		cache.dirtyCount += count;
+	}
 
-	{
-		Lock l( mDocMutex );
-		docCache = mDocCache.find( doc );
-		if ( docCache == mDocCache.end() || mShuttingDown )
-			return;
-		auto& cache = docCache->second;
-		cache.changeId = changeId;
-		cache.symbols = std::move( symbols );
+	auto& line = lines[lineIdx];
+	if ( !line.dirty ) {
+		line.dirty = true;
+		cache.dirtyCount++;
 	}
+	line.id = ++mLineId;
+}
 
-	std::string langName( doc->getSyntaxDefinition().getLanguageName() );
-	{
-		Lock l( mLangSymbolsMutex );
-		auto& lang = mLangCache[langName];
-		lang.clear();
-		Lock l2( mDocMutex );
-		for ( const auto& d : mDocCache ) {
-			if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-				lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
+void AutoCompletePlugin::onDocumentDestroyed( TextDocument* doc ) {
+	Lock l( mDocMutex );
+	mDocs.erase( doc );
+	removeDocCache( doc, false );
+}
+
+void AutoCompletePlugin::setDocLanguage( TextDocument* doc, const std::string& lang ) {
+	Lock l( mDocMutex );
+	auto it = mDocCache.find( doc );
+	if ( it == mDocCache.end() || it->second.lang == lang )
+		return;
+	auto& cache = it->second;
+	Lock l2( mLangSymbolsMutex );
+	auto& oldSet = mLangCache[cache.lang];
+	auto& newSet = mLangCache[lang];
+	for ( auto& line : cache.lines ) {
+		for ( auto& symbol : line.symbols ) {
+			auto inserted = newSet.emplace( *symbol, 0 );
+			inserted.first->second++;
+			auto old = oldSet.find( *symbol );
+			if ( --old->second == 0 )
+				oldSet.erase( old );
+			symbol = &inserted.first->first;
 		}
 	}
-	Log::debug( "Dictionary for %s updated in: %.2fms", doc->getFilename().c_str(),
-				clock.getElapsedTime().asMilliseconds() );
-	{
-		Lock lu( mDocsUpdatingMutex );
-		mDocsUpdating[doc] = false;
+	cache.lang = lang;
+}
+
+void AutoCompletePlugin::commitLineSymbols( DocCache& cache, LineSymbols& line,
+											std::vector<std::string>&& symbols ) {
+	auto& set = mLangCache[cache.lang];
+	releaseLineSymbols( set, line );
+	line.symbols.reserve( symbols.size() );
+	for ( auto& symbol : symbols ) {
+		auto inserted = set.emplace( std::move( symbol ), 0 );
+		inserted.first->second++;
+		line.symbols.push_back( &inserted.first->first );
+	}
+	if ( line.dirty ) {
+		line.dirty = false;
+		cache.dirtyCount--;
 	}
 }
 
-void AutoCompletePlugin::updateLangCache( const std::string& langName ) {
+void AutoCompletePlugin::releaseLineSymbols( SymbolsSet& set, LineSymbols& line ) {
+	for ( const auto& symbol : line.symbols ) {
+		auto it = set.find( *symbol );
+		if ( it != set.end() && --it->second == 0 )
+			set.erase( it );
+	}
+	line.symbols.clear();
+}
+
+void AutoCompletePlugin::updateDocCache( TextDocument* doc ) {
 	Clock clock;
-	Lock l( mLangSymbolsMutex );
-	Lock l2( mDocMutex );
-	auto& lang = mLangCache[langName];
-	lang.clear();
-	for ( const auto& d : mDocCache ) {
-		if ( d.first->getSyntaxDefinition().getLanguageName() == langName )
-			lang.insert( lang.end(), d.second.symbols.begin(), d.second.symbols.end() );
+	LuaPattern pattern( mSymbolPattern );
+	std::vector<std::pair<Uint64, String>> dirtyLines;
+	Uint64 version;
+	{
+		Lock l( mDocMutex );
+		auto it = mDocCache.find( doc );
+		if ( it == mDocCache.end() || mShuttingDown )
+			return;
+		auto& cache = it->second;
+		if ( cache.updating || cache.dirtyCount == 0 )
+			return;
+
+		// The cache gets out of sync if the document was modified without notifying the changes
+		if ( cache.lines.size() != doc->linesCount() )
+			invalidateDocCache( doc );
+
+		if ( cache.dirtyCount <= SYNC_SCAN_MAX_LINES ) {
+			Lock l2( mLangSymbolsMutex );
+			for ( size_t i = 0; i < cache.lines.size() && cache.dirtyCount; i++ ) {
+				if ( cache.lines[i].dirty )
+					commitLineSymbols( cache, cache.lines[i],
+									   getLineSymbols( pattern, doc->line( i ).getText() ) );
+			}
+			return;
+		}
+
+		dirtyLines.reserve( cache.dirtyCount );
+		for ( size_t i = 0; i < cache.lines.size(); i++ ) {
+			if ( cache.lines[i].dirty )
+				dirtyLines.emplace_back( cache.lines[i].id, doc->line( i ).getText() );
+		}
+		version = cache.version;
+		cache.updating = true;
 	}
-	Log::debug( "Lang dictionary for %s updated in: %.2fms", langName.c_str(),
-				clock.getElapsedTime().asMilliseconds() );
+
+	auto scan = [this, doc, version, dirtyLines = std::move( dirtyLines ), clock]() mutable {
+		LuaPattern pattern( mSymbolPattern );
+		std::vector<std::vector<std::string>> symbols;
+		symbols.reserve( dirtyLines.size() );
+		for ( const auto& line : dirtyLines ) {
+			if ( mShuttingDown )
+				return;
+			symbols.emplace_back( getLineSymbols( pattern, line.second ) );
+		}
+
+		Lock l( mDocMutex );
+		auto it = mDocCache.find( doc );
+		if ( it == mDocCache.end() || mShuttingDown )
+			return;
+		auto& cache = it->second;
+		cache.updating = false;
+		// Lines are matched by their id, the lines modified after the scan started are
+		// discarded since they got a new id
+		std::unordered_map<Uint64, size_t> lineIndex;
+		if ( cache.version != version ) {
+			for ( size_t i = 0; i < cache.lines.size(); i++ )
+				lineIndex[cache.lines[i].id] = i;
+		}
+		Lock l2( mLangSymbolsMutex );
+		size_t pos = 0;
+		for ( size_t i = 0; i < dirtyLines.size(); i++ ) {
+			Uint64 id = dirtyLines[i].first;
+			if ( cache.version == version ) {
+				while ( pos < cache.lines.size() && cache.lines[pos].id != id )
+					pos++;
+			} else {
+				auto found = lineIndex.find( id );
+				pos = found != lineIndex.end() ? found->second : cache.lines.size();
+			}
+			if ( pos < cache.lines.size() )
+				commitLineSymbols( cache, cache.lines[pos], std::move( symbols[i] ) );
+		}
+		Log::debug( "Dictionary for %s updated in: %.2fms", doc->getFilename().c_str(),
+					clock.getElapsedTime().asMilliseconds() );
+	};
+
+#if AUTO_COMPLETE_THREADED
+	mThreadPool->run( std::move( scan ) );
+#else
+	scan();
+#endif
 }
 
 void AutoCompletePlugin::pickSuggestion( UICodeEditor* editor ) {
@@ -493,7 +717,7 @@ AutoCompletePlugin::processCodeCompletion( const LSPCompletionList& completion )
 		{
 			Lock l2( mLangSymbolsMutex );
 			auto& symbols = mLangCache[lang];
-			fuzzySuggestions = fuzzyMatchSymbols( { &suggestions, &symbols }, symbol,
+			fuzzySuggestions = fuzzyMatchSymbols( suggestions, &symbols, symbol,
 												  eemax<size_t>( 100UL, suggestions.size() ) );
 		}
 		Lock l( mSuggestionsMutex );
@@ -580,27 +804,18 @@ void AutoCompletePlugin::update( UICodeEditor* ) {
 		mClock.restart();
 		mDirty = false;
 		Lock l( mDocMutex );
+		mClosedClients.clear();
 		for ( auto& doc : mDocs ) {
-			if ( !doc->isLoading() && mDocCache[doc].changeId != doc->getCurrentChangeId() ) {
-				{
-					Lock lu( mDocsUpdatingMutex );
-					auto du = mDocsUpdating.find( doc );
-					// Dont update the document cache if it's still updating the document
-					if ( du != mDocsUpdating.end() && du->second == true )
-						continue;
-				}
-#if AUTO_COMPLETE_THREADED
-				mThreadPool->run( [&, doc] { updateDocCache( doc ); } );
-#else
-				updateDocCache( doc );
-#endif
-			}
+			if ( doc->isLoading() )
+				continue;
+			addDocCache( doc );
+			updateDocCache( doc );
 		}
 	}
 }
 
 void AutoCompletePlugin::drawSignatureHelp( UICodeEditor* editor, const Vector2f& startScroll,
-											const Float& lineHeight, bool drawUp ) {
+											const Float& /*lineHeight*/, bool drawUp ) {
 
 	TextDocument& doc = editor->getDocument();
 	Primitives primitives;
@@ -615,8 +830,8 @@ void AutoCompletePlugin::drawSignatureHelp( UICodeEditor* editor, const Vector2f
 		return;
 	auto curSig = mSignatureHelp.signatures[curSigIdx];
 	Float vdiff = drawUp ? -mRowHeight : mRowHeight;
-	Vector2f pos( startScroll.x + editor->getXOffsetCol( mSignatureHelpPosition ),
-				  startScroll.y + mSignatureHelpPosition.line() * lineHeight + vdiff );
+	Vector2f signatureOffset( editor->getTextPositionOffset( mSignatureHelpPosition ) );
+	Vector2f pos( startScroll.x + signatureOffset.x, startScroll.y + signatureOffset.y + vdiff );
 	primitives.setColor( Color( selectedStyle.background ).blendAlpha( editor->getAlpha() ) );
 	String str;
 	if ( mSignatureHelp.signatures.size() > 1 ) {
@@ -656,9 +871,8 @@ void AutoCompletePlugin::drawSignatureHelp( UICodeEditor* editor, const Vector2f
 							  ( curParam.end - curParam.start ) * editor->getGlyphWidth(),
 						  curParamRect.getPosition().y },
 						curParamRect.getSize() } ) ) {
-			pos = { startScroll.x - curParam.start * editor->getGlyphWidth() +
-						editor->getXOffsetCol( mSignatureHelpPosition ),
-					startScroll.y + mSignatureHelpPosition.line() * lineHeight + vdiff };
+			pos = { startScroll.x - curParam.start * editor->getGlyphWidth() + signatureOffset.x,
+					startScroll.y + signatureOffset.y + vdiff };
 
 			boxRect.setPosition( pos );
 
@@ -714,8 +928,8 @@ void AutoCompletePlugin::postDraw( UICodeEditor* editor, const Vector2f& startSc
 		suggestions = mSuggestions;
 	}
 
-	Vector2f cursorPos( startScroll.x + editor->getXOffsetCol( start ),
-						startScroll.y + cursor.line() * lineHeight + lineHeight );
+	Vector2f cursorPos( startScroll + editor->getTextPositionOffset( start ) );
+	cursorPos.y += lineHeight;
 	size_t largestString = 0;
 	size_t max = eemin<size_t>( mSuggestionsMaxVisible, suggestions.size() );
 
@@ -927,35 +1141,8 @@ void AutoCompletePlugin::resetSignatureHelp() {
 	mSignatureHelpEditor = nullptr;
 }
 
-AutoCompletePlugin::SymbolsList AutoCompletePlugin::getDocumentSymbols( TextDocument* doc ) {
-	LuaPattern pattern( mSymbolPattern );
-	AutoCompletePlugin::SymbolsList symbols;
-	Int64 lc = doc->linesCount();
-	if ( lc == 0 || lc > 50000 || mShuttingDown )
-		return symbols;
-	std::string current( getPartialSymbol( doc ) );
-	TextPosition end = doc->getSelection().end();
-	for ( Int64 i = 0; i < lc; i++ ) {
-		const auto& string = doc->line( i ).getText().toUtf8();
-		for ( auto& match : pattern.gmatch( string ) ) {
-			std::string matchStr( match[0] );
-			// Ignore the symbol if is actually the current symbol being written
-			if ( matchStr.size() < 3 || ( end.line() == i && current == matchStr ) )
-				continue;
-			if ( std::none_of( symbols.begin(), symbols.end(),
-							   [matchStr]( const Suggestion& suggestion ) {
-								   return suggestion.text == matchStr;
-							   } ) )
-				symbols.push_back( std::move( matchStr ) );
-		}
-		if ( mShuttingDown )
-			break;
-	}
-	return symbols;
-}
-
 void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
-											   const SymbolsList& symbols, UICodeEditor* editor ) {
+											   const std::string& lang, UICodeEditor* editor ) {
 	{
 		{
 			Lock l( mSuggestionsEditorMutex );
@@ -966,27 +1153,29 @@ void AutoCompletePlugin::runUpdateSuggestions( const std::string& symbol,
 		if ( symbol.empty() )
 			return;
 		Lock l( mLangSymbolsMutex );
+		auto langSuggestions = mLangCache.find( lang );
+		if ( langSuggestions == mLangCache.end() )
+			return;
 		Lock l2( mSuggestionsMutex );
-		mSuggestions = fuzzyMatchSymbols( { &symbols }, symbol, mSuggestionsMaxVisible );
+		mSuggestions =
+			fuzzyMatchSymbols( {}, &langSuggestions->second, symbol, mSuggestionsMaxVisible );
 	}
 	editor->runOnMainThread( [editor] { editor->invalidateDraw(); } );
 }
 
 void AutoCompletePlugin::updateSuggestions( const std::string& symbol, UICodeEditor* editor ) {
 	const std::string& lang = editor->getDocument().getSyntaxDefinition().getLanguageName();
-	Lock l( mLangSymbolsMutex );
-	auto langSuggestions = mLangCache.find( lang );
-	if ( langSuggestions == mLangCache.end() )
-		return;
-	const auto& symbols = langSuggestions->second;
 	{
+		Lock l( mLangSymbolsMutex );
+		if ( mLangCache.find( lang ) == mLangCache.end() )
+			return;
+	}
 #if AUTO_COMPLETE_THREADED
-		mThreadPool->run(
-			[this, symbol, &symbols, editor] { runUpdateSuggestions( symbol, symbols, editor ); } );
+	mThreadPool->run(
+		[this, symbol, lang, editor] { runUpdateSuggestions( symbol, lang, editor ); } );
 #else
-		runUpdateSuggestions( symbol, symbols, editor );
+	runUpdateSuggestions( symbol, lang, editor );
 #endif
-	}
 }
 
 } // namespace ecode
@@ -9,6 +9,7 @@
 #include <eepp/system/sys.hpp>
 #include <eepp/system/threadpool.hpp>
 #include <eepp/ui/uicodeeditor.hpp>
+#include <memory>
 #include <set>
 #include <unordered_map>
 using namespace EE;
@@ -51,6 +52,8 @@ class AutoCompletePlugin : public Plugin {
 		const std::string* getCmpStr() const { return !sortText.empty() ? &sortText : &text; }
 	};
 	typedef std::vector<Suggestion> SymbolsList;
+	/** Symbols of a language and the number of times they appear in the open documents. */
+	typedef std::unordered_map<std::string, size_t> SymbolsSet;
 
 	static PluginDefinition Definition() {
 		return { "autocomplete",
@@ -106,6 +109,49 @@ class AutoCompletePlugin : public Plugin {
 	void setDirty( bool dirty );
 
   protected:
+	/** Keeps track of the lines modified in a document, so only those are scanned again. */
+	class DocumentClient : public TextDocument::Client {
+	  public:
+		DocumentClient( AutoCompletePlugin* plugin, TextDocument* doc );
+
+		void onDocumentTextChanged( const DocumentContentChange& change ) override;
+		void onDocumentUndoRedo( const TextDocument::UndoRedo& ) override {}
+		void onDocumentCursorChange( const TextPosition& ) override {}
+		void onDocumentSelectionChange( const TextRange& ) override {}
+		void onDocumentLineCountChange( const size_t&, const size_t& ) override {}
+		void onDocumentLineChanged( const Int64& ) override {}
+		void onDocumentLoaded( TextDocument* ) override;
+		void onDocumentReloaded( TextDocument* ) override;
+		void onDocumentSaved( TextDocument* ) override {}
+		void onDocumentClosed( TextDocument* ) override;
+		void onDocumentDirtyOnFileSystem( TextDocument* ) override {}
+		void onDocumentMoved( TextDocument* ) override {}
+
+		TextDocument* getDoc() const { return mDoc; }
+
+	  protected:
+		AutoCompletePlugin* mPlugin;
+		TextDocument* mDoc;
+	};
+
+	struct LineSymbols {
+		/** Unique id of the line contents, changes every time the line is modified. */
+		Uint64 id{ 0 };
+		bool dirty{ true };
+		/** Symbols of the line, pointing to the language symbols set. */
+		std::vector<const std::string*> symbols;
+	};
+
+	struct DocCache {
+		std::string lang;
+		std::vector<LineSymbols> lines;
+		size_t dirtyCount{ 0 };
+		/** Incremented with every change of the document lines. */
+		Uint64 version{ 0 };
+		bool updating{ false };
+		std::unique_ptr<DocumentClient> client;
+	};
+
 	std::string mSymbolPattern;
 	Rectf mBoxPadding;
 	Clock mClock;
@@ -119,12 +165,11 @@ class AutoCompletePlugin : public Plugin {
 	bool mDirty{ false };
 	bool mReplacing{ false };
 	bool mSignatureHelpVisible{ false };
-	struct DocCache {
-		Uint64 changeId{ static_cast<Uint64>( -1 ) };
-		SymbolsList symbols;
-	};
 	std::unordered_map<TextDocument*, DocCache> mDocCache;
-	std::unordered_map<std::string, SymbolsList> mLangCache;
+	std::unordered_map<std::string, SymbolsSet> mLangCache;
+	/** Clients of the documents destroyed, released from the main thread. */
+	std::vector<std::unique_ptr<DocumentClient>> mClosedClients;
+	Uint64 mLineId{ 0 };
 
 	std::vector<Suggestion> mSuggestions;
 	Mutex mSuggestionsEditorMutex;
@@ -141,8 +186,6 @@ class AutoCompletePlugin : public Plugin {
 	Int32 mSignatureHelpSelected{ -1 };
 	Mutex mHandlesMutex;
 	std::unordered_map<TextDocument*, std::vector<PluginIDType>> mHandles;
-	std::unordered_map<TextDocument*, std::atomic<bool>> mDocsUpdating;
-	Mutex mDocsUpdatingMutex;
 
 	Float mRowHeight{ 0 };
 	Rectf mBoxRect;
@@ -153,17 +196,30 @@ class AutoCompletePlugin : public Plugin {
 
 	void updateSuggestions( const std::string& symbol, UICodeEditor* editor );
 
-	SymbolsList getDocumentSymbols( TextDocument* );
+	void addDocCache( TextDocument* doc );
+
+	void removeDocCache( TextDocument* doc, bool unregisterClient = true );
+
+	void invalidateDocCache( TextDocument* doc );
+
+	void onDocumentTextChanged( TextDocument* doc, const DocumentContentChange& change );
+
+	void onDocumentDestroyed( TextDocument* doc );
+
+	void setDocLanguage( TextDocument* doc, const std::string& lang );
 
 	void updateDocCache( TextDocument* doc );
 
+	void commitLineSymbols( DocCache& cache, LineSymbols& line,
+							std::vector<std::string>&& symbols );
+
+	void releaseLineSymbols( SymbolsSet& set, LineSymbols& line );
+
 	std::string getPartialSymbol( TextDocument* doc );
 
-	void runUpdateSuggestions( const std::string& symbol, const SymbolsList& symbols,
+	void runUpdateSuggestions( const std::string& symbol, const std::string& lang,
 							   UICodeEditor* editor );
 
-	void updateLangCache( const std::string& langName );
-
 	void pickSuggestion( UICodeEditor* editor );
 
 	PluginRequestHandle processResponse( const PluginMessage& msg );
@@ -783,7 +783,9 @@ void LinterPlugin::drawAfterLineText( UICodeEditor* editor, const Int64& index,
 		line.setColor( color );
 
 		Int64 strSize = match.range.end().column() - match.range.start().column();
-		Vector2f pos = { position.x + editor->getXOffsetCol( match.range.start() ), position.y };
+		Vector2f offset( editor->getTextPositionOffset( match.range.start() ) );
+		Vector2f pos = { position.x + offset.x,
+						 position.y + offset.y - editor->getLineYOffset( index ) };
 		if ( strSize <= 0 ) {
 			strSize = 1;
 			pos = { position.x, position.y };
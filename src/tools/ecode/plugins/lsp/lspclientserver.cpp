@@ -2,6 +2,7 @@
 #include "lspclientplugin.hpp"
 #include "lspclientservermanager.hpp"
 #include <algorithm>
+#include <cctype>
 #include <eepp/system/filesystem.hpp>
 #include <eepp/system/iostreamstring.hpp>
 #include <eepp/system/lock.hpp>
@@ -814,6 +815,197 @@ static LSPCompletionList parseDocumentCompletion( const json& result ) {
 	return ret;
 }
 
+/** Decodes a completion reply straight from the payload, without building the json document of
+ * the whole reply ( that can be several megabytes for some servers ). Only the nested values that
+ * need the regular parsers ( text edits and documentation ) are built as json. The parse is
+ * aborted if the reply is an error, so it can be handled by the regular path. */
+class LSPCompletionReplySax : public nlohmann::json_sax<json> {
+  public:
+	LSPCompletionList list;
+
+	bool null() override { return value( json() ); }
+
+	bool boolean( bool val ) override { return value( json( val ) ); }
+
+	bool number_integer( number_integer_t val ) override { return value( json( val ) ); }
+
+	bool number_unsigned( number_unsigned_t val ) override { return value( json( val ) ); }
+
+	bool number_float( number_float_t val, const string_t& ) override {
+		return value( json( val ) );
+	}
+
+	bool string( string_t& val ) override {
+		if ( !mCapture.empty() || !isItemMember() )
+			return value( json( std::move( val ) ) );
+
+		LSPCompletionItem& item = list.items.back();
+		if ( mKey == MEMBER_LABEL ) {
+			item.label = std::move( val );
+		} else if ( mKey == MEMBER_DETAIL ) {
+			item.detail = std::move( val );
+		} else if ( mKey == "sortText" ) {
+			item.sortText = std::move( val );
+			mItemFlags |= HasSortText;
+		} else if ( mKey == "insertText" ) {
+			item.insertText = std::move( val );
+			mItemFlags |= HasInsertText;
+		} else if ( mKey == "filterText" ) {
+			item.filterText = std::move( val );
+			mItemFlags |= HasFilterText;
+		} else if ( mKey == MEMBER_DOCUMENTATION ) {
+			item.documentation.kind = LSPMarkupKind::PlainText;
+			item.documentation.value = std::move( val );
+		}
+		return true;
+	}
+
+	bool binary( binary_t& ) override { return true; }
+
+	bool start_object( std::size_t ) override { return start( json::object() ); }
+
+	bool end_object() override {
+		if ( !mCapture.empty() )
+			return end();
+
+		if ( mInItem && mDepth == mItemsDepth + 1 ) {
+			LSPCompletionItem& item = list.items.back();
+			if ( !( mItemFlags & HasSortText ) )
+				item.sortText = item.label;
+			if ( !( mItemFlags & HasInsertText ) )
+				item.insertText = item.label;
+			if ( !( mItemFlags & HasFilterText ) )
+				item.filterText = item.label;
+			mInItem = false;
+		}
+		mDepth--;
+		return true;
+	}
+
+	bool start_array( std::size_t ) override { return start( json::array() ); }
+
+	bool end_array() override {
+		if ( !mCapture.empty() )
+			return end();
+		mDepth--;
+		return true;
+	}
+
+	bool key( string_t& val ) override {
+		if ( !mCapture.empty() ) {
+			mCaptureKey = std::move( val );
+			return true;
+		}
+		// An error reply is left to the regular path
+		if ( mDepth == 1 && val == MEMBER_ERROR )
+			return false;
+		mKey = std::move( val );
+		return true;
+	}
+
+	bool parse_error( std::size_t, const std::string&, const nlohmann::detail::exception& ) override {
+		return false;
+	}
+
+  protected:
+	enum ItemFlags { HasSortText = 1 << 0, HasInsertText = 1 << 1, HasFilterText = 1 << 2 };
+
+	size_t mDepth{ 0 };
+	/** Depth of the items array, 0 until it's found. */
+	size_t mItemsDepth{ 0 };
+	/** Depth of the result when it's a completion list object. */
+	size_t mResultDepth{ 0 };
+	bool mInItem{ false };
+	int mItemFlags{ 0 };
+	std::string mKey;
+	/** The item member being built as json and the path to the value currently being built. */
+	json mCaptured;
+	std::vector<json*> mCapture;
+	std::string mCaptureKey;
+
+	bool isItemMember() const { return mInItem && mDepth == mItemsDepth + 1; }
+
+	bool isCapturedMember() const {
+		return mKey == "textEdit" || mKey == "additionalTextEdits" || mKey == MEMBER_DOCUMENTATION;
+	}
+
+	json* add( json&& val ) {
+		json* parent = mCapture.back();
+		if ( parent->is_array() ) {
+			parent->push_back( std::move( val ) );
+			return &parent->back();
+		}
+		json& ref = ( *parent )[mCaptureKey];
+		ref = std::move( val );
+		return &ref;
+	}
+
+	bool value( json&& val ) {
+		if ( !mCapture.empty() ) {
+			add( std::move( val ) );
+		} else if ( isItemMember() ) {
+			if ( mKey == MEMBER_KIND && val.is_number_integer() )
+				list.items.back().kind = static_cast<LSPCompletionItemKind>( val.get<int>() );
+		} else if ( mDepth == mResultDepth && mKey == "isIncomplete" && val.is_boolean() ) {
+			list.isIncomplete = val.get<bool>();
+		}
+		return true;
+	}
+
+	bool start( json&& container ) {
+		if ( !mCapture.empty() ) {
+			mCapture.push_back( add( std::move( container ) ) );
+			return true;
+		}
+
+		if ( isItemMember() && isCapturedMember() ) {
+			mCaptured = std::move( container );
+			mCapture.push_back( &mCaptured );
+			return true;
+		}
+
+		bool isArray = container.is_array();
+		if ( mDepth == 1 && mKey == MEMBER_RESULT ) {
+			if ( isArray ) {
+				mItemsDepth = 2;
+			} else {
+				mResultDepth = 2;
+			}
+		} else if ( isArray && mResultDepth && mDepth == mResultDepth && mKey == "items" ) {
+			mItemsDepth = mDepth + 1;
+		} else if ( !isArray && mItemsDepth && mDepth == mItemsDepth ) {
+			list.items.push_back( {} );
+			list.items.back().kind = LSPCompletionItemKind::Text;
+			mInItem = true;
+			mItemFlags = 0;
+		}
+		mDepth++;
+		return true;
+	}
+
+	bool end() {
+		mCapture.pop_back();
+		if ( !mCapture.empty() )
+			return true;
+
+		// The item member is complete
+		LSPCompletionItem& item = list.items.back();
+		try {
+			if ( mKey == "textEdit" ) {
+				item.textEdit = parseTextEdit( mCaptured );
+			} else if ( mKey == "additionalTextEdits" ) {
+				item.additionalTextEdits = parseTextEditArray( mCaptured );
+			} else {
+				item.documentation = parseMarkupContent( mCaptured );
+			}
+		} catch ( const json::exception& ) {
+			return false;
+		}
+		mCaptured = json();
+		return true;
+	}
+};
+
 static LSPSignatureInformation parseSignatureInformation( const json& json ) {
 	LSPSignatureInformation info;
 
@@ -1218,12 +1410,20 @@ bool LSPClientServer::isRunning() {
 }
 
 void LSPClientServer::removeDoc( TextDocument* doc ) {
-	Lock l( mClientsMutex );
-	if ( mClients.erase( doc ) > 0 ) {
-		auto it = std::find( mDocs.begin(), mDocs.end(), doc );
-		if ( it != mDocs.end() )
-			mDocs.erase( it );
+	{
+		Lock l( mClientsMutex );
+		if ( mClients.erase( doc ) > 0 ) {
+			auto it = std::find( mDocs.begin(), mDocs.end(), doc );
+			if ( it != mDocs.end() )
+				mDocs.erase( it );
+		}
 	}
+	Lock l( mDidChangeMutex );
+	mDidChangeQueue.erase( std::remove_if( mDidChangeQueue.begin(), mDidChangeQueue.end(),
+										   [doc]( const DidChangeQueue& queue ) {
+											   return queue.doc == doc;
+										   } ),
+						   mDidChangeQueue.end() );
 }
 
 const LSPServerCapabilities& LSPClientServer::getCapabilities() const {
@@ -1250,7 +1450,8 @@ LSPClientServer::LSPRequestHandle LSPClientServer::cancel( const PluginIDType& r
 LSPClientServer::LSPRequestHandle LSPClientServer::write( const json& msg,
 														  const JsonReplyHandler& h,
 														  const JsonReplyHandler& eh,
-														  const int id ) {
+														  const int id,
+														  const RawReplyHandler& rh ) {
 	LSPRequestHandle ret;
 	ret.server = this;
 
@@ -1266,15 +1467,12 @@ LSPClientServer::LSPRequestHandle LSPClientServer::write( const json& msg,
 		ob[MEMBER_ID] = msgId;
 		ret.mId = msgId;
 		Lock l( mHandlersMutex );
-		mHandlers[msgId] = { h, eh };
+		mHandlers[msgId] = { h, eh, rh };
 	} else if ( id ) {
 		ob[MEMBER_ID] = id;
 	}
 
 	try {
-		std::string sjson = ob.dump();
-		sjson = String::format( "Content-Length: %lu\r\n\r\n%s", sjson.length(), sjson.c_str() );
-
 		if ( mReady || msg[MEMBER_METHOD] == "initialize" ) {
 			std::string method;
 			if ( msg.contains( MEMBER_METHOD ) )
@@ -1282,17 +1480,29 @@ LSPClientServer::LSPRequestHandle LSPClientServer::write( const json& msg,
 			else if ( msg.contains( MEMBER_MESSAGE ) )
 				method = msg[MEMBER_MESSAGE];
 			Log::info( "LSPClientServer server %s calling %s", mLSP.name.c_str(), method.c_str() );
-			Log::debug( "LSPClientServer server %s sending message:\n%s", mLSP.name.c_str(),
-						sjson.c_str() );
+
+			// The message is serialized into the same buffer every time, and the header and the
+			// payload are written separately to avoid copying the payload
+			Lock l( mWriteMutex );
+			mWriteBuffer.clear();
+			nlohmann::detail::serializer<json> serializer(
+				nlohmann::detail::output_adapter<char, std::string>( mWriteBuffer ), ' ' );
+			serializer.dump( ob, false, false, 0 );
+			std::string header( CONTENT_LENGTH_HEADER " " + String::toString( mWriteBuffer.size() ) +
+								"\r\n\r\n" );
+			Log::debug( "LSPClientServer server %s sending message:\n%s%s", mLSP.name.c_str(),
+						header.c_str(), mWriteBuffer.c_str() );
 
 			if ( mSocket ) {
 				size_t sent = 0;
-				mSocket->send( sjson.c_str(), sjson.size(), sent );
+				mSocket->send( header.c_str(), header.size(), sent );
+				mSocket->send( mWriteBuffer.c_str(), mWriteBuffer.size(), sent );
 			} else {
-				mProcess.write( sjson );
+				mProcess.write( header );
+				mProcess.write( mWriteBuffer );
 			}
 		} else {
-			mQueuedMessages.push_back( { std::move( ob ), h, eh } );
+			mQueuedMessages.push_back( { std::move( ob ), h, eh, rh } );
 		}
 	} catch ( const json::exception& e ) {
 		Log::debug( "LSPClientServer::write server %s failed. Coudln't dump json err: %s",
@@ -1304,15 +1514,22 @@ LSPClientServer::LSPRequestHandle LSPClientServer::write( const json& msg,
 
 void LSPClientServer::sendAsync( const json& msg, const JsonReplyHandler& h,
 								 const JsonReplyHandler& eh ) {
+	// The request must see the latest contents, take them while they can't be modified
+	if ( Engine::isRunninMainThread() )
+		snapshotDidChangeQueue();
 	getThreadPool()->run( [this, msg, h, eh] { send( msg, h, eh ); } );
 }
 
 LSPClientServer::LSPRequestHandle LSPClientServer::send( const json& msg, const JsonReplyHandler& h,
-														 const JsonReplyHandler& eh ) {
+														 const JsonReplyHandler& eh,
+														 const RawReplyHandler& rh ) {
 	eeASSERT( !needsAsync() );
 
 	if ( isRunning() ) {
-		return write( msg, h, eh );
+		// Any request must see the latest document contents
+		if ( !msg.contains( MEMBER_METHOD ) || msg[MEMBER_METHOD] != "textDocument/didChange" )
+			processDidChangeQueue();
+		return write( msg, h, eh, 0, rh );
 	} else {
 		Log::debug( "LSPClientServer server %s Send for non-running server: %s", mLSP.name.c_str(),
 					mLSP.name.c_str() );
@@ -1362,26 +1579,146 @@ LSPClientServer::didChange( const URI& document, int version, const std::string&
 
 LSPClientServer::LSPRequestHandle
 LSPClientServer::didChange( TextDocument* doc, const std::vector<DocumentContentChange>& change ) {
-	Lock l( mClientsMutex );
-	auto it = mClients.find( doc );
-	if ( it != mClients.end() )
-		return didChange( doc->getURI(), it->second->getVersion(),
-						  change.empty() ? doc->getText().toUtf8() : "", change );
-	return LSPRequestHandle();
+	auto syncKind = mCapabilities.textDocumentSync.change;
+	// Servers with incremental sync never receive the full document
+	if ( syncKind == LSPDocumentSyncKind::None ||
+		 ( syncKind == LSPDocumentSyncKind::Incremental && change.empty() ) )
+		return LSPRequestHandle();
+	URI uri;
+	int version;
+	std::string text;
+	{
+		Lock l( mClientsMutex );
+		auto it = mClients.find( doc );
+		if ( it == mClients.end() )
+			return LSPRequestHandle();
+		uri = doc->getURI();
+		version = it->second->getVersion();
+		if ( syncKind == LSPDocumentSyncKind::Full )
+			text = doc->getText().toUtf8();
+	}
+	return didChange( uri, version, text, change );
+}
+
+static TextPosition textEndPosition( const TextPosition& start, const String& text ) {
+	size_t lastLine = text.find_last_of( '\n' );
+	if ( lastLine == String::InvalidPos )
+		return { start.line(), start.column() + static_cast<Int64>( text.size() ) };
+	return { start.line() + static_cast<Int64>( std::count( text.begin(), text.end(), '\n' ) ),
+			 static_cast<Int64>( text.size() - lastLine - 1 ) };
+}
+
+// Merges the next change into the previous one if both are contiguous edits, as when typing or
+// erasing several characters in a row.
+static bool mergeContentChange( DocumentContentChange& prev, const DocumentContentChange& next ) {
+	bool prevIsInsert = prev.range.start() == prev.range.end();
+	bool nextIsInsert = next.range.start() == next.range.end();
+	bool prevIsRemove = prev.text.empty();
+	bool nextIsRemove = next.text.empty();
+
+	if ( prevIsInsert && nextIsInsert ) {
+		// Text written after the previous text written
+		if ( next.range.start() != textEndPosition( prev.range.start(), prev.text ) )
+			return false;
+		prev.text += next.text;
+		return true;
+	}
+
+	if ( prevIsInsert && nextIsRemove ) {
+		// Text erased at the end of the previous text written, in the same line
+		TextPosition end( textEndPosition( prev.range.start(), prev.text ) );
+		Int64 lineStart = end.line() == prev.range.start().line() ? prev.range.start().column() : 0;
+		if ( next.range.end() != end || next.range.start().line() != end.line() ||
+			 next.range.start().column() < lineStart )
+			return false;
+		prev.text.resize( prev.text.size() -
+						  ( next.range.end().column() - next.range.start().column() ) );
+		return true;
+	}
+
+	if ( prevIsRemove && nextIsRemove ) {
+		// Backspace: the range erased ends where the previous range started
+		if ( next.range.end() == prev.range.start() ) {
+			prev.range.setStart( next.range.start() );
+			return true;
+		}
+		// Delete: the range erased starts where the previous range started, in the same line
+		if ( next.range.start() == prev.range.start() &&
+			 next.range.start().line() == next.range.end().line() &&
+			 prev.range.start().line() == prev.range.end().line() ) {
+			prev.range.end().setColumn( prev.range.end().column() + next.range.end().column() -
+										next.range.start().column() );
+			return true;
+		}
+	}
+
+	return false;
 }
 
-void LSPClientServer::queueDidChange( const URI& document, int version, const std::string&,
-									  const std::vector<DocumentContentChange>& change ) {
+void LSPClientServer::queueDidChange( TextDocument* doc, int version,
+									  const DocumentContentChange& change ) {
+	auto syncKind = mCapabilities.textDocumentSync.change;
+	if ( syncKind == LSPDocumentSyncKind::None )
+		return;
 	Lock l( mDidChangeMutex );
-	mDidChangeQueue.push( { document, version, change } );
+	auto it = std::find_if( mDidChangeQueue.begin(), mDidChangeQueue.end(),
+							[doc]( const DidChangeQueue& queue ) { return queue.doc == doc; } );
+	if ( it == mDidChangeQueue.end() ) {
+		mDidChangeQueue.push_back( { doc, doc->getURI(), (IdType)version, {} } );
+		it = mDidChangeQueue.end() - 1;
+	}
+	it->version = version;
+	// Full sync servers receive the whole document, the text is taken once when the queue is
+	// flushed instead of on every change.
+	if ( syncKind == LSPDocumentSyncKind::Full ) {
+		it->needsText = true;
+	} else if ( it->change.empty() || !mergeContentChange( it->change.back(), change ) ) {
+		it->change.push_back( change );
+	}
+}
+
+void LSPClientServer::snapshotDidChangeQueue() {
+	if ( mCapabilities.textDocumentSync.change != LSPDocumentSyncKind::Full )
+		return;
+	// Same lock order as registerDoc (which notifies the document open)
+	Lock cl( mClientsMutex );
+	Lock l( mDidChangeMutex );
+	for ( auto& change : mDidChangeQueue ) {
+		if ( !change.needsText || !hasDocument( change.doc ) )
+			continue;
+		change.text = change.doc->getText().toUtf8();
+		change.textVersion = change.version;
+		change.hasText = true;
+		change.needsText = false;
+	}
 }
 
 void LSPClientServer::processDidChangeQueue() {
+	Lock cl( mClientsMutex );
 	Lock l( mDidChangeMutex );
-	while ( !mDidChangeQueue.empty() ) {
-		auto& change = mDidChangeQueue.front();
-		didChange( change.uri, change.version, "", change.change );
-		mDidChangeQueue.pop();
+	if ( mDidChangeQueue.empty() )
+		return;
+	std::vector<DidChangeQueue> queue( std::move( mDidChangeQueue ) );
+	mDidChangeQueue.clear();
+	auto syncKind = mCapabilities.textDocumentSync.change;
+	for ( auto& change : queue ) {
+		// The document could have been closed while its changes were waiting in the queue
+		if ( !hasDocument( change.doc ) )
+			continue;
+		if ( syncKind == LSPDocumentSyncKind::Full ) {
+			if ( change.hasText ) {
+				auto params = textDocumentParams( change.uri, change.textVersion );
+				params["contentChanges"] = json{ json{ MEMBER_TEXT, change.text } };
+				send( newRequest( "textDocument/didChange", params ) );
+				change.hasText = false;
+				change.text.clear();
+			}
+			// Changed after the snapshot, it will be sent with the next flush
+			if ( change.needsText )
+				mDidChangeQueue.emplace_back( std::move( change ) );
+		} else if ( syncKind == LSPDocumentSyncKind::Incremental ) {
+			didChange( change.uri, change.version, "", change.change );
+		}
 	}
 }
 
@@ -1490,6 +1827,90 @@ static LSPWorkDoneProgressParams parseWorkDone( const json& json ) {
 	return parseProgress<LSPWorkDoneProgressValue>( json );
 }
 
+static bool isDebugLogging() {
+	return Log::instance() && Log::instance()->getLogLevelThreshold() == LogLevel::Debug;
+}
+
+static const char* skipJsonString( const char* cur, const char* end ) {
+	for ( cur++; cur < end; cur++ ) {
+		if ( *cur == '\\' )
+			cur++;
+		else if ( *cur == '"' )
+			return cur + 1;
+	}
+	return nullptr;
+}
+
+/** Finds the "id" of a reply without parsing the message. Only the members of the top level
+ * object are inspected, nested values are skipped.
+ * @return False if the message is not a reply or the id couldn't be read. */
+static bool findReplyId( const char* data, size_t size, PluginIDType& id ) {
+	const char* cur = data;
+	const char* end = data + size;
+	int depth = 0;
+	bool expectKey = false;
+	bool found = false;
+
+	while ( cur < end ) {
+		char c = *cur;
+		if ( c == '"' ) {
+			const char* str = cur;
+			cur = skipJsonString( cur, end );
+			if ( cur == nullptr )
+				return false;
+			if ( depth != 1 || !expectKey )
+				continue;
+			expectKey = false;
+			std::string_view key( str + 1, cur - str - 2 );
+			if ( key == MEMBER_METHOD )
+				return false;
+			if ( key != MEMBER_ID )
+				continue;
+			while ( cur < end && ( *cur == ':' || isspace( *cur ) ) )
+				cur++;
+			if ( cur >= end )
+				return false;
+			if ( *cur == '"' ) {
+				const char* valEnd = skipJsonString( cur, end );
+				if ( valEnd == nullptr )
+					return false;
+				std::string_view val( cur + 1, valEnd - cur - 2 );
+				// Escaped ids are left to the json parser
+				if ( val.find( '\\' ) != std::string_view::npos )
+					return false;
+				id = std::string( val );
+				cur = valEnd;
+			} else {
+				Int64 val = 0;
+				bool negative = *cur == '-';
+				if ( negative )
+					cur++;
+				if ( cur >= end || !isdigit( *cur ) )
+					return false;
+				while ( cur < end && isdigit( *cur ) )
+					val = val * 10 + ( *cur++ - '0' );
+				if ( cur < end && ( *cur == '.' || *cur == 'e' || *cur == 'E' ) )
+					return false;
+				id = negative ? -val : val;
+			}
+			found = true;
+			continue;
+		}
+
+		if ( c == '{' || c == '[' ) {
+			depth++;
+			expectKey = depth == 1 && c == '{';
+		} else if ( c == '}' || c == ']' ) {
+			depth--;
+		} else if ( c == ',' ) {
+			expectKey = depth == 1;
+		}
+		cur++;
+	}
+
+	return found;
+}
+
 PluginIDType LSPClientServer::getID( const json& json ) {
 	const auto& memberID = json[MEMBER_ID];
 	if ( memberID.is_string() ) {
@@ -1517,7 +1938,8 @@ void LSPClientServer::publishDiagnostics( const json& msg ) {
 	}
 	Log::debug( "LSPClientServer::publishDiagnostics: %s - returned %zu items",
 				res.uri.toString().c_str(), res.diagnostics.size() );
-	Log::debug( "LSPClientServer::publishDiagnostics: %s", msg.dump().c_str() );
+	if ( isDebugLogging() )
+		Log::debug( "LSPClientServer::publishDiagnostics: %s", msg.dump().c_str() );
 }
 
 void LSPClientServer::workDoneProgress( const LSPWorkDoneProgressParams& workDoneParams ) {
@@ -1566,13 +1988,15 @@ void LSPClientServer::processNotification( const json& msg ) {
 		workDoneProgress( parseWorkDone( msg[MEMBER_PARAMS] ) );
 		return;
 	}
-	Log::debug( "LSPClientServer::processNotification server %s: %s", mLSP.name.c_str(),
-				msg.dump().c_str() );
+	if ( isDebugLogging() )
+		Log::debug( "LSPClientServer::processNotification server %s: %s", mLSP.name.c_str(),
+					msg.dump().c_str() );
 }
 
 void LSPClientServer::processRequest( const json& msg ) {
-	Log::debug( "LSPClientServer::processRequest server %s:\n%s", mLSP.name.c_str(),
-				msg.dump().c_str() );
+	if ( isDebugLogging() )
+		Log::debug( "LSPClientServer::processRequest server %s:\n%s", mLSP.name.c_str(),
+					msg.dump().c_str() );
 	auto method = msg[MEMBER_METHOD].get<std::string>();
 	auto msgid = getID( msg );
 	if ( method == "workspace/applyEdit" ) {
@@ -1617,109 +2041,148 @@ void LSPClientServer::processRequest( const json& msg ) {
 void LSPClientServer::readStdOut( const char* bytes, size_t n ) {
 	mReceive.append( bytes, n );
 
+	// Wait until the message being received is complete
+	if ( mReceiveFrameSize && mReceive.size() < mReceiveFrameSize )
+		return;
+	mReceiveFrameSize = 0;
+
 	std::string& buffer = mReceive;
+	// The messages are parsed in place, the consumed data is removed from the buffer at the end
+	size_t pos = 0;
 
 	while ( ( mUsingProcess && !mProcess.isShuttingDown() ) ||
 			( mUsingSocket && mSocket != nullptr ) ) {
-		auto index = buffer.find( CONTENT_LENGTH_HEADER );
-		if ( index == std::string::npos ) {
-			if ( buffer.size() > ( (Uint64)1 << 20 ) )
-				buffer.clear();
+		auto header = buffer.find( CONTENT_LENGTH_HEADER, pos );
+		if ( header == std::string::npos ) {
+			if ( buffer.size() - pos > ( (Uint64)1 << 20 ) )
+				pos = buffer.size();
 			break;
 		}
 
-		index += strlen( CONTENT_LENGTH_HEADER );
+		auto index = header + strlen( CONTENT_LENGTH_HEADER );
 		auto endindex = buffer.find( "\r\n", index );
 		auto msgstart = buffer.find( "\r\n\r\n", index );
-		if ( endindex == std::string::npos || msgstart == std::string::npos )
+		if ( endindex == std::string::npos || msgstart == std::string::npos ) {
+			pos = header;
 			break;
+		}
 
 		msgstart += 4;
-		int length = 0;
-		bool ok = String::fromString( length, buffer.substr( index, endindex - index ) );
+		Uint64 length = 0;
+		bool ok = false;
+		for ( auto i = index; i < endindex; i++ ) {
+			if ( buffer[i] >= '0' && buffer[i] <= '9' ) {
+				length = length * 10 + ( buffer[i] - '0' );
+				ok = true;
+			} else if ( buffer[i] != ' ' ) {
+				ok = false;
+				break;
+			}
+		}
 		// FIXME perhaps detect if no reply for some time
 		// then again possibly better left to user to restart in such case
 		if ( !ok ) {
 			Log::debug( "LSPClientServer::readStdOut server %s invalid " CONTENT_LENGTH,
 						mLSP.name.c_str() );
 			// flush and try to carry on to some next header
-			buffer.erase( 0, msgstart );
+			pos = msgstart;
 			continue;
 		}
 		// sanity check to avoid extensive buffering
 		if ( length > ( 1 << 29 ) ) {
 			Log::debug( "LSPClientServer::readStdOut server %s excessive size", mLSP.name.c_str() );
-			buffer.clear();
+			pos = buffer.size();
 			continue;
 		}
 		if ( msgstart + length > buffer.length() ) {
+			pos = header;
+			mReceiveFrameSize = msgstart + length - header;
 			break;
 		}
 
 		// now onto payload
-		auto payload = buffer.substr( msgstart, length );
-		buffer.erase( 0, msgstart + length );
+		const char* payload = buffer.data() + msgstart;
+		pos = msgstart + length;
 
-		if ( payload.empty() ) {
+		if ( length == 0 ) {
 			Log::debug( "LSPClientServer::readStdOut server %s empty payload", mLSP.name.c_str() );
 			continue;
 		}
 
+		processMessage( payload, length );
+	}
+
+	buffer.erase( 0, pos );
+	if ( mReceiveFrameSize > buffer.capacity() )
+		buffer.reserve( mReceiveFrameSize );
+}
+
+void LSPClientServer::processMessage( const char* data, size_t size ) {
+	PluginIDType msgid;
+	ReplyHandlers handlers;
+	bool handlerFound = false;
+
+	// Replies with a raw handler are decoded straight from the payload
+	if ( findReplyId( data, size, msgid ) ) {
+		Lock l( mHandlersMutex );
+		auto it = mHandlers.find( msgid );
+		if ( it != mHandlers.end() && it->second.rh ) {
+			handlers = std::move( it->second );
+			mHandlers.erase( it );
+			handlerFound = true;
+		}
+	}
+
+	if ( handlerFound && handlers.rh( msgid, data, size ) )
+		return;
+
 #ifndef EE_DEBUG
-		try {
+	try {
 #endif
-			auto res = json::parse( payload );
+		auto res = json::parse( data, data + size );
 
-			PluginIDType msgid;
-			if ( res.contains( MEMBER_ID ) ) {
-				msgid = getID( res );
-			} else {
-				processNotification( res );
-				continue;
-			}
+		if ( !res.contains( MEMBER_ID ) ) {
+			processNotification( res );
+			return;
+		}
 
-			if ( res.contains( MEMBER_METHOD ) ) {
-				processRequest( res );
-				continue;
-			}
+		if ( res.contains( MEMBER_METHOD ) ) {
+			processRequest( res );
+			return;
+		}
 
+		msgid = getID( res );
+
+		if ( isDebugLogging() )
 			Log::debug( "LSPClientServer::readStdOut server %s said:\n%s", mLSP.name.c_str(),
 						res.dump().c_str() );
 
-			HandlersMap::iterator it;
-			HandlersMap::iterator itEnd;
-			JsonReplyHandler handlerOK;
-			JsonReplyHandler handlerErr;
-			bool handlerFound = false;
-			{
-				Lock l( mHandlersMutex );
-				it = mHandlers.find( msgid );
-				itEnd = mHandlers.end();
-				handlerFound = it != itEnd;
-				if ( handlerFound ) {
-					handlerOK = it->second.first;
-					handlerErr = it->second.second;
-					mHandlers.erase( it );
-				}
+		if ( !handlerFound ) {
+			Lock l( mHandlersMutex );
+			auto it = mHandlers.find( msgid );
+			handlerFound = it != mHandlers.end();
+			if ( handlerFound ) {
+				handlers = std::move( it->second );
+				mHandlers.erase( it );
 			}
+		}
 
-			if ( handlerFound ) {
-				if ( res.contains( MEMBER_ERROR ) && handlerErr ) {
-					handlerErr( msgid, res[MEMBER_ERROR] );
-				} else {
-					handlerOK( msgid, res[MEMBER_RESULT] );
-				}
+		if ( handlerFound ) {
+			if ( res.contains( MEMBER_ERROR ) && handlers.eh ) {
+				handlers.eh( msgid, res[MEMBER_ERROR] );
 			} else {
-				Log::debug( "LSPClientServer::readStdOut server %s unexpected reply id: %s",
-							mLSP.name.c_str(), msgid.toString().c_str() );
+				handlers.h( msgid, res[MEMBER_RESULT] );
 			}
-#ifndef EE_DEBUG
-		} catch ( const json::exception& e ) {
-			Log::debug( "LSPClientServer::readStdOut server %s said: Coudln't parse json err: %s",
-						mLSP.name.c_str(), e.what() );
+		} else {
+			Log::debug( "LSPClientServer::readStdOut server %s unexpected reply id: %s",
+						mLSP.name.c_str(), msgid.toString().c_str() );
 		}
-#endif
+#ifndef EE_DEBUG
+	} catch ( const json::exception& e ) {
+		Log::debug( "LSPClientServer::readStdOut server %s said: Coudln't parse json err: %s",
+					mLSP.name.c_str(), e.what() );
 	}
+#endif
 }
 
 void LSPClientServer::readStdErr( const char* bytes, size_t n ) {
@@ -1739,7 +2202,7 @@ void LSPClientServer::readStdErr( const char* bytes, size_t n ) {
 
 void LSPClientServer::sendQueuedMessages() {
 	for ( const auto& msg : mQueuedMessages )
-		write( msg.msg, msg.h, msg.eh );
+		write( msg.msg, msg.h, msg.eh, 0, msg.rh );
 	mQueuedMessages.clear();
 }
 
@@ -1888,10 +2351,22 @@ LSPClientServer::LSPRequestHandle LSPClientServer::documentCompletion( const URI
 LSPClientServer::LSPRequestHandle
 LSPClientServer::documentCompletion( const URI& document, const TextPosition& pos,
 									 const CompletionHandler& h ) {
-	return documentCompletion( document, pos, [h]( const IdType& id, const json& json ) {
-		if ( h )
-			h( id, parseDocumentCompletion( json ) );
-	} );
+	auto params = textDocumentPositionParams( document, pos );
+	return send(
+		newRequest( "textDocument/completion", params ),
+		[h]( const IdType& id, const json& json ) {
+			if ( h )
+				h( id, parseDocumentCompletion( json ) );
+		},
+		nullptr,
+		[h]( const IdType& id, const char* data, size_t size ) {
+			LSPCompletionReplySax sax;
+			if ( !json::sax_parse( data, data + size, &sax ) )
+				return false;
+			if ( h )
+				h( id, sax.list );
+			return true;
+		} );
 }
 
 LSPClientServer::LSPRequestHandle LSPClientServer::signatureHelp( const URI& document,
@@ -14,7 +14,6 @@
 #include <eepp/ui/uipopupmenu.hpp>
 #include <memory>
 #include <nlohmann/json.hpp>
-#include <queue>
 
 using json = nlohmann::json;
 
@@ -37,6 +36,9 @@ class LSPClientServer {
 	template <typename T> using WReplyHandler = std::function<void( const IdType& id, T&& )>;
 
 	using JsonReplyHandler = ReplyHandler<json>;
+	/** Handles a reply decoding its raw payload. Returns false if it couldn't decode it, then the
+	 * payload is parsed as a json document and handled by the json handlers. */
+	using RawReplyHandler = std::function<bool( const IdType& id, const char* data, size_t size )>;
 	using CodeActionHandler = ReplyHandler<std::vector<LSPCodeAction>>;
 	using HoverHandler = ReplyHandler<LSPHover>;
 	using CompletionHandler = ReplyHandler<LSPCompletionList>;
@@ -80,7 +82,8 @@ class LSPClientServer {
 	LSPRequestHandle cancel( const PluginIDType& id );
 
 	LSPRequestHandle send( const json& msg, const JsonReplyHandler& h = nullptr,
-						   const JsonReplyHandler& eh = nullptr );
+						   const JsonReplyHandler& eh = nullptr,
+						   const RawReplyHandler& rh = nullptr );
 
 	void sendAsync( const json& msg, const JsonReplyHandler& h = nullptr,
 					const JsonReplyHandler& eh = nullptr );
@@ -112,9 +115,15 @@ class LSPClientServer {
 	LSPRequestHandle didChange( TextDocument* doc,
 								const std::vector<DocumentContentChange>& change = {} );
 
-	void queueDidChange( const URI& document, int version, const std::string& text,
-						 const std::vector<DocumentContentChange>& change = {} );
+	/** Queues a document change, merging it with the previous queued change when possible. The
+	 * queue is sent with processDidChangeQueue or before any other message sent to the server. */
+	void queueDidChange( TextDocument* doc, int version, const DocumentContentChange& change );
 
+	/** Takes the text of the documents queued for servers with full sync. Must be called from the
+	 * thread that modifies the documents, the queue is processed from the thread pool. */
+	void snapshotDidChangeQueue();
+
+	/** Sends the queued changes. Documents waiting for a text snapshot stay in the queue. */
 	void processDidChangeQueue();
 
 	void documentDefinition( const URI& document, const TextPosition& pos );
@@ -228,7 +237,12 @@ class LSPClientServer {
 	TcpSocket* mSocket{ nullptr };
 	std::vector<TextDocument*> mDocs;
 	std::unordered_map<TextDocument*, std::unique_ptr<LSPDocumentClient>> mClients;
-	using HandlersMap = std::map<PluginIDType, std::pair<JsonReplyHandler, JsonReplyHandler>>;
+	struct ReplyHandlers {
+		JsonReplyHandler h;
+		JsonReplyHandler eh;
+		RawReplyHandler rh;
+	};
+	using HandlersMap = std::map<PluginIDType, ReplyHandlers>;
 	HandlersMap mHandlers;
 	Mutex mClientsMutex;
 	Mutex mHandlersMutex;
@@ -239,19 +253,34 @@ class LSPClientServer {
 		json msg;
 		JsonReplyHandler h;
 		JsonReplyHandler eh;
+		RawReplyHandler rh;
 	};
 	std::vector<QueueMessage> mQueuedMessages;
+	/** Received data, the messages are parsed in place from it. */
 	std::string mReceive;
+	/** Size of the message being received, no parsing is attempted until it's complete. */
+	size_t mReceiveFrameSize{ 0 };
+	/** Serialized message being sent, reused for every message. */
+	std::string mWriteBuffer;
+	Mutex mWriteMutex;
 	std::string mReceiveErr;
 	LSPServerCapabilities mCapabilities;
 	URI mWorkspaceFolder;
 
 	struct DidChangeQueue {
+		TextDocument* doc;
 		URI uri;
 		IdType version;
 		std::vector<DocumentContentChange> change;
+		/** Servers with full sync only: the document changed since the last text snapshot. */
+		bool needsText{ false };
+		bool hasText{ false };
+		/** Snapshot of the document text and its version. */
+		std::string text;
+		IdType textVersion{ 0 };
 	};
-	std::queue<DidChangeQueue> mDidChangeQueue;
+	/** Pending changes of every document, in the order the documents were modified. */
+	std::vector<DidChangeQueue> mDidChangeQueue;
 	Mutex mDidChangeMutex;
 
 	std::atomic<int> mLastMsgId{ 0 };
@@ -261,7 +290,10 @@ class LSPClientServer {
 	void readStdErr( const char* bytes, size_t n );
 
 	LSPRequestHandle write( const json& msg, const JsonReplyHandler& h = nullptr,
-							const JsonReplyHandler& eh = nullptr, const int id = 0 );
+							const JsonReplyHandler& eh = nullptr, const int id = 0,
+							const RawReplyHandler& rh = nullptr );
+
+	void processMessage( const char* data, size_t size );
 
 	void initialize();
 
@@ -26,6 +26,8 @@ LSPDocumentClient::~LSPDocumentClient() {
 		sceneNode->removeActionsByTag( mTag );
 	if ( nullptr != sceneNode && 0 != mTagSemanticTokens )
 		sceneNode->removeActionsByTag( mTagSemanticTokens );
+	if ( nullptr != sceneNode && 0 != mTagDidChange )
+		sceneNode->removeActionsByTag( mTagDidChange );
 	mShutdown = true;
 	while ( mRunningSemanticTokens )
 		Sys::sleep( Milliseconds( 0.1f ) );
@@ -37,10 +39,10 @@ void LSPDocumentClient::onDocumentLoaded( TextDocument* ) {
 
 void LSPDocumentClient::onDocumentTextChanged( const DocumentContentChange& change ) {
 	++mVersion;
-	// If several change event are being fired, the thread pool can't guaranteed that it will be
-	// executed in FIFO. Se we accumulate the events in a queue and fire them in correct order.
-	mServer->queueDidChange( mDoc->getURI(), mVersion, "", { change } );
-	mServer->getThreadPool()->run( [&, change]() { mServer->processDidChangeQueue(); } );
+	// The changes are accumulated and merged in a queue, and sent in order once the edition pauses
+	// or before any other request to the server.
+	mServer->queueDidChange( mDoc, mVersion, change );
+	sendDidChangeDelayed();
 	requestSymbolsDelayed();
 	requestSemanticHighlightingDelayed();
 }
@@ -106,6 +108,7 @@ void LSPDocumentClient::refreshTag() {
 	String::HashType oldTag = mTag;
 	mTag = String::hash( mDoc->getURI().toString() );
 	mTagSemanticTokens = String::hash( mDoc->getURI().toString() + ":semantictokens" );
+	mTagDidChange = String::hash( mDoc->getURI().toString() + ":didchange" );
 	UISceneNode* sceneNode = getUISceneNode();
 	if ( nullptr != sceneNode && 0 != oldTag )
 		sceneNode->removeActionsByTag( oldTag );
@@ -164,8 +167,8 @@ UISceneNode* LSPDocumentClient::getUISceneNode() {
 	return server->getManager()->getPluginManager()->getUISceneNode();
 }
 
-static std::string semanticTokenTypeToSyntaxType( const std::string& type,
-												  const SyntaxDefinition& ) {
+static SyntaxStyleType semanticTokenTypeToSyntaxType( const std::string& type,
+													  const SyntaxDefinition& ) {
 	switch ( String::hash( type ) ) {
 		case SemanticTokenTypes::Namespace:
 		case SemanticTokenTypes::Type:
@@ -174,39 +177,39 @@ static std::string semanticTokenTypeToSyntaxType( const std::string& type,
 		case SemanticTokenTypes::Interface:
 		case SemanticTokenTypes::Struct:
 		case SemanticTokenTypes::TypeParameter:
-			return "keyword2";
+			return SyntaxStyleTypes::Keyword2;
 		case SemanticTokenTypes::Parameter:
 		case SemanticTokenTypes::Variable:
-			return "symbol";
+			return SyntaxStyleTypes::Symbol;
 		case SemanticTokenTypes::Property:
-			return "symbol";
+			return SyntaxStyleTypes::Symbol;
 		case SemanticTokenTypes::EnumMember:
 		case SemanticTokenTypes::Event:
-			return "keyword2";
+			return SyntaxStyleTypes::Keyword2;
 		case SemanticTokenTypes::Function:
 		case SemanticTokenTypes::Method:
 		case SemanticTokenTypes::Member:
-			return "function";
+			return SyntaxStyleTypes::Function;
 		case SemanticTokenTypes::Macro:
-			return "keyword2";
+			return SyntaxStyleTypes::Keyword2;
 		case SemanticTokenTypes::Keyword:
 		case SemanticTokenTypes::Modifier:
-			return "keyword";
+			return SyntaxStyleTypes::Keyword;
 		case SemanticTokenTypes::Comment:
-			return "comment";
+			return SyntaxStyleTypes::Comment;
 		case SemanticTokenTypes::Str:
-			return "string";
+			return SyntaxStyleTypes::Str;
 		case SemanticTokenTypes::Number:
 		case SemanticTokenTypes::Regexp:
-			return "number";
+			return SyntaxStyleTypes::Number;
 		case SemanticTokenTypes::Operator:
-			return "operator";
+			return SyntaxStyleTypes::Operator;
 		case SemanticTokenTypes::Decorator:
-			return "literal";
+			return SyntaxStyleTypes::Literal;
 		case SemanticTokenTypes::Unknown:
 			break;
 	};
-	return "normal";
+	return SyntaxStyleTypes::Normal;
 }
 
 void LSPDocumentClient::processTokens( const LSPSemanticTokensDelta& tokens ) {
@@ -301,6 +304,24 @@ void LSPDocumentClient::requestSymbols() {
 	}
 }
 
+void LSPDocumentClient::sendDidChangeDelayed() {
+	LSPClientServer* server = mServer;
+	UISceneNode* sceneNode = getUISceneNode();
+	if ( !sceneNode ) {
+		server->snapshotDidChangeQueue();
+		server->getThreadPool()->run( [server]() { server->processDidChangeQueue(); } );
+		return;
+	}
+	sceneNode->removeActionsByTag( mTagDidChange );
+	// The text snapshot of full sync servers is taken in the main thread, once per flush
+	sceneNode->runOnMainThread(
+		[server]() {
+			server->snapshotDidChangeQueue();
+			server->getThreadPool()->run( [server]() { server->processDidChangeQueue(); } );
+		},
+		Milliseconds( 50 ), mTagDidChange );
+}
+
 void LSPDocumentClient::requestSymbolsDelayed() {
 	if ( !mServer || !mServer->getCapabilities().documentSymbolProvider )
 		return;
@@ -52,6 +52,7 @@ class LSPDocumentClient : public TextDocument::Client {
 	TextDocument* mDoc{ nullptr };
 	String::HashType mTag{ 0 };
 	String::HashType mTagSemanticTokens{ 0 };
+	String::HashType mTagDidChange{ 0 };
 	int mVersion{ 0 };
 	std::string mSemanticeResultId;
 	LSPSemanticTokensDelta mSemanticTokens;
@@ -64,6 +65,8 @@ class LSPDocumentClient : public TextDocument::Client {
 
 	void requestSymbols();
 
+	void sendDidChangeDelayed();
+
 	void requestSymbolsDelayed();
 
 	void requestSemanticHighlighting();
@@ -75,6 +75,7 @@ void ProjectDirectoryTree::scan( const ProjectDirectoryTree::ScanCompleteEvent&
 				getDirectoryFiles( mFiles, mNames, mPath, info, ignoreHidden, mIgnoreMatcher,
 								   mAllowedMatcher.get() );
 			}
+			mFilesVersion++;
 			mIsReady = true;
 			mRunning = false;
 			mApp->getPluginManager()->subscribeMessages(
@@ -94,47 +95,199 @@ void ProjectDirectoryTree::scan( const ProjectDirectoryTree::ScanCompleteEvent&
 #endif
 }
 
+// Files per shard when matching in parallel.
+static constexpr Int64 FUZZY_MATCH_GRAIN_SIZE = 4096;
+
+// Maximum number of previous patterns kept to narrow the next match.
+static constexpr size_t FUZZY_MATCH_MAX_STEPS = 16;
+
+static inline Uint64 fuzzyCharMask( const char& ch ) {
+	unsigned char c =
+		static_cast<unsigned char>( std::tolower( static_cast<unsigned char>( ch ) ) );
+	if ( c >= 'a' && c <= 'z' )
+		return Uint64( 1 ) << ( c - 'a' );
+	if ( c >= '0' && c <= '9' )
+		return Uint64( 1 ) << ( 26 + c - '0' );
+	switch ( c ) {
+		case ' ':
+			// Spaces are ignored by String::fuzzyMatch
+			return 0;
+		case '.':
+			return Uint64( 1 ) << 36;
+		case '_':
+			return Uint64( 1 ) << 37;
+		case '-':
+			return Uint64( 1 ) << 38;
+		case '/':
+		case '\\':
+			return Uint64( 1 ) << 39;
+		default:
+			return Uint64( 1 ) << ( 40 + c % 24 );
+	}
+}
+
+static Uint64 fuzzyStringMask( const std::string& str ) {
+	Uint64 mask = 0;
+	for ( const auto& ch : str )
+		mask |= fuzzyCharMask( ch );
+	return mask;
+}
+
+static std::string fuzzyFoldPattern( const std::string& pattern ) {
+	std::string folded;
+	folded.reserve( pattern.size() );
+	for ( const auto& ch : pattern ) {
+		if ( ch != ' ' )
+			folded += static_cast<char>( std::tolower( static_cast<unsigned char>( ch ) ) );
+	}
+	return folded;
+}
+
+// Orders by best score first, files found first win ties.
+static inline bool fuzzyBetterMatch( const std::pair<int, Uint32>& a,
+									 const std::pair<int, Uint32>& b ) {
+	return a.first > b.first || ( a.first == b.first && a.second < b.second );
+}
+
+void ProjectDirectoryTree::updateMatchMasks() const {
+	if ( mMasksVersion == mFilesVersion )
+		return;
+	mPathMasks.resize( mFiles.size() );
+	mNameMasks.resize( mNames.size() );
+	mPool->parallelFor(
+		0, mFiles.size(),
+		[&]( Int64 begin, Int64 end ) {
+			for ( Int64 i = begin; i < end; i++ ) {
+				mPathMasks[i] = fuzzyStringMask( mFiles[i] );
+				mNameMasks[i] = fuzzyStringMask( mNames[i] );
+			}
+		},
+		FUZZY_MATCH_GRAIN_SIZE );
+	mFuzzyMatchSteps.clear();
+	mMasksVersion = mFilesVersion;
+}
+
+std::vector<std::pair<int, Uint32>>
+ProjectDirectoryTree::fuzzyMatchIndexes( const std::string& match, const size_t& max,
+										 bool narrow ) const {
+	updateMatchMasks();
+
+	std::string pattern( fuzzyFoldPattern( match ) );
+	const Uint64 patternMask = fuzzyStringMask( pattern );
+
+	// A file that matches a pattern also matches all its prefixes, so the matches of the longest
+	// previous pattern that is a prefix of the new one are the only possible candidates.
+	const std::vector<Uint32>* candidates = nullptr;
+	if ( narrow ) {
+		while ( !mFuzzyMatchSteps.empty() &&
+				!String::startsWith( pattern, mFuzzyMatchSteps.back().pattern ) )
+			mFuzzyMatchSteps.pop_back();
+		if ( !mFuzzyMatchSteps.empty() )
+			candidates = &mFuzzyMatchSteps.back().matches;
+	}
+	const Int64 count = candidates ? candidates->size() : mFiles.size();
+
+	struct Shard {
+		Int64 begin;
+		std::vector<Uint32> matches;
+		std::vector<std::pair<int, Uint32>> best;
+	};
+	std::vector<Shard> shards;
+	Mutex shardsMutex;
+
+	mPool->parallelFor(
+		0, count,
+		[&]( Int64 begin, Int64 end ) {
+			Shard shard;
+			shard.begin = begin;
+			// Bounded heap with the worst of the best matches at the top.
+			auto& best = shard.best;
+			for ( Int64 i = begin; i < end; i++ ) {
+				Uint32 index = candidates ? ( *candidates )[i] : static_cast<Uint32>( i );
+				if ( ( mPathMasks[index] & patternMask ) != patternMask )
+					continue;
+				int score = String::fuzzyMatch( mFiles[index], match );
+				if ( score == std::numeric_limits<int>::min() )
+					continue;
+				if ( ( mNameMasks[index] & patternMask ) == patternMask )
+					score = std::max( score, String::fuzzyMatch( mNames[index], match ) );
+				if ( narrow )
+					shard.matches.push_back( index );
+				std::pair<int, Uint32> res( score, index );
+				if ( best.size() < max ) {
+					best.push_back( res );
+					std::push_heap( best.begin(), best.end(), fuzzyBetterMatch );
+				} else if ( max > 0 && fuzzyBetterMatch( res, best.front() ) ) {
+					std::pop_heap( best.begin(), best.end(), fuzzyBetterMatch );
+					best.back() = res;
+					std::push_heap( best.begin(), best.end(), fuzzyBetterMatch );
+				}
+			}
+			Lock l( shardsMutex );
+			shards.emplace_back( std::move( shard ) );
+		},
+		FUZZY_MATCH_GRAIN_SIZE );
+
+	std::sort( shards.begin(), shards.end(),
+			   []( const Shard& a, const Shard& b ) { return a.begin < b.begin; } );
+
+	std::vector<std::pair<int, Uint32>> results;
+	for ( auto& shard : shards )
+		results.insert( results.end(), shard.best.begin(), shard.best.end() );
+	std::sort( results.begin(), results.end(), fuzzyBetterMatch );
+	if ( results.size() > max )
+		results.resize( max );
+
+	if ( narrow && !pattern.empty() ) {
+		FuzzyMatchStep step;
+		step.pattern = std::move( pattern );
+		for ( auto& shard : shards )
+			step.matches.insert( step.matches.end(), shard.matches.begin(), shard.matches.end() );
+		if ( !mFuzzyMatchSteps.empty() && mFuzzyMatchSteps.back().pattern == step.pattern )
+			mFuzzyMatchSteps.pop_back();
+		if ( mFuzzyMatchSteps.size() >= FUZZY_MATCH_MAX_STEPS )
+			mFuzzyMatchSteps.erase( mFuzzyMatchSteps.begin() );
+		mFuzzyMatchSteps.emplace_back( std::move( step ) );
+	}
+
+	return results;
+}
+
+std::shared_ptr<FileListModel> ProjectDirectoryTree::fuzzyMatchModel(
+	const std::vector<std::pair<int, Uint32>>& matches ) const {
+	std::vector<std::string> files;
+	std::vector<std::string> names;
+	files.reserve( matches.size() );
+	names.reserve( matches.size() );
+	for ( const auto& match : matches ) {
+		names.emplace_back( mNames[match.second] );
+		files.emplace_back( mFiles[match.second] );
+	}
+	return std::make_shared<FileListModel>( files, names );
+}
+
 std::shared_ptr<FileListModel>
 ProjectDirectoryTree::fuzzyMatchTree( const std::vector<std::string>& matches,
 									  const size_t& max ) const {
 	Lock rl( mMatchingMutex );
-	std::multimap<int, int, std::greater<int>> matchesMap;
-	std::vector<std::string> files;
-	std::vector<std::string> names;
+	Lock l( mFilesMutex );
+	std::vector<std::pair<int, Uint32>> results;
 	for ( const auto& match : matches ) {
-		for ( size_t i = 0; i < mNames.size(); i++ ) {
-			int matchName = String::fuzzyMatch( mNames[i], match );
-			int matchPath = String::fuzzyMatch( mFiles[i], match );
-			matchesMap.insert( { std::max( matchName, matchPath ), i } );
-		}
+		auto res = fuzzyMatchIndexes( match, max, false );
+		results.insert( results.end(), res.begin(), res.end() );
 	}
-	for ( auto& res : matchesMap ) {
-		if ( names.size() < max ) {
-			names.emplace_back( mNames[res.second] );
-			files.emplace_back( mFiles[res.second] );
-		}
-	}
-	return std::make_shared<FileListModel>( files, names );
+	std::stable_sort( results.begin(), results.end(),
+					  []( const auto& a, const auto& b ) { return a.first > b.first; } );
+	if ( results.size() > max )
+		results.resize( max );
+	return fuzzyMatchModel( results );
 }
 
 std::shared_ptr<FileListModel> ProjectDirectoryTree::fuzzyMatchTree( const std::string& match,
 																	 const size_t& max ) const {
 	Lock rl( mMatchingMutex );
-	std::multimap<int, int, std::greater<int>> matchesMap;
-	std::vector<std::string> files;
-	std::vector<std::string> names;
-	for ( size_t i = 0; i < mNames.size(); i++ ) {
-		int matchName = String::fuzzyMatch( mNames[i], match );
-		int matchPath = String::fuzzyMatch( mFiles[i], match );
-		matchesMap.insert( { std::max( matchName, matchPath ), i } );
-	}
-	for ( auto& res : matchesMap ) {
-		if ( names.size() < max ) {
-			names.emplace_back( mNames[res.second] );
-			files.emplace_back( mFiles[res.second] );
-		}
-	}
-	return std::make_shared<FileListModel>( files, names );
+	Lock l( mFilesMutex );
+	return fuzzyMatchModel( fuzzyMatchIndexes( match, max, true ) );
 }
 
 std::shared_ptr<FileListModel> ProjectDirectoryTree::matchTree( const std::string& match,
@@ -156,7 +309,13 @@ std::shared_ptr<FileListModel> ProjectDirectoryTree::matchTree( const std::strin
 
 void ProjectDirectoryTree::asyncFuzzyMatchTree( const std::string& match, const size_t& max,
 												ProjectDirectoryTree::MatchResultCb res ) const {
-	mPool->run( [&, match, max, res]() { res( fuzzyMatchTree( match, max ) ); } );
+	Uint64 request = ++mFuzzyMatchRequest;
+	mPool->run( [&, match, max, res, request]() {
+		// A newer request was made while this one was queued, its result would be discarded.
+		if ( request != mFuzzyMatchRequest )
+			return;
+		res( fuzzyMatchTree( match, max ) );
+	} );
 }
 
 void ProjectDirectoryTree::asyncMatchTree( const std::string& match, const size_t& max,
@@ -326,6 +485,7 @@ void ProjectDirectoryTree::tryAddFile( const FileInfo& file ) {
 			Lock l( mFilesMutex );
 			mFiles.emplace_back( file.getFilepath() );
 			mNames.emplace_back( file.getFileName() );
+			mFilesVersion++;
 		}
 	}
 }
@@ -361,6 +521,7 @@ void ProjectDirectoryTree::addFile( const FileInfo& file ) {
 			getDirectoryFiles( mFiles, mNames, mPath, info, false, mIgnoreMatcher,
 							   mAllowedMatcher.get() );
 		}
+		mFilesVersion++;
 	} else {
 		tryAddFile( file );
 	}
@@ -368,6 +529,7 @@ void ProjectDirectoryTree::addFile( const FileInfo& file ) {
 
 void ProjectDirectoryTree::moveFile( const FileInfo& file, const std::string& oldFilename ) {
 	Lock l( mFilesMutex );
+	mFilesVersion++;
 	if ( file.isDirectory() ) {
 		std::string dir( file.getDirectoryPath() );
 		FileSystem::dirRemoveSlashAtEnd( dir );
@@ -409,6 +571,7 @@ void ProjectDirectoryTree::moveFile( const FileInfo& file, const std::string& ol
 
 void ProjectDirectoryTree::removeFile( const FileInfo& file ) {
 	Lock l( mFilesMutex );
+	mFilesVersion++;
 	std::string removedDir( file.getFilepath() );
 	FileSystem::dirAddSlashAtEnd( removedDir );
 	auto wasDirIt = std::find( mDirectories.begin(), mDirectories.end(), removedDir );
@@ -10,6 +10,7 @@
 #include <eepp/ui/models/model.hpp>
 #include <eepp/ui/uiiconthememanager.hpp>
 #include <eepp/ui/uiscenenode.hpp>
+#include <atomic>
 #include <functional>
 #include <map>
 #include <memory>
@@ -162,6 +163,22 @@ class ProjectDirectoryTree {
 	mutable Mutex mMatchingMutex;
 	IgnoreMatcherManager mIgnoreMatcher;
 	App* mApp{ nullptr };
+	/** Incremented every time the files list changes. Guarded by mFilesMutex. */
+	Uint64 mFilesVersion{ 1 };
+
+	struct FuzzyMatchStep {
+		/** Case folded pattern without spaces. */
+		std::string pattern;
+		/** Sorted indexes of the files whose path contains the pattern. */
+		std::vector<Uint32> matches;
+	};
+	/** Masks of the characters present in every file path and name. */
+	mutable std::vector<Uint64> mPathMasks;
+	mutable std::vector<Uint64> mNameMasks;
+	mutable Uint64 mMasksVersion{ 0 };
+	/** Matches of the previous patterns, every step pattern is a prefix of the next one. */
+	mutable std::vector<FuzzyMatchStep> mFuzzyMatchSteps;
+	mutable std::atomic<Uint64> mFuzzyMatchRequest{ 0 };
 
 	void getDirectoryFiles( std::vector<std::string>& files, std::vector<std::string>& names,
 							std::string directory, std::set<std::string> currentDirs,
@@ -180,6 +197,16 @@ class ProjectDirectoryTree {
 
 	size_t findFileIndex( const std::string& path );
 
+	void updateMatchMasks() const;
+
+	/** @return The best max files matching the pattern as pairs of score and file index, sorted
+	 * by score. If narrow is true the matches of the previous patterns are reused. */
+	std::vector<std::pair<int, Uint32>> fuzzyMatchIndexes( const std::string& match,
+														   const size_t& max, bool narrow ) const;
+
+	std::shared_ptr<FileListModel>
+	fuzzyMatchModel( const std::vector<std::pair<int, Uint32>>& matches ) const;
+
 	PluginRequestHandle processMessage( const PluginMessage& msg );
 };
 
@@ -1,79 +1,206 @@
 #include "projectsearch.hpp"
+#include <algorithm>
+#include <cstring>
+#include <eepp/system/clock.hpp>
 #include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
 #include <eepp/system/luapattern.hpp>
 
+#if defined( __SSE2__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define ECODE_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
 namespace ecode {
 
-static int countNewLines( const std::string& text, const size_t& start, const size_t& end ) {
-	const char* startPtr = text.c_str() + start;
-	const char* endPtr = text.c_str() + end;
-	size_t count = 0;
-	if ( startPtr != endPtr ) {
-		count = *startPtr == '\n' ? 1 : 0;
-		while ( ++startPtr && startPtr != endPtr ) {
-			if ( '\n' == *startPtr )
-				count++;
-		};
+// Same heuristic used by git: a file containing a NUL byte in its first 8000 bytes is binary.
+static constexpr size_t BINARY_SNIFF_LENGTH = 8000;
+
+// Minimum time between result batches reported while the search is running.
+static constexpr Int64 BATCH_INTERVAL_MS = 100;
+
+static bool isBinaryData( const char* data, const size_t& size ) {
+	return std::memchr( data, '\0', eemin( size, BINARY_SNIFF_LENGTH ) ) != nullptr;
+}
+
+static inline unsigned char foldCase( const unsigned char& c ) {
+	return c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c;
+}
+
+static inline bool isAlphaNum( const char& c ) {
+	return std::isalnum( static_cast<unsigned char>( c ) );
+}
+
+static bool isWholeWord( const char* data, const size_t& size, const size_t& pos,
+						 const size_t& len ) {
+	return ( 0 == pos || !isAlphaNum( data[pos - 1] ) ) &&
+		   ( pos + len >= size || !isAlphaNum( data[pos + len] ) );
+}
+
+/** @return The first byte equal to a or b in [begin, end), nullptr if none. */
+static const char* findFirstOf( const char* begin, const char* end, const char& a,
+								const char& b ) {
+	if ( a == b )
+		return (const char*)std::memchr( begin, a, end - begin );
+#ifdef ECODE_SEARCH_SSE2
+	const __m128i va = _mm_set1_epi8( a );
+	const __m128i vb = _mm_set1_epi8( b );
+	while ( end - begin >= 16 ) {
+		__m128i chunk = _mm_loadu_si128( (const __m128i*)begin );
+		int mask = _mm_movemask_epi8(
+			_mm_or_si128( _mm_cmpeq_epi8( chunk, va ), _mm_cmpeq_epi8( chunk, vb ) ) );
+		if ( mask )
+			return begin + __builtin_ctz( mask );
+		begin += 16;
+	}
+#endif
+	for ( ; begin < end; ++begin ) {
+		if ( *begin == a || *begin == b )
+			return begin;
+	}
+	return nullptr;
+}
+
+/** Plain text searcher used by the global search. Candidates are found scanning for the first
+ * byte of the needle ( memchr or SSE2 for both cases of the byte ) and then verified, if the
+ * candidates are too frequent the searcher switches to Boyer-Moore-Horspool for the rest of the
+ * file. Case insensitive search folds the bytes while comparing, the file content is never
+ * copied. */
+class TextSearcher {
+  public:
+	TextSearcher( const std::string& needle, bool caseSensitive ) :
+		mNeedle( needle ), mCaseSensitive( caseSensitive ) {
+		if ( !mCaseSensitive )
+			String::toLowerInPlace( mNeedle );
+		mOcc = String::BMH::createOccTable( (const unsigned char*)mNeedle.c_str(),
+											mNeedle.size() );
+		mFirst = mNeedle.empty() ? '\0' : mNeedle[0];
+		mFirstAlt = mCaseSensitive || mFirst < 'a' || mFirst > 'z' ? mFirst
+																	 : mFirst - ( 'a' - 'A' );
+	}
+
+	const std::string& getNeedle() const { return mNeedle; }
+
+	struct State {
+		size_t misses{ 0 };
+		bool useHorspool{ false };
+	};
+
+	/** @return The position of the next match starting at from, size if not found. */
+	size_t find( const char* data, const size_t& size, size_t from, State& state ) const {
+		const size_t len = mNeedle.size();
+		if ( len == 0 || len > size )
+			return size;
+		const char* last = data + size - len + 1;
+		while ( !state.useHorspool && data + from < last ) {
+			const char* cand = findFirstOf( data + from, last, mFirst, mFirstAlt );
+			if ( cand == nullptr )
+				return size;
+			size_t pos = cand - data;
+			if ( equals( cand + 1, mNeedle.c_str() + 1, len - 1 ) )
+				return pos;
+			from = pos + 1;
+			// Too many false candidates, the first byte is too common in this file.
+			if ( ++state.misses > 64 && state.misses * 32 > from )
+				state.useHorspool = true;
+		}
+		if ( data + from >= last )
+			return size;
+		return from + ( mCaseSensitive ? String::BMH::search( (const unsigned char*)data + from,
+															  size - from,
+															  (const unsigned char*)mNeedle.c_str(),
+															  len, mOcc )
+									   : horspoolFolded( (const unsigned char*)data + from,
+														 size - from ) );
+	}
+
+  protected:
+	std::string mNeedle;
+	String::BMH::OccTable mOcc;
+	bool mCaseSensitive;
+	char mFirst;
+	char mFirstAlt;
+
+	bool equals( const char* text, const char* needle, const size_t& len ) const {
+		if ( mCaseSensitive )
+			return std::memcmp( text, needle, len ) == 0;
+		for ( size_t i = 0; i < len; i++ ) {
+			if ( foldCase( text[i] ) != static_cast<unsigned char>( needle[i] ) )
+				return false;
+		}
+		return true;
+	}
+
+	/** Horspool over the case folded haystack, the occurrence table is built from the folded
+	 * needle so it's indexed with the folded byte. @return size if not found. */
+	size_t horspoolFolded( const unsigned char* haystack, const size_t& size ) const {
+		const size_t len = mNeedle.size();
+		const size_t lenMinus1 = len - 1;
+		const unsigned char lastChar = mNeedle[lenMinus1];
+		size_t pos = 0;
+		while ( pos <= size - len ) {
+			const unsigned char occChar = foldCase( haystack[pos + lenMinus1] );
+			if ( lastChar == occChar &&
+				 equals( (const char*)haystack + pos, mNeedle.c_str(), lenMinus1 ) )
+				return pos;
+			pos += mOcc[occChar];
+		}
+		return size;
 	}
-	return count;
+};
+
+static size_t countNewLines( const char* data, const size_t& start, const size_t& end ) {
+	return std::count( data + start, data + end, '\n' );
 }
 
-static String textLine( const std::string& fileText, const size_t& fromPos, size_t& relCol ) {
-	const char* stringStartPtr = fileText.c_str();
-	const char* startPtr = fileText.c_str() + fromPos;
-	const char* endPtr = startPtr;
+static String textLine( const char* data, const size_t& size, const size_t& fromPos,
+						size_t& relCol ) {
+	const char* startPtr = data + fromPos;
 	const char* nlStartPtr = startPtr;
-	while ( nlStartPtr != stringStartPtr && *nlStartPtr != '\n' )
+	while ( nlStartPtr != data && *( nlStartPtr - 1 ) != '\n' )
 		--nlStartPtr;
-	if ( *nlStartPtr == '\n' )
-		nlStartPtr++;
-	while ( ++endPtr && *endPtr != '\0' && *endPtr != '\n' ) {
-	}
-	relCol =
-		String::utf8Length( fileText.substr( nlStartPtr - stringStartPtr, startPtr - nlStartPtr ) );
+	const char* endPtr = (const char*)std::memchr( startPtr, '\n', size - fromPos );
+	if ( endPtr == nullptr )
+		endPtr = data + size;
+	relCol = String::utf8Length( std::string( nlStartPtr, startPtr - nlStartPtr ) );
 	// if the line to substract is massive we only get the fist kilobyte of that line, since the
 	// line is only shared for visual aid.
-	return fileText.substr( nlStartPtr - stringStartPtr,
-							endPtr - nlStartPtr > EE_1KB ? EE_1KB : endPtr - nlStartPtr );
+	return std::string( nlStartPtr, endPtr - nlStartPtr > EE_1KB ? EE_1KB : endPtr - nlStartPtr );
 }
 
 static std::vector<ProjectSearch::ResultData::Result>
-searchInFileHorspool( const std::string& file, const std::string& text, const bool& caseSensitive,
-					  const bool& wholeWord, const String::BMH::OccTable& occ ) {
+searchInFileHorspool( const std::string& file, const TextSearcher& searcher,
+					  const bool& wholeWord ) {
 	std::vector<ProjectSearch::ResultData::Result> res;
-	std::string fileText;
-	Int64 lSearchRes = 0;
-	Int64 searchRes = 0;
-	size_t totNl = 0;
-	FileSystem::fileGet( file, fileText );
-	std::string fileTextOriginal;
+	IOStreamMappedFile stream( file );
+	const char* data = stream.getData();
+	const size_t size = stream.getSize();
+	if ( data == nullptr || size == 0 || isBinaryData( data, size ) )
+		return res;
 
-	if ( !caseSensitive ) {
-		fileTextOriginal = fileText;
-		String::toLowerInPlace( fileText );
-	}
+	const std::string& text = searcher.getNeedle();
+	const Int64 textLen = String::utf8Length( text );
+	TextSearcher::State state;
+	size_t lSearchRes = 0;
+	size_t searchRes = 0;
+	size_t totNl = 0;
 
-	do {
-		searchRes = String::BMH::find( fileText, text, searchRes, occ );
-		if ( searchRes != -1 ) {
-			if ( wholeWord && !String::isWholeWord( fileText, text, searchRes ) ) {
-				lSearchRes = searchRes;
-				searchRes += text.size();
-				continue;
-			}
-			size_t relCol;
-			totNl += countNewLines( fileText, lSearchRes, searchRes );
-			String str(
-				textLine( caseSensitive ? fileText : fileTextOriginal, searchRes, relCol ) );
-			res.push_back( { str,
-							 { { (Int64)totNl, (Int64)relCol },
-							   { (Int64)totNl, (Int64)( relCol + String::utf8Length( text ) ) } },
-							 searchRes,
-							 static_cast<Int64>( searchRes + text.size() ) } );
-			lSearchRes = searchRes;
+	while ( ( searchRes = searcher.find( data, size, searchRes, state ) ) != size ) {
+		if ( wholeWord && !isWholeWord( data, size, searchRes, text.size() ) ) {
 			searchRes += text.size();
+			continue;
 		}
-	} while ( searchRes != -1 );
+		size_t relCol;
+		totNl += countNewLines( data, lSearchRes, searchRes );
+		String str( textLine( data, size, searchRes, relCol ) );
+		res.push_back(
+			{ str,
+			  { { (Int64)totNl, (Int64)relCol }, { (Int64)totNl, (Int64)relCol + textLen } },
+			  (Int64)searchRes,
+			  static_cast<Int64>( searchRes + text.size() ) } );
+		lSearchRes = searchRes;
+		searchRes += text.size();
+	}
 
 	return res;
 }
@@ -81,59 +208,67 @@ searchInFileHorspool( const std::string& file, const std::string& text, const bo
 static std::vector<ProjectSearch::ResultData::Result>
 searchInFileLuaPattern( const std::string& file, const std::string& text, const bool& caseSensitive,
 						const bool& wholeWord ) {
-	std::string fileText;
-	FileSystem::fileGet( file, fileText );
-	LuaPattern pattern( text );
 	std::vector<ProjectSearch::ResultData::Result> res;
-	size_t totNl = 0;
-	bool matched = false;
-	Int64 searchRes = 0;
-	std::string fileTextOriginal;
+	IOStreamMappedFile stream( file );
+	const char* data = stream.getData();
+	const size_t size = stream.getSize();
+	if ( data == nullptr || size == 0 || isBinaryData( data, size ) )
+		return res;
 
+	// Patterns can't be matched case insensitively, so only here the content is folded.
+	std::string folded;
+	const char* searchData = data;
 	if ( !caseSensitive ) {
-		fileTextOriginal = fileText;
-		String::toLowerInPlace( fileText );
+		folded.assign( data, size );
+		String::toLowerInPlace( folded );
+		searchData = folded.c_str();
 	}
 
-	do {
-		int start, end = 0;
-		if ( ( matched = pattern.find( fileText, start, end, searchRes ) ) ) {
-			if ( wholeWord &&
-				 !String::isWholeWord( fileText, fileText.substr( start, end - start ), start ) ) {
-				searchRes = end;
-				continue;
-			}
-			size_t relCol;
-			totNl += countNewLines( fileText, searchRes, start );
-			String str( textLine( caseSensitive ? fileText : fileTextOriginal, start, relCol ) );
-			int len = end - start;
-			res.push_back(
-				{ str,
-				  { { (Int64)totNl, (Int64)relCol }, { (Int64)totNl, (Int64)( relCol + len ) } },
-				  start,
-				  end } );
-			searchRes = end;
+	LuaPattern pattern( text );
+	size_t totNl = 0;
+	int lSearchRes = 0;
+	int searchRes = 0;
+	int start, end;
+
+	while ( searchRes < (int)size &&
+			pattern.find( searchData, start, end, searchRes, (int)size ) ) {
+		if ( end <= start ) {
+			// Empty match, skip it to avoid matching the same position forever.
+			searchRes = end + 1;
+			continue;
 		}
-	} while ( matched );
+		searchRes = end;
+		if ( wholeWord && !isWholeWord( searchData, size, start, end - start ) )
+			continue;
+		size_t relCol;
+		totNl += countNewLines( searchData, lSearchRes, start );
+		lSearchRes = start;
+		String str( textLine( data, size, start, relCol ) );
+		Int64 len = String::utf8Length( std::string( data + start, end - start ) );
+		res.push_back(
+			{ str,
+			  { { (Int64)totNl, (Int64)relCol }, { (Int64)totNl, (Int64)relCol + len } },
+			  start,
+			  end } );
+	}
 
 	return res;
 }
 
 void ProjectSearch::find( const std::vector<std::string> files, const std::string& string,
 						  ResultCb result, bool caseSensitive, bool wholeWord,
-						  const TextDocument::FindReplaceType& type ) {
+						  const TextDocument::FindReplaceType& type, ResultCb batchResult ) {
 	Result res;
-	const auto occ =
-		type == TextDocument::FindReplaceType::Normal
-			? String::BMH::createOccTable( (const unsigned char*)string.c_str(), string.size() )
-			: std::vector<size_t>();
+	const TextSearcher searcher( string, caseSensitive );
 	for ( auto& file : files ) {
 		auto fileRes = type == TextDocument::FindReplaceType::Normal
-						   ? searchInFileHorspool( file, string, caseSensitive, wholeWord, occ )
+						   ? searchInFileHorspool( file, searcher, wholeWord )
 						   : searchInFileLuaPattern( file, string, caseSensitive, wholeWord );
 		if ( !fileRes.empty() )
 			res.push_back( { file, fileRes } );
 	}
+	if ( batchResult && !res.empty() )
+		batchResult( res );
 	result( res );
 }
 
@@ -142,34 +277,51 @@ struct FindData {
 	Mutex countMutex;
 	int resCount{ 0 };
 	ProjectSearch::Result res;
+	/** Results found since the last batch was reported. */
+	ProjectSearch::Result batch;
+	Clock batchClock;
+	bool batchReported{ false };
 };
 
 void ProjectSearch::find( const std::vector<std::string> files, std::string string,
 						  std::shared_ptr<ThreadPool> pool, ResultCb result, bool caseSensitive,
-						  bool wholeWord, const TextDocument::FindReplaceType& type ) {
-	if ( files.empty() )
+						  bool wholeWord, const TextDocument::FindReplaceType& type,
+						  ResultCb batchResult ) {
+	if ( files.empty() ) {
 		result( {} );
+		return;
+	}
 	FindData* findData = eeNew( FindData, () );
 	findData->resCount = files.size();
-	if ( !caseSensitive )
+	if ( !caseSensitive && type != TextDocument::FindReplaceType::Normal )
 		String::toLowerInPlace( string );
-	const auto occ =
-		type == TextDocument::FindReplaceType::Normal
-			? String::BMH::createOccTable( (const unsigned char*)string.c_str(), string.size() )
-			: std::vector<size_t>();
+	auto searcher = std::make_shared<TextSearcher>( string, caseSensitive );
 	for ( auto& file : files ) {
 		pool->run(
-			[findData, file, string, caseSensitive, wholeWord, occ, type] {
-				auto fileRes =
-					type == TextDocument::FindReplaceType::Normal
-						? searchInFileHorspool( file, string, caseSensitive, wholeWord, occ )
-						: searchInFileLuaPattern( file, string, caseSensitive, wholeWord );
+			[findData, file, string, caseSensitive, wholeWord, searcher, type, batchResult] {
+				auto fileRes = type == TextDocument::FindReplaceType::Normal
+								   ? searchInFileHorspool( file, *searcher, wholeWord )
+								   : searchInFileLuaPattern( file, string, caseSensitive,
+															 wholeWord );
 				if ( !fileRes.empty() ) {
 					Lock l( findData->resMutex );
 					findData->res.push_back( { file, fileRes } );
+					if ( batchResult ) {
+						findData->batch.push_back( findData->res.back() );
+						// The first result is reported as soon as it's found, then results are
+						// grouped to avoid flooding the UI thread.
+						if ( !findData->batchReported ||
+							 findData->batchClock.getElapsedTime().asMilliseconds() >=
+								 BATCH_INTERVAL_MS ) {
+							batchResult( findData->batch );
+							findData->batch.clear();
+							findData->batchClock.restart();
+							findData->batchReported = true;
+						}
+					}
 				}
 			},
-			[result, findData]( const auto& ) {
+			[result, findData, batchResult]( const auto& ) {
 				int count;
 				{
 					Lock l( findData->countMutex );
@@ -177,6 +329,8 @@ void ProjectSearch::find( const std::vector<std::string> files, std::string stri
 					count = findData->resCount;
 				}
 				if ( count == 0 ) {
+					if ( batchResult && !findData->batch.empty() )
+						batchResult( findData->batch );
 					result( findData->res );
 					eeDelete( findData );
 				}
@@ -192,4 +346,11 @@ void ProjectSearch::ResultModel::removeLastNewLineCharacter() {
 	}
 }
 
+void ProjectSearch::ResultModel::appendResult( const Result& result ) {
+	if ( result.empty() )
+		return;
+	mResult.insert( mResult.end(), result.begin(), result.end() );
+	onModelUpdate();
+}
+
 } // namespace ecode
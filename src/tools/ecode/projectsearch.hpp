@@ -188,6 +188,9 @@ class ProjectSearch {
 
 		void removeLastNewLineCharacter();
 
+		/** Appends the results of more files to the model, used while the search is running. */
+		void appendResult( const Result& result );
+
 		void setResultFromSymbolReference( bool ref ) { mResultFromSymbolReference = ref; }
 
 		bool isResultFromSymbolReference() const { return mResultFromSymbolReference; }
@@ -204,13 +207,19 @@ class ProjectSearch {
 	static void
 	find( const std::vector<std::string> files, const std::string& string, ResultCb result,
 		  bool caseSensitive, bool wholeWord = false,
-		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal );
+		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal,
+		  ResultCb batchResult = nullptr );
 
+	/** Searches the files in the thread pool. result is called with all the results once every
+	 * file has been searched. If batchResult is set, it's called from the worker threads with
+	 * the new results while the search is running, the first match is reported as soon as it's
+	 * found. Binary files are skipped. */
 	static void
 	find( const std::vector<std::string> files, std::string string,
 		  std::shared_ptr<ThreadPool> pool, ResultCb result, bool caseSensitive,
 		  bool wholeWord = false,
-		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal );
+		  const TextDocument::FindReplaceType& type = TextDocument::FindReplaceType::Normal,
+		  ResultCb batchResult = nullptr );
 };
 
 } // namespace ecode
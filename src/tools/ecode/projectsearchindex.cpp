@@ -0,0 +1,468 @@
+#include "projectsearchindex.hpp"
+#include <algorithm>
+#include <cstring>
+#include <eepp/system/clock.hpp>
+#include <eepp/system/fileinfo.hpp>
+#include <eepp/system/filesystem.hpp>
+#include <eepp/system/iostreammappedfile.hpp>
+#include <eepp/system/log.hpp>
+#include <limits>
+#include <unordered_set>
+
+namespace ecode {
+
+static constexpr char INDEX_MAGIC[4] = { 'E', 'T', 'R', 'I' };
+
+static constexpr Uint32 INDEX_VERSION = 2;
+
+static constexpr size_t TRIGRAMS_COUNT = 1 << 24;
+
+// Same heuristic used by the project search to skip binary files.
+static constexpr size_t BINARY_SNIFF_LENGTH = 8000;
+
+static constexpr Uint32 INVALID_ID = std::numeric_limits<Uint32>::max();
+
+// The index of a closed project is saved in background, it can still be writing the file while
+// the same project is opened again and its index loaded.
+static Mutex INDEX_FILE_MUTEX;
+
+static inline Uint32 foldCase( const char& ch ) {
+	unsigned char c = static_cast<unsigned char>( ch );
+	return c >= 'A' && c <= 'Z' ? c + ( 'a' - 'A' ) : c;
+}
+
+/** Collects the unique case folded trigrams of data ( unsorted ). */
+static void collectTrigrams( const char* data, const size_t& size, std::vector<Uint32>& trigrams ) {
+	// One bit per possible trigram, reused between calls and cleared using the found trigrams.
+	thread_local std::vector<Uint64> seen( TRIGRAMS_COUNT / 64, 0 );
+	trigrams.clear();
+	if ( size < 3 )
+		return;
+	Uint32 trigram = ( foldCase( data[0] ) << 8 ) | foldCase( data[1] );
+	for ( size_t i = 2; i < size; i++ ) {
+		trigram = ( ( trigram << 8 ) | foldCase( data[i] ) ) & ( TRIGRAMS_COUNT - 1 );
+		Uint64& word = seen[trigram >> 6];
+		Uint64 bit = Uint64( 1 ) << ( trigram & 63 );
+		if ( !( word & bit ) ) {
+			word |= bit;
+			trigrams.push_back( trigram );
+		}
+	}
+	for ( const auto& trigram : trigrams )
+		seen[trigram >> 6] = 0;
+}
+
+static inline void writeVarint( std::vector<Uint8>& buffer, Uint32 value ) {
+	while ( value >= 0x80 ) {
+		buffer.push_back( static_cast<Uint8>( value | 0x80 ) );
+		value >>= 7;
+	}
+	buffer.push_back( static_cast<Uint8>( value ) );
+}
+
+/** Reads a varint from [ptr, end), returns false if it's truncated or too long. */
+static inline bool readVarint( const Uint8*& ptr, const Uint8* end, Uint32& value ) {
+	value = 0;
+	for ( Uint32 shift = 0; shift < 35 && ptr < end; shift += 7 ) {
+		Uint8 byte = *ptr++;
+		value |= static_cast<Uint32>( byte & 0x7F ) << shift;
+		if ( !( byte & 0x80 ) )
+			return true;
+	}
+	return false;
+}
+
+template <typename T> static void writePod( std::string& buffer, const T& value ) {
+	buffer.append( reinterpret_cast<const char*>( &value ), sizeof( T ) );
+}
+
+struct IndexReader {
+	const char* ptr;
+	const char* end;
+	bool ok{ true };
+
+	template <typename T> T read() {
+		T value{};
+		if ( !ok || end - ptr < (ptrdiff_t)sizeof( T ) ) {
+			ok = false;
+			return value;
+		}
+		std::memcpy( &value, ptr, sizeof( T ) );
+		ptr += sizeof( T );
+		return value;
+	}
+
+	std::string readString( const Uint32& length ) {
+		if ( !ok || end - ptr < (ptrdiff_t)length ) {
+			ok = false;
+			return {};
+		}
+		std::string value( ptr, length );
+		ptr += length;
+		return value;
+	}
+};
+
+void ProjectSearchIndex::PostingList::push_back( const Uint32& id ) {
+	writeVarint( data, count == 0 ? id : id - last );
+	last = id;
+	count++;
+}
+
+void ProjectSearchIndex::PostingList::decode( std::vector<Uint32>& ids ) const {
+	ids.resize( count );
+	const Uint8* ptr = data.data();
+	const Uint8* end = ptr + data.size();
+	Uint32 id = 0;
+	for ( Uint32 i = 0; i < count; i++ ) {
+		Uint32 delta = 0;
+		readVarint( ptr, end, delta );
+		id += delta;
+		ids[i] = id;
+	}
+}
+
+std::shared_ptr<ProjectSearchIndex> ProjectSearchIndex::New( const std::string& indexPath,
+															 std::shared_ptr<ThreadPool> pool ) {
+	return std::make_shared<ProjectSearchIndex>( indexPath, pool );
+}
+
+ProjectSearchIndex::ProjectSearchIndex( const std::string& indexPath,
+										std::shared_ptr<ThreadPool> pool ) :
+	mIndexPath( indexPath ), mPool( pool ) {}
+
+void ProjectSearchIndex::build( const std::vector<std::string>& files ) {
+	std::weak_ptr<ProjectSearchIndex> weak = shared_from_this();
+	mPool->run(
+		[weak, files] {
+			auto index = weak.lock();
+			if ( !index )
+				return;
+			Clock clock;
+			index->load();
+
+			{
+				// Forget the files that are not part of the project anymore.
+				std::unordered_set<std::string> projectFiles( files.begin(), files.end() );
+				Lock l( index->mMutex );
+				for ( auto& entry : index->mEntries ) {
+					if ( entry.alive && projectFiles.find( entry.path ) == projectFiles.end() )
+						index->removeFileId( entry.path );
+				}
+			}
+
+			std::atomic<size_t> indexed{ 0 };
+			index->mPool->parallelFor(
+				0, files.size(),
+				[&]( Int64 begin, Int64 end ) {
+					for ( Int64 i = begin; i < end && !index->mCancelled; i++ ) {
+						FileInfo file( files[i] );
+						{
+							Lock l( index->mMutex );
+							auto it = index->mFileIds.find( files[i] );
+							if ( it != index->mFileIds.end() ) {
+								const auto& entry = index->mEntries[it->second];
+								if ( entry.modificationTime == file.getModificationTime() &&
+									 entry.size == file.getSize() )
+									continue;
+							}
+						}
+						index->indexFile( files[i] );
+						indexed++;
+					}
+				},
+				64, ThreadPool::Priority::Background );
+
+			if ( index->mCancelled )
+				return;
+
+			index->mReady = true;
+			Log::info( "Project search index built in %.2fms. Indexed %zu of %zu files.",
+					   clock.getElapsedTime().asMilliseconds(), indexed.load(), files.size() );
+			index->save();
+		},
+		ThreadPool::Priority::Background );
+}
+
+void ProjectSearchIndex::cancel() {
+	mCancelled = true;
+}
+
+bool ProjectSearchIndex::isReady() const {
+	return mReady;
+}
+
+bool ProjectSearchIndex::filter( const std::vector<std::string>& files, const std::string& text,
+								 std::vector<std::string>& candidates ) const {
+	if ( !mReady || text.size() < 3 )
+		return false;
+
+	std::vector<Uint32> trigrams;
+	collectTrigrams( text.c_str(), text.size(), trigrams );
+
+	Lock l( mMutex );
+	std::vector<const PostingList*> lists;
+	for ( const auto& trigram : trigrams ) {
+		auto it = mPostings.find( trigram );
+		if ( it == mPostings.end() ) {
+			lists.clear();
+			break;
+		}
+		lists.push_back( &it->second );
+	}
+
+	// Intersect starting from the shortest lists.
+	std::vector<Uint32> ids;
+	if ( !lists.empty() ) {
+		std::sort( lists.begin(), lists.end(),
+				   []( const auto* a, const auto* b ) { return a->count < b->count; } );
+		lists.front()->decode( ids );
+		std::vector<Uint32> list;
+		std::vector<Uint32> tmp;
+		for ( size_t i = 1; i < lists.size() && !ids.empty(); i++ ) {
+			lists[i]->decode( list );
+			tmp.clear();
+			std::set_intersection( ids.begin(), ids.end(), list.begin(), list.end(),
+								   std::back_inserter( tmp ) );
+			ids.swap( tmp );
+		}
+	}
+
+	std::vector<bool> matches( mEntries.size(), false );
+	for ( const auto& id : ids )
+		matches[id] = true;
+
+	candidates.clear();
+	for ( const auto& file : files ) {
+		auto it = mFileIds.find( file );
+		if ( it == mFileIds.end() || !mEntries[it->second].indexed || matches[it->second] ||
+			 mDirty.find( file ) != mDirty.end() )
+			candidates.push_back( file );
+	}
+	return true;
+}
+
+void ProjectSearchIndex::fileChanged( const std::string& path ) {
+	{
+		Lock l( mMutex );
+		mDirty[path]++;
+	}
+	std::weak_ptr<ProjectSearchIndex> weak = shared_from_this();
+	mPool->run(
+		[weak, path] {
+			auto index = weak.lock();
+			if ( !index )
+				return;
+			index->indexFile( path );
+			Lock l( index->mMutex );
+			auto it = index->mDirty.find( path );
+			if ( it != index->mDirty.end() && --it->second == 0 )
+				index->mDirty.erase( it );
+		},
+		ThreadPool::Priority::Background );
+}
+
+void ProjectSearchIndex::fileRemoved( const std::string& path ) {
+	Lock l( mMutex );
+	removeFileId( path );
+}
+
+bool ProjectSearchIndex::save() {
+	std::string buffer;
+	{
+		Lock l( mMutex );
+		if ( !mModified )
+			return true;
+		compact();
+		mModified = false;
+		buffer.append( INDEX_MAGIC, sizeof( INDEX_MAGIC ) );
+		writePod( buffer, INDEX_VERSION );
+		writePod( buffer, (Uint32)mEntries.size() );
+		for ( const auto& entry : mEntries ) {
+			writePod( buffer, (Uint32)entry.path.size() );
+			buffer.append( entry.path );
+			writePod( buffer, entry.modificationTime );
+			writePod( buffer, entry.size );
+			writePod( buffer, (Uint8)entry.indexed );
+		}
+		writePod( buffer, (Uint32)mPostings.size() );
+		for ( const auto& posting : mPostings ) {
+			writePod( buffer, posting.first );
+			writePod( buffer, posting.second.count );
+			writePod( buffer, (Uint32)posting.second.data.size() );
+			buffer.append( reinterpret_cast<const char*>( posting.second.data.data() ),
+						   posting.second.data.size() );
+		}
+	}
+	Lock l( INDEX_FILE_MUTEX );
+	return FileSystem::fileWrite( mIndexPath, buffer );
+}
+
+void ProjectSearchIndex::addFile( FileEntry&& entry, const std::vector<Uint32>& trigrams ) {
+	Lock l( mMutex );
+	removeFileId( entry.path );
+	Uint32 id = static_cast<Uint32>( mEntries.size() );
+	mFileIds[entry.path] = id;
+	mEntries.emplace_back( std::move( entry ) );
+	// Ids only grow, so the postings lists stay sorted.
+	for ( const auto& trigram : trigrams )
+		mPostings[trigram].push_back( id );
+	mModified = true;
+	if ( mDeadCount > 1024 && mDeadCount > mEntries.size() / 2 )
+		compact();
+}
+
+void ProjectSearchIndex::removeFileId( const std::string& path ) {
+	auto it = mFileIds.find( path );
+	if ( it == mFileIds.end() )
+		return;
+	mEntries[it->second].alive = false;
+	mFileIds.erase( it );
+	mDeadCount++;
+	mModified = true;
+}
+
+void ProjectSearchIndex::compact() {
+	if ( mDeadCount == 0 )
+		return;
+	std::vector<Uint32> remap( mEntries.size(), INVALID_ID );
+	std::vector<FileEntry> entries;
+	entries.reserve( mEntries.size() - mDeadCount );
+	for ( size_t i = 0; i < mEntries.size(); i++ ) {
+		if ( mEntries[i].alive ) {
+			remap[i] = static_cast<Uint32>( entries.size() );
+			entries.emplace_back( std::move( mEntries[i] ) );
+		}
+	}
+	mEntries = std::move( entries );
+	mFileIds.clear();
+	for ( size_t i = 0; i < mEntries.size(); i++ )
+		mFileIds[mEntries[i].path] = static_cast<Uint32>( i );
+	std::vector<Uint32> ids;
+	for ( auto it = mPostings.begin(); it != mPostings.end(); ) {
+		it->second.decode( ids );
+		PostingList list;
+		// Remapping keeps the order, the ids are still sorted.
+		for ( const auto& id : ids ) {
+			if ( remap[id] != INVALID_ID )
+				list.push_back( remap[id] );
+		}
+		if ( list.count == 0 ) {
+			it = mPostings.erase( it );
+		} else {
+			list.data.shrink_to_fit();
+			it->second = std::move( list );
+			++it;
+		}
+	}
+	mDeadCount = 0;
+}
+
+bool ProjectSearchIndex::load() {
+	Lock fl( INDEX_FILE_MUTEX );
+	if ( !FileSystem::fileExists( mIndexPath ) )
+		return false;
+
+	IOStreamMappedFile file( mIndexPath );
+	if ( file.getData() == nullptr )
+		return false;
+
+	IndexReader reader{ file.getData(), file.getData() + file.getSize() };
+	if ( reader.readString( sizeof( INDEX_MAGIC ) ) !=
+			 std::string( INDEX_MAGIC, sizeof( INDEX_MAGIC ) ) ||
+		 reader.read<Uint32>() != INDEX_VERSION )
+		return false;
+
+	// Every entry takes at least its path length, modification time, size and indexed flag, so
+	// a corrupted count can't allocate more entries than the file could contain.
+	static constexpr size_t MinEntrySize =
+		sizeof( Uint32 ) + sizeof( Uint64 ) + sizeof( Uint64 ) + sizeof( Uint8 );
+	Uint32 entriesCount = reader.read<Uint32>();
+	if ( !reader.ok || (size_t)( reader.end - reader.ptr ) / MinEntrySize < entriesCount )
+		return false;
+
+	std::vector<FileEntry> entries( entriesCount );
+	for ( auto& entry : entries ) {
+		entry.path = reader.readString( reader.read<Uint32>() );
+		entry.modificationTime = reader.read<Uint64>();
+		entry.size = reader.read<Uint64>();
+		entry.indexed = reader.read<Uint8>() != 0;
+		if ( !reader.ok )
+			return false;
+	}
+
+	std::unordered_map<Uint32, PostingList> postings;
+	Uint32 postingsCount = reader.read<Uint32>();
+	for ( Uint32 i = 0; i < postingsCount && reader.ok; i++ ) {
+		Uint32 trigram = reader.read<Uint32>();
+		Uint32 count = reader.read<Uint32>();
+		Uint32 dataSize = reader.read<Uint32>();
+		// Every id takes at least one byte.
+		if ( !reader.ok || count > dataSize || (size_t)( reader.end - reader.ptr ) < dataSize )
+			return false;
+		const Uint8* ptr = reinterpret_cast<const Uint8*>( reader.ptr );
+		const Uint8* end = ptr + dataSize;
+		auto& list = postings[trigram];
+		list.data.assign( ptr, end );
+		reader.ptr += dataSize;
+		// Validate the ids: sorted, unique, and of an existing entry.
+		Uint32 id = 0;
+		for ( Uint32 j = 0; j < count; j++ ) {
+			Uint32 delta;
+			if ( !readVarint( ptr, end, delta ) || ( j > 0 && delta == 0 ) ||
+				 (Uint64)id + delta >= entries.size() )
+				return false;
+			id += delta;
+		}
+		if ( ptr != end )
+			return false;
+		list.count = count;
+		list.last = id;
+	}
+
+	if ( !reader.ok )
+		return false;
+
+	Lock l( mMutex );
+	mEntries = std::move( entries );
+	mPostings = std::move( postings );
+	mFileIds.clear();
+	for ( size_t i = 0; i < mEntries.size(); i++ )
+		mFileIds[mEntries[i].path] = static_cast<Uint32>( i );
+	mDeadCount = 0;
+	return true;
+}
+
+void ProjectSearchIndex::indexFile( const std::string& path ) {
+	if ( mCancelled )
+		return;
+
+	FileInfo info( path );
+	if ( !info.exists() || !info.isRegularFile() ) {
+		Lock l( mMutex );
+		removeFileId( path );
+		return;
+	}
+
+	FileEntry entry;
+	entry.path = path;
+	entry.modificationTime = info.getModificationTime();
+	entry.size = info.getSize();
+
+	std::vector<Uint32> trigrams;
+	if ( entry.size <= MaxIndexedFileSize ) {
+		IOStreamMappedFile file( path );
+		const char* data = file.getData();
+		size_t size = file.getSize();
+		if ( file.isOpen() ) {
+			entry.indexed = true;
+			// Binary files are never searched, so they don't need any trigram.
+			if ( size && !std::memchr( data, '\0', eemin( size, BINARY_SNIFF_LENGTH ) ) )
+				collectTrigrams( data, size, trigrams );
+		}
+	}
+
+	addFile( std::move( entry ), trigrams );
+}
+
+} // namespace ecode
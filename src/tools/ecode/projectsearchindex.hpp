@@ -0,0 +1,111 @@
+#ifndef ECODE_PROJECTSEARCHINDEX_HPP
+#define ECODE_PROJECTSEARCHINDEX_HPP
+
+#include <atomic>
+#include <eepp/system/mutex.hpp>
+#include <eepp/system/threadpool.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace EE;
+using namespace EE::System;
+
+namespace ecode {
+
+/** @brief Trigram index of the files of a project.
+ * Every file is split in all its ( case folded ) three bytes sequences, and every trigram keeps
+ * the sorted list of the files that contain it. A plain text search only needs to run over the
+ * files that contain every trigram of the searched text.
+ * The index is saved to disk and validated against the files modification time and size when
+ * loaded, so only the files that changed since the last session are indexed again. While the
+ * index is being built or a file is being re-indexed, the affected files are always reported as
+ * candidates, the index never hides a file that could match. */
+class ProjectSearchIndex : public std::enable_shared_from_this<ProjectSearchIndex> {
+  public:
+	/** Files bigger than this are not indexed, they are always searched. */
+	static constexpr Uint64 MaxIndexedFileSize = 4 * 1024 * 1024;
+
+	static std::shared_ptr<ProjectSearchIndex> New( const std::string& indexPath,
+													std::shared_ptr<ThreadPool> pool );
+
+	ProjectSearchIndex( const std::string& indexPath, std::shared_ptr<ThreadPool> pool );
+
+	/** Loads the index saved on disk and indexes the files that are new or have changed, in
+	 * background. */
+	void build( const std::vector<std::string>& files );
+
+	/** Stops any pending indexing, used before the index is discarded. */
+	void cancel();
+
+	bool isReady() const;
+
+	/** Narrows the files that can contain the text.
+	 * @return False if the index can't narrow the search ( it's not ready yet or the text is
+	 * shorter than a trigram ), in that case every file must be searched. */
+	bool filter( const std::vector<std::string>& files, const std::string& text,
+				 std::vector<std::string>& candidates ) const;
+
+	/** Re-indexes a file that was added or modified. */
+	void fileChanged( const std::string& path );
+
+	void fileRemoved( const std::string& path );
+
+	/** Saves the index to disk if it changed. */
+	bool save();
+
+  protected:
+	struct FileEntry {
+		std::string path;
+		Uint64 modificationTime{ 0 };
+		Uint64 size{ 0 };
+		/** False if the file was too big or couldn't be read. */
+		bool indexed{ false };
+		bool alive{ true };
+	};
+
+	std::string mIndexPath;
+	std::shared_ptr<ThreadPool> mPool;
+	mutable Mutex mMutex;
+	/** Indexed files, the position is the file id. Removed files are kept until the index is
+	 * compacted. */
+	std::vector<FileEntry> mEntries;
+	/** Sorted file ids of a trigram, stored as the varint encoded difference with the previous
+	 * id. */
+	struct PostingList {
+		std::vector<Uint8> data;
+		Uint32 count{ 0 };
+		Uint32 last{ 0 };
+
+		/** Appends an id, it must be greater than the last id appended. */
+		void push_back( const Uint32& id );
+
+		void decode( std::vector<Uint32>& ids ) const;
+	};
+
+	std::unordered_map<std::string, Uint32> mFileIds;
+	/** Sorted file ids of every trigram. */
+	std::unordered_map<Uint32, PostingList> mPostings;
+	/** Files changed that are pending to be indexed again, and the count of pending tasks. */
+	std::unordered_map<std::string, int> mDirty;
+	size_t mDeadCount{ 0 };
+	std::atomic<bool> mReady{ false };
+	std::atomic<bool> mCancelled{ false };
+	/** The index changed since it was loaded or saved. */
+	bool mModified{ false };
+
+	void addFile( FileEntry&& entry, const std::vector<Uint32>& trigrams );
+
+	void removeFileId( const std::string& path );
+
+	void compact();
+
+	bool load();
+
+	void indexFile( const std::string& path );
+};
+
+} // namespace ecode
+
+#endif // ECODE_PROJECTSEARCHINDEX_HPP
@@ -1076,6 +1076,9 @@ UIMenu* SettingsMenu::createViewMenu() {
 	mViewMenu->addCheckBox( i18n( "show_indentation_guides", "Show Indentation Guides" ) )
 		->setActive( mApp->getConfig().editor.showIndentationGuides )
 		->setId( "show-indentation-guides" );
+	mViewMenu->addCheckBox( i18n( "word_wrap", "Word Wrap" ) )
+		->setActive( mApp->getConfig().editor.wordWrap )
+		->setId( "word-wrap" );
 	mViewMenu->addCheckBox( i18n( "show_doc_info", "Show Document Info" ) )
 		->setActive( mApp->getConfig().editor.showDocInfo )
 		->setId( "show-doc-info" );
@@ -1152,6 +1155,11 @@ UIMenu* SettingsMenu::createViewMenu() {
 			mSplitter->forEachEditor( [&]( UICodeEditor* editor ) {
 				editor->setShowLineEndings( mApp->getConfig().editor.showLineEndings );
 			} );
+		} else if ( item->getId() == "word-wrap" ) {
+			mApp->getConfig().editor.wordWrap = item->asType<UIMenuCheckBox>()->isActive();
+			mSplitter->forEachEditor( [&]( UICodeEditor* editor ) {
+				editor->setWordWrap( mApp->getConfig().editor.wordWrap );
+			} );
 		} else if ( item->getId() == "show-indentation-guides" ) {
 			mApp->getConfig().editor.showIndentationGuides =
 				item->asType<UIMenuCheckBox>()->isActive();